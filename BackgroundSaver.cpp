@@ -0,0 +1,246 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdio>
+
+#include <QFile>
+
+#ifdef __IS_WINDOWS_BUILD
+#include <windows.h>
+#endif
+
+#include "BackgroundSaver.h"
+
+namespace QTournament
+{
+  // allocate static variables
+  constexpr int BackgroundSaver::PAGES_PER_STEP;
+  constexpr int BackgroundSaver::MAX_RESTARTS;
+
+  BackgroundSaver::BackgroundSaver(TournamentDB* _db)
+    :QObject(), db(_db), dstPtr(nullptr), bck(nullptr), srcVersion(0), restartCount(0),
+      lastDbErr(SQLITE_OK), lastResult(false)
+  {
+    // a zero interval timer fires whenever
+    // the event loop has nothing else to do
+    stepTimer.setInterval(0);
+    connect(&stepTimer, SIGNAL(timeout()), this, SLOT(onStep()));
+  }
+
+  //----------------------------------------------------------------------------
+
+  BackgroundSaver::~BackgroundSaver()
+  {
+    cancel();
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR BackgroundSaver::start(const QString& _dstFileName, int* dbErr)
+  {
+    if (isRunning()) return WRONG_STATE;
+
+    dstFileName = _dstFileName;
+    tmpFileName = dstFileName + ".tmp";
+    restartCount = 0;
+    lastDbErr = SQLITE_OK;
+
+    if (!(openBackup()))
+    {
+      closeBackup(true);
+      if (dbErr != nullptr) *dbErr = lastDbErr;
+      return DATABASE_ERROR;
+    }
+
+    stepTimer.start();
+    emit progressChanged(0);
+
+    if (dbErr != nullptr) *dbErr = SQLITE_OK;
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void BackgroundSaver::cancel()
+  {
+    stepTimer.stop();
+    closeBackup(true);
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool BackgroundSaver::waitForFinished()
+  {
+    while (isRunning())
+    {
+      onStep();
+    }
+
+    return lastResult;
+  }
+
+  //----------------------------------------------------------------------------
+
+  int BackgroundSaver::getProgress() const
+  {
+    if (bck == nullptr) return 0;
+
+    // the page count is only available after the first step
+    int total = sqlite3_backup_pagecount(bck);
+    if (total <= 0) return 0;
+
+    int remaining = sqlite3_backup_remaining(bck);
+    return ((total - remaining) * 100) / total;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void BackgroundSaver::onStep()
+  {
+    if (bck == nullptr)
+    {
+      stepTimer.stop();
+      return;
+    }
+
+    // restart if the source has been modified since the start;
+    // if it keeps changing, we copy the rest in one go
+    int nPages = PAGES_PER_STEP;
+    if (db->getDatabaseVersion() != srcVersion)
+    {
+      if (restartCount < MAX_RESTARTS)
+      {
+        ++restartCount;
+        closeBackup(true);
+        if (!(openBackup()))
+        {
+          finish(false);
+          return;
+        }
+      } else {
+        nPages = -1;
+      }
+    }
+
+    int err = sqlite3_backup_step(bck, nPages);
+    if (err == SQLITE_DONE)
+    {
+      finish(true);
+      return;
+    }
+    if ((err != SQLITE_OK) && (err != SQLITE_BUSY) && (err != SQLITE_LOCKED))
+    {
+      lastDbErr = err;
+      finish(false);
+      return;
+    }
+
+    emit progressChanged(getProgress());
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool BackgroundSaver::openBackup()
+  {
+    QFile::remove(tmpFileName);
+
+    int err = sqlite3_open_v2(tmpFileName.toUtf8().constData(), &dstPtr, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+    if (err != SQLITE_OK)
+    {
+      lastDbErr = err;
+      return false;
+    }
+
+    bck = sqlite3_backup_init(dstPtr, "main", db->dbPtr, "main");
+    if (bck == nullptr)
+    {
+      lastDbErr = sqlite3_errcode(dstPtr);
+      return false;
+    }
+
+    srcVersion = db->getDatabaseVersion();
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void BackgroundSaver::closeBackup(bool removeTmpFile)
+  {
+    if (bck != nullptr)
+    {
+      sqlite3_backup_finish(bck);
+      bck = nullptr;
+    }
+
+    // sqlite3_open_v2() returns a handle even on errors
+    if (dstPtr != nullptr)
+    {
+      sqlite3_close(dstPtr);
+      dstPtr = nullptr;
+    }
+
+    if (removeTmpFile) QFile::remove(tmpFileName);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void BackgroundSaver::finish(bool isOkay)
+  {
+    stepTimer.stop();
+
+    if (bck != nullptr)
+    {
+      int err = sqlite3_backup_finish(bck);
+      bck = nullptr;
+      if (isOkay && (err != SQLITE_OK))
+      {
+        isOkay = false;
+        lastDbErr = err;
+      }
+    }
+    closeBackup(false);
+
+    // only a complete copy replaces the target file
+    if (isOkay && !(replaceFile(tmpFileName, dstFileName)))
+    {
+      isOkay = false;
+      lastDbErr = SQLITE_IOERR;
+    }
+    if (!isOkay) QFile::remove(tmpFileName);
+
+    lastResult = isOkay;
+    emit finished(isOkay, lastDbErr);
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool BackgroundSaver::replaceFile(const QString& srcFileName, const QString& dstFileName)
+  {
+    // QFile::rename() doesn't overwrite existing files, so
+    // we use the atomic rename of the operating system
+#ifdef __IS_WINDOWS_BUILD
+    return MoveFileExW(reinterpret_cast<LPCWSTR>(srcFileName.utf16()), reinterpret_cast<LPCWSTR>(dstFileName.utf16()),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+    return (std::rename(QFile::encodeName(srcFileName).constData(), QFile::encodeName(dstFileName).constData()) == 0);
+#endif
+  }
+
+  //----------------------------------------------------------------------------
+
+}
@@ -0,0 +1,92 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BACKGROUNDSAVER_H
+#define BACKGROUNDSAVER_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <sqlite3.h>
+
+#include "TournamentDB.h"
+#include "TournamentErrorCodes.h"
+
+namespace QTournament
+{
+  /*
+   * Writes a copy of the (in-memory) tournament database to a file
+   * without blocking the event loop.
+   *
+   * The in-memory database can only be accessed through the connection
+   * of the GUI thread, so the copy is done with sqlite3_backup_step() in
+   * small page batches whenever the event loop is idle. If the source is
+   * modified while the copy is running, the copy is restarted (at most
+   * MAX_RESTARTS times; afterwards the remaining pages are copied at once).
+   *
+   * The data is written to a temporary file that replaces the target
+   * file only after the copy has been completed successfully.
+   */
+  class BackgroundSaver : public QObject
+  {
+    Q_OBJECT
+
+  public:
+    static constexpr int PAGES_PER_STEP = 64;
+    static constexpr int MAX_RESTARTS = 3;
+
+    BackgroundSaver(TournamentDB* _db);
+    virtual ~BackgroundSaver();
+
+    ERR start(const QString& _dstFileName, int* dbErr = nullptr);
+    void cancel();
+    bool waitForFinished();   // completes a running save in the calling thread
+
+    bool isRunning() const { return (bck != nullptr); }
+    QString getDstFileName() const { return dstFileName; }
+    int getProgress() const;   // in percent
+
+  signals:
+    void progressChanged(int percent);
+    void finished(bool isOkay, int dbErr);
+
+  private slots:
+    void onStep();
+
+  private:
+    TournamentDB* db;
+    QString dstFileName;
+    QString tmpFileName;
+    sqlite3* dstPtr;
+    sqlite3_backup* bck;
+    unsigned long srcVersion;
+    int restartCount;
+    int lastDbErr;
+    bool lastResult;
+    QTimer stepTimer;
+
+    bool openBackup();
+    void closeBackup(bool removeTmpFile);
+    void finish(bool isOkay);
+    static bool replaceFile(const QString& srcFileName, const QString& dstFileName);
+  };
+
+}
+
+#endif // BACKGROUNDSAVER_H
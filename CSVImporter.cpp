@@ -1,6 +1,9 @@
+#include <unordered_map>
+
 #include <QString>
 
 #include <Sloppy/libSloppy.h>
+#include <SqliteOverlay/TabRow.h>
 
 #include "CSVImporter.h"
 #include "TournamentDB.h"
@@ -93,10 +96,15 @@ namespace QTournament
 
   vector<CSVImportRecord> convertCSVfromPlainText(TournamentDB* db, const vector<vector<string> >& splitData)
   {
+    // read all existing players and categories only once
+    // instead of querying them for each record
+    CSVImportContext ctx{db};
+
     vector<CSVImportRecord> result;
+    result.reserve(splitData.size());
     for (const vector<string>& s : splitData)
     {
-      result.push_back(CSVImportRecord{db, s});
+      result.push_back(CSVImportRecord{ctx, s});
     }
 
     return result;
@@ -105,102 +113,230 @@ namespace QTournament
   //----------------------------------------------------------------------------
 
   vector<CSVError> analyseCSV(TournamentDB* db, const vector<CSVImportRecord>& data)
+  {
+    CSVImportContext ctx{db};
+    return analyseCSV(ctx, data);
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<CSVError> analyseCSV(const CSVImportContext& ctx, const vector<CSVImportRecord>& data)
   {
     vector<CSVError> result;
 
-    PlayerMngr pm{db};
-    CatMngr cm{db};
+    // the rows of all names that we've seen so far
+    QHash<QString, vector<int>> name2Rows;
+    const vector<int> noRows;
 
     int row = 0;
     for (const CSVImportRecord& rec : data)
     {
-      // check for the required number of fields
-      if (!(rec.hasTeamName()))
-      {
-        CSVError err{row, CSVFieldsIndex::Team, CSVErrCode::NoTeamName, "", true};
-        result.push_back(err);
-      }
-      if (!(rec.hasValidSex()))
+      vector<int>* earlierRows = nullptr;
+      if (rec.hasLastName() && rec.hasFirstName())
       {
-        CSVError err{row, CSVFieldsIndex::Sex, CSVErrCode::NoSex, "", true};
-        result.push_back(err);
+        earlierRows = &(name2Rows[CSVImportContext::getNameKey(rec.getFirstName(), rec.getLastName())]);
       }
-      if (!(rec.hasFirstName()))
+
+      vector<CSVError> recErrors = analyseCSVRecord(ctx, rec, row, (earlierRows == nullptr) ? noRows : *earlierRows);
+      result.insert(result.end(), recErrors.begin(), recErrors.end());
+
+      if (earlierRows != nullptr) earlierRows->push_back(row);
+
+      // next line
+      ++row;
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<CSVError> analyseCSVRecord(const CSVImportContext& ctx, const CSVImportRecord& rec, int row, const vector<int>& earlierRowsWithSameName)
+  {
+    vector<CSVError> result;
+
+    // check for the required number of fields
+    if (!(rec.hasTeamName()))
+    {
+      CSVError err{row, CSVFieldsIndex::Team, CSVErrCode::NoTeamName, "", true};
+      result.push_back(err);
+    }
+    if (!(rec.hasValidSex()))
+    {
+      CSVError err{row, CSVFieldsIndex::Sex, CSVErrCode::NoSex, "", true};
+      result.push_back(err);
+    }
+    if (!(rec.hasFirstName()))
+    {
+      CSVError err{row, CSVFieldsIndex::FirstName, CSVErrCode::NoFirstName, "", true};
+      result.push_back(err);
+    }
+    if (!(rec.hasLastName()))
+    {
+      CSVError err{row, CSVFieldsIndex::LastName, CSVErrCode::NoLastName, "", true};
+      result.push_back(err);
+    }
+
+    // check if the name is globally unique
+    // (--> not yet in the database)
+    if (rec.hasFirstName() && rec.hasLastName() && (ctx.findPlayer(rec.getFirstName(), rec.getLastName()) != nullptr))
+    {
+      CSVError err{row, CSVFieldsIndex::FirstName, CSVErrCode::NameNotUnique, "", false};
+      result.push_back(err);
+      err = CSVError{row, CSVFieldsIndex::LastName, CSVErrCode::NameNotUnique, "", false};
+      result.push_back(err);
+    }
+
+    // check if the name is locally unique
+    // (--> not yet in this list of records)
+    for (int earlierRow : earlierRowsWithSameName)
+    {
+      // generate an error and add 1 to the row number
+      // so that it matches the row numbers in the tab widget
+      CSVError err{row, CSVFieldsIndex::FirstName, CSVErrCode::NameRedundant, QString::number(earlierRow + 1), true};
+      result.push_back(err);
+      err = CSVError{row, CSVFieldsIndex::LastName, CSVErrCode::NameRedundant, QString::number(earlierRow + 1), true};
+      result.push_back(err);
+    }
+
+    // check for valid categories
+    for (const QString& cName : rec.getCatNames())
+    {
+      // does the category exist?
+      const CSVImportContext::CategoryInfo* ci = ctx.findCategory(cName);
+      if (ci == nullptr)
       {
-        CSVError err{row, CSVFieldsIndex::FirstName, CSVErrCode::NoFirstName, "", true};
+        CSVError err{row, CSVFieldsIndex::Categories, CSVErrCode::CategoryNotExisting, cName, false};
         result.push_back(err);
+
+        continue;
       }
-      if (!(rec.hasLastName()))
+
+      // can players be added to the category?
+      if (ci->canAddPlayers)
       {
-        CSVError err{row, CSVFieldsIndex::LastName, CSVErrCode::NoLastName, "", true};
+        CAT_ADD_STATE as = ci->addState[rec.getSex()];
+        if (as != CAN_JOIN)
+        {
+          CSVError err{row, CSVFieldsIndex::Categories, CSVErrCode::CategoryNotSuitable, cName, false};
+          result.push_back(err);
+        }
+      } else {
+        CSVError err{row, CSVFieldsIndex::Categories, CSVErrCode::CategoryLocked, cName, false};
         result.push_back(err);
       }
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+  //----------------------------------------------------------------------------
+  //----------------------------------------------------------------------------
+
+  CSVImportContext::CSVImportContext(TournamentDB* _db)
+    :db{_db}
+  {
+    // pass 1: all team names
+    unordered_map<int, QString> teamId2Name;
+    auto it = db->getTab(TAB_TEAM)->getRowsByWhereClause("id > 0");
+    while (!(it.isEnd()))
+    {
+      SqliteOverlay::TabRow r = *it;
+      teamId2Name[r.getId()] = QString::fromUtf8(r[GENERIC_NAME_FIELD_NAME].data());
+
+      ++it;
+    }
+
+    // pass 2: all players
+    unordered_map<int, QString> playerId2NameKey;
+    it = db->getTab(TAB_PLAYER)->getRowsByWhereClause("id > 0");
+    while (!(it.isEnd()))
+    {
+      SqliteOverlay::TabRow r = *it;
 
-      // check if the name is globally unique
-      // (--> not yet in the database)
-      if (rec.hasExistingName())
+      PlayerInfo pi;
+      pi.id = r.getId();
+      pi.sex = static_cast<SEX>(r.getInt(PL_SEX));
+      auto teamRef = r.getInt2(PL_TEAM_REF);
+      if (!(teamRef->isNull()))
       {
-        CSVError err{row, CSVFieldsIndex::FirstName, CSVErrCode::NameNotUnique, "", false};
-        result.push_back(err);
-        err = CSVError{row, CSVFieldsIndex::LastName, CSVErrCode::NameNotUnique, "", false};
-        result.push_back(err);
+        auto t = teamId2Name.find(teamRef->get());
+        if (t != teamId2Name.end()) pi.teamName = t->second;
       }
 
-      // check if the name is locally unique
-      // (--> not yet in this list of records)
-      if (rec.hasLastName() && rec.hasFirstName())
+      QString key = getNameKey(QString::fromUtf8(r[PL_FNAME].data()), QString::fromUtf8(r[PL_LNAME].data()));
+      playerId2NameKey[pi.id] = key;
+      name2Player.insert(key, pi);
+
+      ++it;
+    }
+
+    // pass 3: all player-to-category assignments
+    unordered_map<int, vector<int>> catId2PlayerIds;
+    it = db->getTab(TAB_P2C)->getRowsByWhereClause("id > 0");
+    while (!(it.isEnd()))
+    {
+      SqliteOverlay::TabRow r = *it;
+      catId2PlayerIds[r.getInt(P2C_CAT_REF)].push_back(r.getInt(P2C_PLAYER_REF));
+
+      ++it;
+    }
+
+    // pass 4: all categories, in the same order
+    // as used by the category manager
+    CatMngr cm{db};
+    for (const Category& cat : cm.getAllCategories())
+    {
+      CategoryInfo ci;
+      ci.id = cat.getId();
+      ci.canAddPlayers = cat.canAddPlayers();
+      for (SEX s : {M, F, DONT_CARE})
       {
-        for (int earlierRow = 0; earlierRow < row; ++earlierRow)
-        {
-          const CSVImportRecord& other = data[earlierRow];
-          if ((rec.getLastName() == other.getLastName()) && (rec.getFirstName() == other.getFirstName()))
-          {
-            // generate an error and add 1 to the row number
-            // so that it matches the row numbers in the tab widget
-            CSVError err{row, CSVFieldsIndex::FirstName, CSVErrCode::NameRedundant, QString::number(earlierRow + 1), true};
-            result.push_back(err);
-            err = CSVError{row, CSVFieldsIndex::LastName, CSVErrCode::NameRedundant, QString::number(earlierRow + 1), true};
-            result.push_back(err);
-          }
-        }
+        ci.addState[s] = cat.getAddState(s);
       }
 
-      // check for valid categories
-      if (!(rec.getCatNames().empty()))
+      QString catName = cat.getName();
+      name2Category.insert(catName, ci);
+
+      // skip categories that are already locked
+      if (!(ci.canAddPlayers)) continue;
+
+      auto p = catId2PlayerIds.find(ci.id);
+      if (p == catId2PlayerIds.end()) continue;
+      for (int plId : p->second)
       {
-        for (const QString& cName : rec.getCatNames())
-        {
-          // does the category exist?
-          if (!(cm.hasCategory(cName)))
-          {
-            CSVError err{row, CSVFieldsIndex::Categories, CSVErrCode::CategoryNotExisting, cName, false};
-            result.push_back(err);
-
-            continue;
-          }
-
-          // can players be added to the category?
-          Category cat = cm.getCategory(cName);
-          if (cat.canAddPlayers())
-          {
-            CAT_ADD_STATE as = cat.getAddState(rec.getSex());
-            if (as != CAN_JOIN)
-            {
-              CSVError err{row, CSVFieldsIndex::Categories, CSVErrCode::CategoryNotSuitable, cName, false};
-              result.push_back(err);
-            }
-          } else {
-            CSVError err{row, CSVFieldsIndex::Categories, CSVErrCode::CategoryLocked, cName, false};
-            result.push_back(err);
-          }
-        }
-      }
+        auto k = playerId2NameKey.find(plId);
+        if (k == playerId2NameKey.end()) continue;
 
-      // next line
-      ++row;
+        auto pi = name2Player.find(k->second);
+        if (pi != name2Player.end()) pi.value().openCatNames.push_back(catName);
+      }
     }
+  }
 
-    return result;
+  //----------------------------------------------------------------------------
+
+  const CSVImportContext::PlayerInfo* CSVImportContext::findPlayer(const QString& firstName, const QString& lastName) const
+  {
+    auto it = name2Player.constFind(getNameKey(firstName, lastName));
+    return (it == name2Player.constEnd()) ? nullptr : &(it.value());
+  }
+
+  //----------------------------------------------------------------------------
+
+  const CSVImportContext::CategoryInfo* CSVImportContext::findCategory(const QString& catName) const
+  {
+    auto it = name2Category.constFind(catName);
+    return (it == name2Category.constEnd()) ? nullptr : &(it.value());
+  }
+
+  //----------------------------------------------------------------------------
+
+  QString CSVImportContext::getNameKey(const QString& firstName, const QString& lastName)
+  {
+    // the ASCII unit separator doesn't show up in names
+    return lastName + QChar(0x1F) + firstName;
   }
 
   //----------------------------------------------------------------------------
@@ -209,6 +345,40 @@ namespace QTournament
 
   CSVImportRecord::CSVImportRecord(TournamentDB* _db, vector<string> rawTexts)
     :db{_db}
+  {
+    initFromRawTexts(rawTexts);
+
+    // if our name matches the name of an existing player,
+    // we enforce the correct sex, no matter what the user originally
+    // provided as input data
+    enforceConsistentSex();
+
+    // if some elements are missing and we're representing
+    // an existing player, fill in the correct values from the
+    // database
+    insertMissingDataForExistingPlayers();
+  }
+
+  //----------------------------------------------------------------------------
+
+  CSVImportRecord::CSVImportRecord(const CSVImportContext& ctx, vector<string> rawTexts)
+    :db{ctx.getDatabase()}
+  {
+    initFromRawTexts(rawTexts);
+
+    // same as above, but based on the preloaded data
+    // instead of database queries
+    if (!(hasFirstName()) || !(hasLastName())) return;
+    const CSVImportContext::PlayerInfo* pi = ctx.findPlayer(fName, lName);
+    if (pi == nullptr) return;
+
+    sex = pi->sex;
+    mergeExistingPlayerData(pi->teamName, pi->openCatNames);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CSVImportRecord::initFromRawTexts(const vector<string>& rawTexts)
   {
     // copy the lastname
     if (rawTexts.size() > 0)
@@ -246,16 +416,6 @@ namespace QTournament
         catNames.push_back(QString::fromUtf8(s.c_str()));
       }
     }
-
-    // if our name matches the name of an existing player,
-    // we enforce the correct sex, no matter what the user originally
-    // provided as input data
-    enforceConsistentSex();
-
-    // if some elements are missing and we're representing
-    // an existing player, fill in the correct values from the
-    // database
-    insertMissingDataForExistingPlayers();
   }
 
   //----------------------------------------------------------------------------
@@ -277,11 +437,6 @@ namespace QTournament
 
     Player p = *(getExistingPlayer());
 
-    if (teamName.isEmpty())
-    {
-      teamName = p.getTeam().getName();
-    }
-
     // merge already assigned and potentially new categories
     CatMngr cm{db};
     vector<QString> alreadyAssignedCats;
@@ -295,11 +450,24 @@ namespace QTournament
         alreadyAssignedCats.push_back(cat.getName());
       }
     }
+
+    mergeExistingPlayerData(teamName.isEmpty() ? p.getTeam().getName() : teamName, alreadyAssignedCats);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CSVImportRecord::mergeExistingPlayerData(const QString& existingTeamName, const vector<QString>& openCatNames)
+  {
+    if (teamName.isEmpty())
+    {
+      teamName = existingTeamName;
+    }
+
     if (catNames.empty())
     {
-      catNames = alreadyAssignedCats;
+      catNames = openCatNames;
     } else {
-      for (const QString& cn : alreadyAssignedCats)
+      for (const QString& cn : openCatNames)
       {
         if (Sloppy::isInVector<QString>(catNames, cn)) continue;
         catNames.push_back(cn);
@@ -399,4 +567,142 @@ namespace QTournament
     catNames = catOverwrite;
     return true;
   }
+
+  //----------------------------------------------------------------------------
+  //----------------------------------------------------------------------------
+  //----------------------------------------------------------------------------
+
+  CSVValidator::CSVValidator(TournamentDB* _db)
+    :ctx{_db}, cntFatal{0}, cntWarn{0}
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CSVValidator::reset(const vector<CSVImportRecord>& data)
+  {
+    rowErrors.clear();
+    rowKeys.clear();
+    name2Rows.clear();
+    cntFatal = 0;
+    cntWarn = 0;
+
+    // build the name index first, so that
+    // each row can look up its predecessors
+    rowKeys.reserve(data.size());
+    for (int row = 0; row < static_cast<int>(data.size()); ++row)
+    {
+      QString key = getNameKey(data[row]);
+      if (!(key.isEmpty())) name2Rows[key].insert(row);
+      rowKeys.push_back(key);
+    }
+
+    rowErrors.resize(data.size());
+    for (int row = 0; row < static_cast<int>(data.size()); ++row)
+    {
+      recheckRow(data, row);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<int> CSVValidator::updateRow(const vector<CSVImportRecord>& data, int row)
+  {
+    if ((row < 0) || (row >= static_cast<int>(rowErrors.size()))) return vector<int>{};
+
+    set<int> affectedRows{row};
+
+    // if the name has changed, the later rows with the old
+    // and with the new name have to be re-checked, too,
+    // because their "redundant name" errors refer to this row
+    QString newKey = getNameKey(data[row]);
+    QString oldKey = rowKeys[row];
+    if (newKey != oldKey)
+    {
+      if (!(oldKey.isEmpty()))
+      {
+        set<int>& rows = name2Rows[oldKey];
+        rows.erase(row);
+        affectedRows.insert(rows.upper_bound(row), rows.end());
+        if (rows.empty()) name2Rows.remove(oldKey);
+      }
+
+      if (!(newKey.isEmpty()))
+      {
+        set<int>& rows = name2Rows[newKey];
+        rows.insert(row);
+        affectedRows.insert(rows.upper_bound(row), rows.end());
+      }
+
+      rowKeys[row] = newKey;
+    }
+
+    for (int r : affectedRows)
+    {
+      recheckRow(data, r);
+    }
+
+    return vector<int>{affectedRows.begin(), affectedRows.end()};
+  }
+
+  //----------------------------------------------------------------------------
+
+  const vector<CSVError>& CSVValidator::getErrorsForRow(int row) const
+  {
+    static const vector<CSVError> noErrors;
+    if ((row < 0) || (row >= static_cast<int>(rowErrors.size()))) return noErrors;
+
+    return rowErrors[row];
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<CSVError> CSVValidator::getAllErrors() const
+  {
+    vector<CSVError> result;
+    for (const vector<CSVError>& errors : rowErrors)
+    {
+      result.insert(result.end(), errors.begin(), errors.end());
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  QString CSVValidator::getNameKey(const CSVImportRecord& rec)
+  {
+    // incomplete names can't be redundant
+    if (!(rec.hasFirstName()) || !(rec.hasLastName())) return QString{};
+
+    return CSVImportContext::getNameKey(rec.getFirstName(), rec.getLastName());
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CSVValidator::recheckRow(const vector<CSVImportRecord>& data, int row)
+  {
+    // all earlier rows with the same name
+    vector<int> earlierRows;
+    const QString& key = rowKeys[row];
+    if (!(key.isEmpty()))
+    {
+      const set<int>& rows = name2Rows[key];
+      earlierRows.assign(rows.begin(), rows.lower_bound(row));
+    }
+
+    // replace the old errors and their contribution to the counters
+    vector<CSVError>& errors = rowErrors[row];
+    for (const CSVError& err : errors)
+    {
+      if (err.isFatal) --cntFatal;
+      else --cntWarn;
+    }
+    errors = analyseCSVRecord(ctx, data[row], row, earlierRows);
+    for (const CSVError& err : errors)
+    {
+      if (err.isFatal) ++cntFatal;
+      else ++cntWarn;
+    }
+  }
 }
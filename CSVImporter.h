@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <set>
+
+#include <QHash>
 
 #include "TournamentDataDefs.h"
 #include "Player.h"
@@ -47,10 +50,56 @@ namespace QTournament
 
   SEX strToSex(const string& s);
 
+  /*
+   * A snapshot of all players and categories that is relevant
+   * for converting and analysing CSV records.
+   *
+   * The snapshot is built with one pass over the team, player,
+   * player-to-category and category tables. Afterwards, all lookups
+   * are hash lookups without any database access.
+   *
+   * The snapshot is not updated automatically; create a new
+   * context after players or categories have been modified.
+   */
+  class CSVImportContext
+  {
+  public:
+    struct PlayerInfo
+    {
+      int id;
+      SEX sex;
+      QString teamName;
+      vector<QString> openCatNames;   // assigned categories that still accept players
+    };
+
+    struct CategoryInfo
+    {
+      int id;
+      bool canAddPlayers;
+      CAT_ADD_STATE addState[3];   // indexed by SEX (M, F, DONT_CARE)
+    };
+
+    // ctor
+    CSVImportContext(TournamentDB* _db);
+
+    // getters
+    TournamentDB* getDatabase() const { return db; }
+    const PlayerInfo* findPlayer(const QString& firstName, const QString& lastName) const;
+    const CategoryInfo* findCategory(const QString& catName) const;
+
+    static QString getNameKey(const QString& firstName, const QString& lastName);
+
+  private:
+    TournamentDB* db;
+    QHash<QString, PlayerInfo> name2Player;
+    QHash<QString, CategoryInfo> name2Category;
+  };
+
   class CSVImportRecord
   {
   public:
     CSVImportRecord(TournamentDB* _db, vector<string> rawTexts);
+    CSVImportRecord(const CSVImportContext& ctx, vector<string> rawTexts);
     void enforceConsistentSex();
     void insertMissingDataForExistingPlayers();
 
@@ -85,11 +134,59 @@ namespace QTournament
     SEX sex;
     QString teamName;
     vector<QString> catNames;
+
+    void initFromRawTexts(const vector<string>& rawTexts);
+    void mergeExistingPlayerData(const QString& existingTeamName, const vector<QString>& openCatNames);
   };
 
   vector<vector<string>> splitCSV(const string& rawText, const string& delim = ",", const string& optionalCatName="");
   vector<CSVImportRecord> convertCSVfromPlainText(TournamentDB* db, const vector<vector<string>>& splitData);
   vector<CSVError> analyseCSV(TournamentDB* db, const vector<CSVImportRecord>& data);
+  vector<CSVError> analyseCSV(const CSVImportContext& ctx, const vector<CSVImportRecord>& data);
+  vector<CSVError> analyseCSVRecord(const CSVImportContext& ctx, const CSVImportRecord& rec, int row, const vector<int>& earlierRowsWithSameName);
+
+  /*
+   * Keeps the errors of each row of a list of CSV records together
+   * with an index of the rows per player name.
+   *
+   * After a single record has been modified, updateRow() only re-checks
+   * this record and those later records that share its old or its new
+   * name (--> "redundant name" errors). The result is identical to
+   * a full analyseCSV() run.
+   *
+   * Inserting or deleting records shifts all row numbers and
+   * requires a new call to reset().
+   */
+  class CSVValidator
+  {
+  public:
+    // ctor
+    CSVValidator(TournamentDB* _db);
+
+    // full analysis
+    void reset(const vector<CSVImportRecord>& data);
+
+    // incremental analysis; returns all rows with potentially modified errors
+    vector<int> updateRow(const vector<CSVImportRecord>& data, int row);
+
+    // getters
+    const vector<CSVError>& getErrorsForRow(int row) const;
+    vector<CSVError> getAllErrors() const;
+    int getFatalCount() const { return cntFatal; }
+    int getWarningCount() const { return cntWarn; }
+    const CSVImportContext& getContext() const { return ctx; }
+
+  private:
+    CSVImportContext ctx;
+    vector<vector<CSVError>> rowErrors;
+    vector<QString> rowKeys;   // empty for incomplete names
+    QHash<QString, set<int>> name2Rows;
+    int cntFatal;
+    int cntWarn;
+
+    static QString getNameKey(const CSVImportRecord& rec);
+    void recheckRow(const vector<CSVImportRecord>& data, int row);
+  };
 
 }
 
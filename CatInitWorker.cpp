@@ -0,0 +1,229 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CatInitWorker.h"
+#include "CatMngr.h"
+#include "CentralSignalEmitter.h"
+
+namespace QTournament
+{
+  // allocate static variables
+  atomic<int> CatInitWorker::runningWorkerCount{0};
+
+  CatInitWorker::CatInitWorker(TournamentDB* _db, const Category& _cat, const vector<PlayerPairList>& _grpCfg, const PlayerPairList& _seed)
+    :db(_db), mode(Mode::StartCategory), catId(_cat.getId()), grpCfg(_grpCfg), seed(_seed),
+      workDb(nullptr), finished(false), holdsWriteLock(false), result(OK)
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  CatInitWorker::CatInitWorker(TournamentDB* _db, const Category& _cat, const PlayerPairList& _seed)
+    :db(_db), mode(Mode::IntermediateSeeding), catId(_cat.getId()), seed(_seed),
+      workDb(nullptr), finished(false), holdsWriteLock(false), result(OK)
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  CatInitWorker::~CatInitWorker()
+  {
+    // abort a running thread and discard its results
+    progressQueue.requestCancellation();
+    joinAndUnblock();
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR CatInitWorker::start()
+  {
+    if (workDb != nullptr) return WRONG_STATE;  // already started
+
+    // don't start if the tournament database contains
+    // uncommitted modifications because they would not
+    // be visible in the copy
+    if (db->isTransactionRunning()) return DATABASE_ERROR;
+
+    int dbErr;
+    workDb = db->createInMemoryCopy(ConnectionRole::PrivateCopy, &dbErr);
+    if (workDb == nullptr) return DATABASE_ERROR;
+
+    // from now on, all modifications of the tournament database
+    // would be lost when applyResult() replaces its content. The
+    // signals of the worker don't need any special treatment
+    // because the emitter mutes all signals of foreign threads.
+    if (!(db->setWriteLocked(true, &dbErr)))
+    {
+      workDb.reset();
+      return DATABASE_ERROR;
+    }
+    holdsWriteLock = true;
+    ++runningWorkerCount;
+
+    workerThread = thread{&CatInitWorker::run, this};
+
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool CatInitWorker::isFinished() const
+  {
+    return finished;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CatInitWorker::requestCancellation()
+  {
+    progressQueue.requestCancellation();
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR CatInitWorker::applyResult(QString* errMsg)
+  {
+    if ((workDb == nullptr) || !finished) return WRONG_STATE;
+
+    joinAndUnblock();
+
+    if (result != OK)
+    {
+      if (errMsg != nullptr) *errMsg = QString::fromUtf8(exceptionMsg.c_str());
+      return result;
+    }
+
+    // replace the content of the tournament database
+    // with the modified copy
+    CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
+    cse->beginResetAllModels();
+    int dbErr;
+    bool isOkay = workDb->copyContentTo(db, &dbErr);
+    cse->endResetAllModels();
+    workDb.reset();
+
+    if (!isOkay)
+    {
+      if (errMsg != nullptr) *errMsg = QString("SQLite error code %1").arg(dbErr);
+      return DATABASE_ERROR;
+    }
+
+    // replay the relevant state change for all
+    // widgets that are not covered by the model reset
+    CatMngr cm{db};
+    Category cat = cm.getCategoryById(catId);
+    OBJ_STATE newState = cat.getState();
+    OBJ_STATE oldState = (mode == Mode::StartCategory) ? STAT_CAT_FROZEN : STAT_CAT_WAIT_FOR_INTERMEDIATE_SEEDING;
+    cse->categoryStatusChanged(cat, oldState, newState);
+
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool CatInitWorker::isAnyWorkerRunning()
+  {
+    return (runningWorkerCount > 0);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CatInitWorker::run()
+  {
+    try
+    {
+      // everything happens in one transaction; the guard
+      // rolls back upon destruction if we don't commit explicitly
+      bool isDbErr;
+      auto tg = workDb->acquireTransactionGuard(false, &isDbErr);
+      if (isDbErr)
+      {
+        result = DATABASE_ERROR;
+      } else {
+        CatMngr cm{workDb.get()};
+        Category cat = cm.getCategoryById(catId);
+
+        if (mode == Mode::StartCategory)
+        {
+          vector<PlayerPairList> wrkGrpCfg;
+          for (const PlayerPairList& ppList : grpCfg) wrkGrpCfg.push_back(rebindToWorkDb(ppList));
+          result = cm.startCategory(cat, wrkGrpCfg, rebindToWorkDb(seed), &progressQueue);
+        } else {
+          result = cm.continueWithIntermediateSeeding(cat, rebindToWorkDb(seed), &progressQueue);
+        }
+
+        // a cancellation request that arrives after the last
+        // progress step is honored as well
+        if ((result == OK) && progressQueue.isCancellationRequested())
+        {
+          result = OPERATION_CANCELLED;
+        }
+
+        if (result == OK)
+        {
+          int dbErr;
+          if (!(tg->commit(&dbErr))) result = DATABASE_ERROR;
+        }
+      }
+    }
+    catch (OperationCancelled&)
+    {
+      result = OPERATION_CANCELLED;
+    }
+    catch (std::exception& ex)
+    {
+      exceptionMsg = ex.what();
+      result = DATABASE_ERROR;
+    }
+
+    // make sure the consumer of the queue doesn't wait forever
+    progressQueue.push(-1);
+
+    finished = true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CatInitWorker::joinAndUnblock()
+  {
+    if (workerThread.joinable()) workerThread.join();
+
+    if (holdsWriteLock)
+    {
+      db->setWriteLocked(false);
+      holdsWriteLock = false;
+      --runningWorkerCount;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  PlayerPairList CatInitWorker::rebindToWorkDb(const PlayerPairList& ppList) const
+  {
+    PlayerPairList wrkList;
+    for (const PlayerPair& pp : ppList)
+    {
+      wrkList.push_back(PlayerPair{workDb.get(), pp.getPairId()});
+    }
+
+    return wrkList;
+  }
+
+  //----------------------------------------------------------------------------
+
+}
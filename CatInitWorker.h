@@ -0,0 +1,110 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CATINITWORKER_H
+#define CATINITWORKER_H
+
+#include <memory>
+#include <thread>
+#include <atomic>
+
+#include <QString>
+
+#include "TournamentDB.h"
+#include "TournamentErrorCodes.h"
+#include "Category.h"
+#include "PlayerPair.h"
+#include "ThreadSafeQueue.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  /*
+   * Starts a category or continues a category after intermediate
+   * seeding in a background thread.
+   *
+   * In start(), the worker creates a private in-memory copy of the
+   * tournament database. The background thread calls the CatMngr
+   * on that copy inside a single transaction. If the operation is
+   * cancelled or fails, the transaction is rolled back and the
+   * tournament database remains untouched.
+   *
+   * After a successful run, applyResult() copies the modified database
+   * back into the tournament database and resets all models.
+   *
+   * While a worker is running, the tournament database is write
+   * locked (see TournamentDB::setWriteLocked()) because all
+   * modifications would be lost in applyResult(). The worker's
+   * signals don't reach the GUI because the CentralSignalEmitter
+   * mutes all signals from other threads.
+   */
+  class CatInitWorker
+  {
+  public:
+    enum class Mode
+    {
+      StartCategory,
+      IntermediateSeeding,
+    };
+
+    // ctor for CatMngr::startCategory()
+    CatInitWorker(TournamentDB* _db, const Category& _cat, const vector<PlayerPairList>& _grpCfg, const PlayerPairList& _seed);
+
+    // ctor for CatMngr::continueWithIntermediateSeeding()
+    CatInitWorker(TournamentDB* _db, const Category& _cat, const PlayerPairList& _seed);
+
+    ~CatInitWorker();
+
+    // to be called from the GUI thread
+    ERR start();
+    bool isFinished() const;
+    ProgressQueue* getProgressQueue() { return &progressQueue; }
+    void requestCancellation();
+    ERR applyResult(QString* errMsg = nullptr);
+
+    Mode getMode() const { return mode; }
+    int getCategoryId() const { return catId; }
+
+    static bool isAnyWorkerRunning();
+
+  private:
+    TournamentDB* db;
+    Mode mode;
+    int catId;
+    vector<PlayerPairList> grpCfg;
+    PlayerPairList seed;
+
+    unique_ptr<TournamentDB> workDb;
+    ProgressQueue progressQueue;
+    thread workerThread;
+    atomic<bool> finished;
+    bool holdsWriteLock;
+    ERR result;
+    string exceptionMsg;
+
+    static atomic<int> runningWorkerCount;
+
+    void run();
+    void joinAndUnblock();
+    PlayerPairList rebindToWorkDb(const PlayerPairList& ppList) const;
+  };
+
+}
+
+#endif // CATINITWORKER_H
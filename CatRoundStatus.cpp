@@ -20,6 +20,7 @@
 
 #include "CatRoundStatus.h"
 #include "MatchMngr.h"
+#include "MatchCounterCache.h"
 
 namespace QTournament
 {
@@ -49,30 +50,21 @@ QList<int> CatRoundStatus::getCurrentlyRunningRoundNumbers() const
   QList<int> result;
 
   int lastFinishedRound = getFinishedRoundsCount();
-  int minRoundRunning = -1;
-  int maxRoundRunning = -1;
 
   // the initial round that could be in state RUNNING
   int roundToCheck = (lastFinishedRound < 0) ? 1 : lastFinishedRound+1;
 
-  // the last round that can possibly in state RUNNING
-  MatchMngr mm{db};
-  int lastRoundToCheck = mm.getHighestUsedRoundNumberInCategory(cat);
-
-  // loop through all applicable rounds and check their status
-  while (roundToCheck <= lastRoundToCheck)
+  // a round is "running" if it contains running or
+  // finished matches. The counters are sorted by round
+  // number, so the result is sorted as well
+  RoundCounterMap roundCounters = db->getMatchCounterCache()->getRoundCounters(cat.getId());
+  for (auto it = roundCounters.lower_bound(roundToCheck); it != roundCounters.end(); ++it)
   {
-    bool hasFinishedMatches = cat.hasMatchesInState(STAT_MA_FINISHED, roundToCheck);
-    bool hasRunningMatches = cat.hasMatchesInState(STAT_MA_RUNNING, roundToCheck);
-
-    if (hasFinishedMatches || hasRunningMatches)
+    const MatchCounters& mc = it->second;
+    if ((mc.finished > 0) || (mc.running > 0))
     {
-      if (minRoundRunning < 0) minRoundRunning = roundToCheck;
-      if (maxRoundRunning < roundToCheck) maxRoundRunning = roundToCheck;
-      result.append(roundToCheck);
+      result.append(it->first);
     }
-
-    ++roundToCheck;
   }
 
   return result;
@@ -156,19 +148,13 @@ tuple<int, int, int> CatRoundStatus::getMatchCountForCurrentRound() const
   int runningMatchCount = 0;
   int totalMatchCount = 0;
 
-  MatchMngr mm{db};
+  RoundCounterMap roundCounters = db->getMatchCounterCache()->getRoundCounters(cat.getId());
   for (int curRound : runningRounds)
   {
-    MatchGroupList matchGroupsInThisRound = mm.getMatchGroupsForCat(cat, curRound);
-    for (MatchGroup mg : matchGroupsInThisRound)
-    {
-      for (Match ma : mg.getMatches())
-      {
-        if (ma.getState() != STAT_MA_FINISHED) ++unfinishedMatchCount;
-        if (ma.getState() == STAT_MA_RUNNING) ++runningMatchCount;
-        ++totalMatchCount;
-      }
-    }
+    const MatchCounters& mc = roundCounters[curRound];
+    unfinishedMatchCount += mc.total - mc.finished;
+    runningMatchCount += mc.running;
+    totalMatchCount += mc.total;
   }
 
   // total, unfinished, running
@@ -16,28 +16,232 @@
  *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QThread>
+
 #include "CentralSignalEmitter.h"
 
 namespace QTournament
 {
 
   CentralSignalEmitter* CentralSignalEmitter::inst = nullptr;
+  CentralSignalEmitter* CentralSignalEmitter::mutedInst = nullptr;
 
   //----------------------------------------------------------------------------
 
   CentralSignalEmitter*CentralSignalEmitter::getInstance()
   {
-    if (inst == nullptr) inst = new CentralSignalEmitter();
+    // both instances are created in the GUI thread, before
+    // the first worker thread is started
+    if (inst == nullptr)
+    {
+      inst = new CentralSignalEmitter();
+      mutedInst = new CentralSignalEmitter();
+      mutedInst->blockSignals(true);
+    }
 
-    return inst;
+    // the signals of worker threads refer to private copies of the
+    // database and would be delivered to the GUI thread with a delay
+    return inst->isForeignThread() ? mutedInst : inst;
   }
 
   //----------------------------------------------------------------------------
 
   CentralSignalEmitter::CentralSignalEmitter(QObject* parent)
-    :QObject(parent)
+    :QObject(parent), batchDepth(0), isDelivering(false)
+  {
+
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CentralSignalEmitter::notifyMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState)
+  {
+    if (isForeignThread()) return;
+
+    emit matchStatusRecorded(matchId, matchSeqNum, fromState, toState);
+
+    if (batchDepth > 0)
+    {
+      addChange(pendingChanges.matches, matchId2Idx, matchId, matchSeqNum, fromState, toState);
+    } else {
+      emit matchStatusChanged(matchId, matchSeqNum, fromState, toState);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CentralSignalEmitter::notifyMatchGroupStatusChanged(int matchGroupId, int matchGroupSeqNum, OBJ_STATE fromState, OBJ_STATE toState)
+  {
+    if (isForeignThread()) return;
+
+    if (batchDepth > 0)
+    {
+      addChange(pendingChanges.matchGroups, matchGroupId2Idx, matchGroupId, matchGroupSeqNum, fromState, toState);
+    } else {
+      emit matchGroupStatusChanged(matchGroupId, matchGroupSeqNum, fromState, toState);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CentralSignalEmitter::notifyMatchResultUpdated(int matchId, int matchSeqNum)
+  {
+    if (isForeignThread()) return;
+
+    emit matchResultRecorded(matchId, matchSeqNum);
+
+    if (batchDepth > 0)
+    {
+      if (matchesWithResult.insert(matchId).second)
+      {
+        pendingChanges.matchResults.push_back(make_pair(matchId, matchSeqNum));
+      }
+    } else {
+      emit matchResultUpdated(matchId, matchSeqNum);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CentralSignalEmitter::notifyPlayerStatusChanged(int playerId, int playerSeqNum, OBJ_STATE fromState, OBJ_STATE toState)
+  {
+    if (isForeignThread()) return;
+
+    emit playerStatusRecorded(playerId, playerSeqNum, fromState, toState);
+
+    if (batchDepth > 0)
+    {
+      addChange(pendingChanges.players, playerId2Idx, playerId, playerSeqNum, fromState, toState);
+    } else {
+      emit playerStatusChanged(playerId, playerSeqNum, fromState, toState);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CentralSignalEmitter::notifyCourtStatusChanged(int courtId, int courtSeqNum, OBJ_STATE fromState, OBJ_STATE toState)
+  {
+    if (isForeignThread()) return;
+
+    if (batchDepth > 0)
+    {
+      addChange(pendingChanges.courts, courtId2Idx, courtId, courtSeqNum, fromState, toState);
+    } else {
+      emit courtStatusChanged(courtId, courtSeqNum, fromState, toState);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CentralSignalEmitter::beginBatch()
+  {
+    if (isForeignThread()) return;
+
+    ++batchDepth;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CentralSignalEmitter::endBatch(bool deliver)
+  {
+    if (isForeignThread() || (batchDepth == 0)) return;
+
+    --batchDepth;
+    if (batchDepth > 0) return;
+
+    // move the changes out of the way before delivering
+    // them; the receivers might start a new batch
+    StatusChangeSet changes = std::move(pendingChanges);
+    clearPendingChanges();
+
+    if (!deliver)
+    {
+      // the indices might have read uncommitted data, even
+      // if there haven't been any status changes
+      emit statusChangeBatchDiscarded();
+      return;
+    }
+
+    if (!(changes.isEmpty())) deliverChanges(changes);
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool CentralSignalEmitter::isForeignThread() const
   {
+    // notifications from worker threads refer to private
+    // copies of the database and don't concern the GUI
+    return (QThread::currentThread() != thread());
+  }
 
+  //----------------------------------------------------------------------------
+
+  void CentralSignalEmitter::addChange(vector<StatusChange>& changes, unordered_map<int, size_t>& id2Idx, int id, int seqNum, OBJ_STATE fromState, OBJ_STATE toState)
+  {
+    auto it = id2Idx.find(id);
+    if (it == id2Idx.end())
+    {
+      id2Idx[id] = changes.size();
+      changes.push_back(StatusChange{id, seqNum, fromState, toState});
+      return;
+    }
+
+    // keep the initial "from" state
+    changes[it->second].toState = toState;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CentralSignalEmitter::clearPendingChanges()
+  {
+    pendingChanges = StatusChangeSet{};
+    matchId2Idx.clear();
+    matchGroupId2Idx.clear();
+    playerId2Idx.clear();
+    courtId2Idx.clear();
+    matchesWithResult.clear();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void CentralSignalEmitter::deliverChanges(const StatusChangeSet& changes)
+  {
+    bool wasDelivering = isDelivering;
+    isDelivering = true;
+
+    // maintain the usual sequence: match groups, matches
+    // and results first, then players and courts
+    for (const StatusChange& sc : changes.matchGroups)
+    {
+      emit matchGroupStatusChanged(sc.id, sc.seqNum, sc.fromState, sc.toState);
+    }
+    for (const StatusChange& sc : changes.matches)
+    {
+      emit matchStatusChanged(sc.id, sc.seqNum, sc.fromState, sc.toState);
+    }
+    for (const auto& pr : changes.matchResults)
+    {
+      emit matchResultUpdated(pr.first, pr.second);
+    }
+    for (const StatusChange& sc : changes.players)
+    {
+      emit playerStatusChanged(sc.id, sc.seqNum, sc.fromState, sc.toState);
+    }
+    for (const StatusChange& sc : changes.courts)
+    {
+      emit courtStatusChanged(sc.id, sc.seqNum, sc.fromState, sc.toState);
+    }
+
+    emit statusChangeBatchDelivered(changes);
+
+    isDelivering = wasDelivering;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool StatusChangeSet::isEmpty() const
+  {
+    return (matches.empty() && matchGroups.empty() && players.empty() && courts.empty() && matchResults.empty());
   }
 
   //----------------------------------------------------------------------------
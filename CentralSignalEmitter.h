@@ -19,15 +19,74 @@
 #ifndef CENTRALSIGNALEMITTER_H
 #define CENTRALSIGNALEMITTER_H
 
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
 #include <QObject>
 
 #include "Category.h"
 #include "Player.h"
 #include "Court.h"
 
+using namespace std;
+
 namespace QTournament
 {
+  // the coalesced state change of a single object within a batch:
+  // "fromState" is the state before the first change and "toState"
+  // is the state after the last change
+  struct StatusChange
+  {
+    int id;
+    int seqNum;
+    OBJ_STATE fromState;
+    OBJ_STATE toState;
+  };
+
+  // all changes of a batch, each list in the order
+  // of the first change of the respective object
+  struct StatusChangeSet
+  {
+    vector<StatusChange> matches;
+    vector<StatusChange> matchGroups;
+    vector<StatusChange> players;
+    vector<StatusChange> courts;
+    vector<pair<int, int>> matchResults;   // pairs of (matchId, matchSeqNum)
+
+    bool isEmpty() const;
+  };
+
+  //----------------------------------------------------------------------------
 
+  /*
+   * The status of matches, match groups, players and courts should be
+   * reported through the notify...() functions and not by emitting the
+   * signals directly.
+   *
+   * Outside of a batch, the notifications are turned into signals
+   * immediately. Between beginBatch() and endBatch(), which is normally
+   * controlled by the TransactionGuard, the notifications are collected
+   * and coalesced per object. After a commit, each changed object emits
+   * its signal only once, followed by statusChangeBatchDelivered() with
+   * the complete change set. Receivers that prefer to process the whole
+   * set in one go can ignore the single signals while isDeliveringBatch()
+   * is true. After a rollback, the collected changes are discarded.
+   *
+   * The ...Recorded() signals are never batched. They are meant for the
+   * in-memory indices that have to be in sync with the database even
+   * within a running transaction. After a rollback, these receivers get
+   * statusChangeBatchDiscarded() because they might have picked up
+   * changes that have never been committed.
+   *
+   * Notifications and batches are only processed in the thread of the
+   * emitter (the GUI thread). Managers that work on a private database
+   * copy in another thread must not affect the GUI's batch; their
+   * notifications are ignored. For the same reason, getInstance()
+   * returns a muted twin of the emitter when it's called from another
+   * thread, so that the signals that are emitted directly never reach
+   * the GUI either.
+   */
   class CentralSignalEmitter : public QObject
   {
     Q_OBJECT
@@ -35,6 +94,20 @@ namespace QTournament
   public:
     static CentralSignalEmitter* getInstance();
 
+    // status notifications
+    void notifyMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState);
+    void notifyMatchGroupStatusChanged(int matchGroupId, int matchGroupSeqNum, OBJ_STATE fromState, OBJ_STATE toState);
+    void notifyMatchResultUpdated(int matchId, int matchSeqNum);
+    void notifyPlayerStatusChanged(int playerId, int playerSeqNum, OBJ_STATE fromState, OBJ_STATE toState);
+    void notifyCourtStatusChanged(int courtId, int courtSeqNum, OBJ_STATE fromState, OBJ_STATE toState);
+
+    // batching; batches can be nested and only
+    // the outermost endBatch() delivers or discards
+    void beginBatch();
+    void endBatch(bool deliver);
+    bool isBatching() const { return (batchDepth > 0); }
+    bool isDeliveringBatch() const { return isDelivering; }
+
   signals:
     // Signals emitted by the CatMngr
     void playersPaired(const Category c, const Player& p1, const Player& p2) const;
@@ -86,11 +159,41 @@ namespace QTournament
     // Signals emitted by the MatchTimePredictor
     void matchTimePredictionChanged(int newAvgMatchDuration, time_t finishOfLastScheduledMatch__UTC);
 
+    // Signals emitted by the TournamentDB
+    void rowChangesCommitted(const RowChangeSet& changes) const;
+
+    // Unbatched twins of the status signals, emitted immediately
+    void matchStatusRecorded(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState) const;
+    void matchResultRecorded(int matchId, int matchSeqNum) const;
+    void playerStatusRecorded(int playerId, int playerSeqNum, OBJ_STATE fromState, OBJ_STATE toState) const;
+
+    // Emitted after all single signals of a committed batch
+    void statusChangeBatchDelivered(const StatusChangeSet& changes) const;
+
+    // Emitted after a rolled back batch; all ...Recorded()
+    // signals of the batch are void
+    void statusChangeBatchDiscarded() const;
+
   public slots:
 
   private:
     explicit CentralSignalEmitter(QObject *parent = 0);
     static CentralSignalEmitter* inst;
+    static CentralSignalEmitter* mutedInst;   // for all other threads
+
+    int batchDepth;
+    bool isDelivering;
+    StatusChangeSet pendingChanges;
+    unordered_map<int, size_t> matchId2Idx;
+    unordered_map<int, size_t> matchGroupId2Idx;
+    unordered_map<int, size_t> playerId2Idx;
+    unordered_map<int, size_t> courtId2Idx;
+    unordered_set<int> matchesWithResult;
+
+    bool isForeignThread() const;
+    static void addChange(vector<StatusChange>& changes, unordered_map<int, size_t>& id2Idx, int id, int seqNum, OBJ_STATE fromState, OBJ_STATE toState);
+    void clearPendingChanges();
+    void deliverChanges(const StatusChangeSet& changes);
   };
 
 }
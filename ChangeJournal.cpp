@@ -0,0 +1,471 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __IS_WINDOWS_BUILD
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "ChangeJournal.h"
+#include "TournamentDataDefs.h"
+
+namespace QTournament
+{
+  // allocate static variables
+  constexpr char ChangeJournal::FILE_MAGIC[];
+  constexpr int ChangeJournal::FILE_MAGIC_LEN;
+  constexpr qint64 ChangeJournal::COMPACTION_THRESHOLD__BYTES;
+  constexpr int ChangeJournal::COMPACTION_THRESHOLD__RECORDS;
+  constexpr char ChangeJournal::BASE_SCHEMA_NAME[];
+
+  namespace
+  {
+    // the journal is the authoritative source for all changes
+    // after the last full save, so we overwrite conflicting data.
+    // Changes of missing rows or changes that violate constraints
+    // indicate that the journal doesn't belong to the base file;
+    // in this case we abort instead of silently dropping data.
+    int onReplayConflict(void*, int conflictType, sqlite3_changeset_iter*)
+    {
+      if ((conflictType == SQLITE_CHANGESET_DATA) || (conflictType == SQLITE_CHANGESET_CONFLICT))
+      {
+        return SQLITE_CHANGESET_REPLACE;
+      }
+
+      if ((conflictType == SQLITE_CHANGESET_NOTFOUND) || (conflictType == SQLITE_CHANGESET_CONSTRAINT))
+      {
+        return SQLITE_CHANGESET_ABORT;
+      }
+
+      return SQLITE_CHANGESET_OMIT;
+    }
+
+    // the match display table is maintained by triggers that
+    // also fire when the journal is replayed, so we don't record it
+    int isJournaledTable(void*, const char* tabName)
+    {
+      return (strcmp(tabName, TAB_MATCH_DISPLAY) != 0);
+    }
+
+    bool syncToDisk(QFile& f)
+    {
+      if (!(f.flush())) return false;
+
+#ifdef __IS_WINDOWS_BUILD
+      return (_commit(f.handle()) == 0);
+#else
+      return (fsync(f.handle()) == 0);
+#endif
+    }
+  }
+
+  QString ChangeJournal::getJournalFileName(const QString& dbFileName)
+  {
+    return dbFileName + ".journal";
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR ChangeJournal::replay(sqlite3* dbPtr, const QString& journalFileName, int* nRecords)
+  {
+    if (nRecords != nullptr) *nRecords = 0;
+    if (!(QFile::exists(journalFileName))) return FILE_NOT_EXISTING;
+
+    QList<QByteArray> records = readRecords(journalFileName);
+    if (records.isEmpty()) return OK;
+
+    // a partially replayed journal would leave the database
+    // in a state that never existed, so we apply all records
+    // within one savepoint
+    if (sqlite3_exec(dbPtr, "SAVEPOINT journal_replay", nullptr, nullptr, nullptr) != SQLITE_OK) return DATABASE_ERROR;
+
+    int cnt = 0;
+    for (QByteArray& rec : records)
+    {
+      int err = sqlite3changeset_apply(dbPtr, rec.size(), rec.data(), nullptr, &onReplayConflict, nullptr);
+      if (err != SQLITE_OK)
+      {
+        sqlite3_exec(dbPtr, "ROLLBACK TO journal_replay", nullptr, nullptr, nullptr);
+        sqlite3_exec(dbPtr, "RELEASE journal_replay", nullptr, nullptr, nullptr);
+        return DATABASE_ERROR;
+      }
+
+      ++cnt;
+    }
+
+    if (sqlite3_exec(dbPtr, "RELEASE journal_replay", nullptr, nullptr, nullptr) != SQLITE_OK) return DATABASE_ERROR;
+
+    if (nRecords != nullptr) *nRecords = cnt;
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  ChangeJournal::ChangeJournal(sqlite3* _dbPtr, const QString& _fileName)
+    :QObject(), dbPtr(_dbPtr), fileName(_fileName), session(nullptr), isFlushPending(false),
+      recordCount(0), fileSize(0)
+  {
+    // continue an existing journal but drop
+    // a torn record at the end of the file
+    qint64 validSize = 0;
+    QList<QByteArray> records = readRecords(fileName, &validSize);
+    if (records.isEmpty())
+    {
+      if (writeFile(records, false) != OK) return;
+    } else {
+      QFile f{fileName};
+      if (f.size() != validSize)
+      {
+        if (!(f.resize(validSize))) return;
+      }
+      recordCount = records.size();
+      fileSize = validSize;
+    }
+
+    startSession();
+  }
+
+  //----------------------------------------------------------------------------
+
+  ChangeJournal::~ChangeJournal()
+  {
+    if (session == nullptr) return;
+
+    flush();
+    stopSession();
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool ChangeJournal::needsCompaction() const
+  {
+    return ((fileSize > COMPACTION_THRESHOLD__BYTES) || (recordCount > COMPACTION_THRESHOLD__RECORDS));
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR ChangeJournal::flush()
+  {
+    isFlushPending = false;
+    if (session == nullptr) return DATABASE_ERROR;
+
+    // never write uncommitted changes that might be rolled back
+    // later; the commit hook will request another flush
+    if (!(sqlite3_get_autocommit(dbPtr))) return OK;
+
+    if (sqlite3session_isempty(session)) return OK;
+
+    int size = 0;
+    void* data = nullptr;
+    int err = sqlite3session_changeset(session, &size, &data);
+    if (err != SQLITE_OK) return DATABASE_ERROR;
+    QByteArray changeset{static_cast<const char*>(data), size};
+    sqlite3_free(data);
+
+    // start a new session so that the next record
+    // only contains the changes after this point
+    stopSession();
+    if (!(startSession())) return DATABASE_ERROR;
+
+    if (changeset.isEmpty()) return OK;
+
+    return writeFile(QList<QByteArray>{changeset}, true);
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR ChangeJournal::compact()
+  {
+    ERR e = flush();
+    if (e != OK) return e;
+    if (recordCount < 2) return OK;
+
+    QList<QByteArray> records = readRecords(fileName);
+
+    // merge all records into one changeset; multiple
+    // changes of the same row are combined into one change
+    sqlite3_changegroup* grp;
+    if (sqlite3changegroup_new(&grp) != SQLITE_OK) return DATABASE_ERROR;
+    for (QByteArray& rec : records)
+    {
+      int err = sqlite3changegroup_add(grp, rec.size(), rec.data());
+      if (err != SQLITE_OK)
+      {
+        sqlite3changegroup_delete(grp);
+        return DATABASE_ERROR;
+      }
+    }
+
+    int size = 0;
+    void* data = nullptr;
+    int err = sqlite3changegroup_output(grp, &size, &data);
+    sqlite3changegroup_delete(grp);
+    if (err != SQLITE_OK) return DATABASE_ERROR;
+    QByteArray changeset{static_cast<const char*>(data), size};
+    sqlite3_free(data);
+
+    records.clear();
+    if (!(changeset.isEmpty())) records.append(changeset);
+    return writeFile(records, false);
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR ChangeJournal::clear()
+  {
+    // all changes up to now are contained in the full save
+    stopSession();
+    if (!(startSession())) return DATABASE_ERROR;
+    isFlushPending = false;
+
+    return writeFile(QList<QByteArray>(), false);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void ChangeJournal::onFlushRequested()
+  {
+    flush();
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR ChangeJournal::beginExternalChange()
+  {
+    if (session == nullptr) return DATABASE_ERROR;
+
+    // write everything up to now, so that the next
+    // record only contains the external change
+    ERR e = flush();
+    if (e != OK) return e;
+
+    // keep a copy of the current content for the comparison
+    // in endExternalChange(); the attached database takes
+    // the ownership of the serialized data
+    sqlite3_int64 size = 0;
+    unsigned char* data = sqlite3_serialize(dbPtr, "main", &size, 0);
+    if (data == nullptr) return DATABASE_ERROR;
+
+    std::string sql = "ATTACH DATABASE ':memory:' AS ";
+    sql += BASE_SCHEMA_NAME;
+    if (sqlite3_exec(dbPtr, sql.c_str(), nullptr, nullptr, nullptr) != SQLITE_OK)
+    {
+      sqlite3_free(data);
+      return DATABASE_ERROR;
+    }
+
+    // the data is released by SQLite even if the call fails
+    int err = sqlite3_deserialize(dbPtr, BASE_SCHEMA_NAME, data, size, size, SQLITE_DESERIALIZE_FREEONCLOSE | SQLITE_DESERIALIZE_READONLY);
+    if (err != SQLITE_OK)
+    {
+      sql = "DETACH DATABASE ";
+      sql += BASE_SCHEMA_NAME;
+      sqlite3_exec(dbPtr, sql.c_str(), nullptr, nullptr, nullptr);
+      return DATABASE_ERROR;
+    }
+
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR ChangeJournal::endExternalChange()
+  {
+    if (session == nullptr) return DATABASE_ERROR;
+
+    // the names of all tables of the modified database
+    std::vector<std::string> tabNames;
+    sqlite3_stmt* stmt = nullptr;
+    int err = sqlite3_prepare_v2(dbPtr, "SELECT name FROM main.sqlite_master WHERE type='table' AND name NOT LIKE 'sqlite_%'", -1, &stmt, nullptr);
+    if (err == SQLITE_OK)
+    {
+      while (sqlite3_step(stmt) == SQLITE_ROW)
+      {
+        tabNames.push_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+      }
+    }
+    sqlite3_finalize(stmt);
+
+    // let the session record all differences
+    // as if they had been made row by row
+    ERR result = (err == SQLITE_OK) ? OK : DATABASE_ERROR;
+    for (const std::string& tabName : tabNames)
+    {
+      if (result != OK) break;
+      if (!(isJournaledTable(nullptr, tabName.c_str()))) continue;
+
+      char* errMsg = nullptr;
+      err = sqlite3session_diff(session, BASE_SCHEMA_NAME, tabName.c_str(), &errMsg);
+      sqlite3_free(errMsg);
+      if (err != SQLITE_OK) result = DATABASE_ERROR;
+    }
+
+    std::string sql = "DETACH DATABASE ";
+    sql += BASE_SCHEMA_NAME;
+    sqlite3_exec(dbPtr, sql.c_str(), nullptr, nullptr, nullptr);
+
+    if (result != OK) return result;
+
+    // persist the change immediately
+    return flush();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void ChangeJournal::onCommit()
+  {
+    // we're called from within the commit hook and must not access
+    // the database, so we only schedule a flush for the next event
+    // loop iteration. Explicit transactions are flushed synchronously
+    // by the database after the commit has returned.
+    if (!isFlushPending)
+    {
+      isFlushPending = true;
+      QMetaObject::invokeMethod(this, "onFlushRequested", Qt::QueuedConnection);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  quint32 ChangeJournal::calcChecksum(const QByteArray& data)
+  {
+    // FNV-1a
+    quint32 result = 2166136261u;
+    for (char c : data)
+    {
+      result ^= static_cast<quint8>(c);
+      result *= 16777619u;
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  QList<QByteArray> ChangeJournal::readRecords(const QString& journalFileName, qint64* validSize)
+  {
+    QList<QByteArray> result;
+    if (validSize != nullptr) *validSize = 0;
+
+    QFile f{journalFileName};
+    if (!(f.open(QIODevice::ReadOnly))) return result;
+    QByteArray content = f.readAll();
+    if (!(content.startsWith(FILE_MAGIC))) return result;
+
+    // read records until the end of the file or
+    // until we hit an incomplete or corrupted record
+    int pos = FILE_MAGIC_LEN;
+    while ((content.size() - pos) >= 8)
+    {
+      const uchar* hdr = reinterpret_cast<const uchar*>(content.constData() + pos);
+      quint32 len = qFromLittleEndian<quint32>(hdr);
+      quint32 checksum = qFromLittleEndian<quint32>(hdr + 4);
+      if ((content.size() - pos - 8) < static_cast<qint64>(len)) break;
+
+      QByteArray rec = content.mid(pos + 8, len);
+      if (calcChecksum(rec) != checksum) break;
+
+      result.append(rec);
+      pos += 8 + len;
+    }
+
+    if (validSize != nullptr) *validSize = pos;
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool ChangeJournal::startSession()
+  {
+    if (sqlite3session_create(dbPtr, "main", &session) != SQLITE_OK)
+    {
+      session = nullptr;
+      return false;
+    }
+
+    // record all tables except for derived data
+    sqlite3session_table_filter(session, &isJournaledTable, nullptr);
+    if (sqlite3session_attach(session, nullptr) != SQLITE_OK)
+    {
+      stopSession();
+      return false;
+    }
+
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void ChangeJournal::stopSession()
+  {
+    if (session == nullptr) return;
+
+    sqlite3session_delete(session);
+    session = nullptr;
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR ChangeJournal::writeFile(const QList<QByteArray>& records, bool append)
+  {
+    QByteArray buf;
+    if (!append) buf.append(FILE_MAGIC, FILE_MAGIC_LEN);
+    for (const QByteArray& rec : records)
+    {
+      uchar hdr[8];
+      qToLittleEndian<quint32>(rec.size(), hdr);
+      qToLittleEndian<quint32>(calcChecksum(rec), hdr + 4);
+      buf.append(reinterpret_cast<const char*>(hdr), 8);
+      buf.append(rec);
+    }
+
+    if (append)
+    {
+      QFile f{fileName};
+      if (!(f.open(QIODevice::WriteOnly | QIODevice::Append))) return FILE_IO_ERROR;
+      if (f.write(buf) != buf.size()) return FILE_IO_ERROR;
+      if (!(syncToDisk(f))) return FILE_IO_ERROR;
+
+      recordCount += records.size();
+      fileSize += buf.size();
+      return OK;
+    }
+
+    // replace the whole file atomically
+    QSaveFile f{fileName};
+    if (!(f.open(QIODevice::WriteOnly))) return FILE_IO_ERROR;
+    if (f.write(buf) != buf.size()) return FILE_IO_ERROR;
+    if (!(f.commit())) return FILE_IO_ERROR;
+
+    recordCount = records.size();
+    fileSize = buf.size();
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+}
@@ -0,0 +1,121 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHANGEJOURNAL_H
+#define CHANGEJOURNAL_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QList>
+
+// the session extension is only declared by sqlite3.h if
+// SQLITE_ENABLE_SESSION and SQLITE_ENABLE_PREUPDATE_HOOK are
+// defined (see the project file); the linked SQLite library
+// must have been built with the same flags
+#include <sqlite3.h>
+
+#include "TournamentErrorCodes.h"
+
+namespace QTournament
+{
+  /*
+   * A durable, append-only journal of all changes to the in-memory
+   * tournament database since the last full save.
+   *
+   * The changes are recorded with SQLite's session extension. After
+   * each committed write transaction, the accumulated changeset is
+   * appended as one record to the journal file and the file is synced
+   * to disk. After a crash, replay() re-applies all records on top of
+   * the last full save.
+   *
+   * File format: a four byte magic followed by records of
+   * [length (uint32, LE)] [checksum (uint32, LE)] [changeset]. A torn
+   * record at the end of the file (e.g., after a power loss during
+   * the write) is ignored and truncated when the journal is re-opened.
+   *
+   * Modifications that bypass the session (e.g., copying the content
+   * of another database with sqlite3_backup) have to be enclosed in
+   * beginExternalChange() and endExternalChange(); they are recorded
+   * as the difference between the content before and after the change.
+   *
+   * Note: the session extension only records changes to tables with
+   * a PRIMARY KEY.
+   */
+  class ChangeJournal : public QObject
+  {
+    Q_OBJECT
+
+  public:
+    static constexpr char FILE_MAGIC[] = "QTJ1";
+    static constexpr int FILE_MAGIC_LEN = 4;
+    static constexpr qint64 COMPACTION_THRESHOLD__BYTES = 1024 * 1024;
+    static constexpr int COMPACTION_THRESHOLD__RECORDS = 1000;
+
+    static QString getJournalFileName(const QString& dbFileName);
+
+    // applies all valid records of a journal file to a database;
+    // either all records are applied or none
+    static ERR replay(sqlite3* dbPtr, const QString& journalFileName, int* nRecords = nullptr);
+
+    // starts recording; an existing journal file is continued
+    ChangeJournal(sqlite3* _dbPtr, const QString& _fileName);
+    virtual ~ChangeJournal();
+
+    bool isValid() const { return (session != nullptr); }
+    QString getFileName() const { return fileName; }
+    int getRecordCount() const { return recordCount; }
+    qint64 getFileSize() const { return fileSize; }
+    bool needsCompaction() const;
+
+    ERR flush();
+    ERR compact();
+    ERR clear();   // after a full save
+
+    // for modifications that are invisible to the session
+    ERR beginExternalChange();
+    ERR endExternalChange();
+
+    // called by the commit hook of the database for
+    // auto-committed statements
+    void onCommit();
+
+  public slots:
+    void onFlushRequested();
+
+  private:
+    static constexpr char BASE_SCHEMA_NAME[] = "journal_base";
+
+    sqlite3* dbPtr;
+    QString fileName;
+    sqlite3_session* session;
+    bool isFlushPending;
+    int recordCount;
+    qint64 fileSize;
+
+    static quint32 calcChecksum(const QByteArray& data);
+    static QList<QByteArray> readRecords(const QString& journalFileName, qint64* validSize = nullptr);
+
+    bool startSession();
+    void stopSession();
+    ERR writeFile(const QList<QByteArray>& records, bool append);
+  };
+
+}
+
+#endif // CHANGEJOURNAL_H
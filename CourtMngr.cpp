@@ -211,7 +211,7 @@ namespace QTournament
     }
 
     co.setState(STAT_CO_BUSY);
-    CentralSignalEmitter::getInstance()->courtStatusChanged(co.getId(), co.getSeqNum(), STAT_CO_AVAIL, STAT_CO_BUSY);
+    CentralSignalEmitter::getInstance()->notifyCourtStatusChanged(co.getId(), co.getSeqNum(), STAT_CO_AVAIL, STAT_CO_BUSY);
     return true;
   }
 
@@ -237,7 +237,7 @@ namespace QTournament
 
     // all fine, we can fall back to AVAIL
     co.setState(STAT_CO_AVAIL);
-    CentralSignalEmitter::getInstance()->courtStatusChanged(co.getId(), co.getSeqNum(), STAT_CO_BUSY, STAT_CO_AVAIL);
+    CentralSignalEmitter::getInstance()->notifyCourtStatusChanged(co.getId(), co.getSeqNum(), STAT_CO_BUSY, STAT_CO_AVAIL);
     return true;
   }
 
@@ -254,7 +254,7 @@ namespace QTournament
 
     // change the court state and emit a change event
     co.setState(STAT_CO_DISABLED);
-    CentralSignalEmitter::getInstance()->courtStatusChanged(co.getId(), co.getSeqNum(), stat, STAT_CO_DISABLED);
+    CentralSignalEmitter::getInstance()->notifyCourtStatusChanged(co.getId(), co.getSeqNum(), stat, STAT_CO_DISABLED);
     return OK;
   }
 
@@ -268,7 +268,7 @@ namespace QTournament
 
     // change the court state and emit a change event
     co.setState(STAT_CO_AVAIL);
-    CentralSignalEmitter::getInstance()->courtStatusChanged(co.getId(), co.getSeqNum(), STAT_CO_DISABLED, STAT_CO_AVAIL);
+    CentralSignalEmitter::getInstance()->notifyCourtStatusChanged(co.getId(), co.getSeqNum(), STAT_CO_DISABLED, STAT_CO_AVAIL);
     return OK;
   }
 
@@ -446,6 +446,13 @@ namespace QTournament
       return ModMatchResult::NotPossible;  // triggers implicit rollback through tg's dtor
     }
 
+    // re-fill the bracket references that we've erased above
+    if (isWinnerMod)
+    {
+      auto bvd = BracketVisData::getExisting(ma.getCategory());
+      if (bvd != nullptr) bvd->fillMissingPlayerNames();
+    }
+
     // update the ranking entries but skip the assignment of ranks
     RankingMngr rm{db};
     e = rm.updateRankingsAfterMatchResultChange(ma, oldScore, true);
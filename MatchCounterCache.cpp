@@ -0,0 +1,259 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MatchCounterCache.h"
+#include "CentralSignalEmitter.h"
+
+using namespace SqliteOverlay;
+
+namespace QTournament
+{
+
+  MatchCounterCache::MatchCounterCache(TournamentDB* _db)
+    :QObject(), db(_db), matchTab(db->getTab(TAB_MATCH)), groupTab(db->getTab(TAB_MATCH_GROUP)),
+      needsRebuild(true), tournamentCounters{0, 0, 0, 0}
+  {
+    // private copies of the database don't emit any signals
+    // and might be used in another thread; the database
+    // takes care of invalidating the cache in this case
+    if (db->getConnectionRole() != ConnectionRole::Primary) return;
+
+    CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
+
+    // state changes and match number assignments come
+    // along with a real or faked change of the match state;
+    // we use the unbatched signal because we're queried
+    // within running transactions as well
+    connect(cse, SIGNAL(matchStatusRecorded(int,int,OBJ_STATE,OBJ_STATE)), this, SLOT(onMatchStatusChanged(int,int,OBJ_STATE,OBJ_STATE)), Qt::DirectConnection);
+
+    // new or deleted matches trigger a complete rebuild
+    connect(cse, SIGNAL(endCreateMatch(int)), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(endDeleteCategory()), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(endResetAllModels()), this, SLOT(invalidate()), Qt::DirectConnection);
+
+    // a rollback might have reverted changes that we've already read
+    connect(cse, SIGNAL(statusChangeBatchDiscarded()), this, SLOT(invalidate()), Qt::DirectConnection);
+
+    // the committed row feed also catches modifications that
+    // haven't been announced by any of the signals above
+    connect(cse, SIGNAL(rowChangesCommitted(RowChangeSet)), this, SLOT(onRowChangesCommitted(RowChangeSet)), Qt::DirectConnection);
+  }
+
+  //----------------------------------------------------------------------------
+
+  MatchCounters MatchCounterCache::getTournamentCounters()
+  {
+    syncIfNecessary();
+    return tournamentCounters;
+  }
+
+  //----------------------------------------------------------------------------
+
+  MatchCounters MatchCounterCache::getCategoryCounters(int catId)
+  {
+    syncIfNecessary();
+
+    MatchCounters result{0, 0, 0, 0};
+    auto it = cat2RoundCounters.find(catId);
+    if (it == cat2RoundCounters.end()) return result;
+
+    for (const auto& pr : it->second)
+    {
+      const MatchCounters& mc = pr.second;
+      result.total += mc.total;
+      result.scheduled += mc.scheduled;
+      result.running += mc.running;
+      result.finished += mc.finished;
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  RoundCounterMap MatchCounterCache::getRoundCounters(int catId)
+  {
+    syncIfNecessary();
+
+    auto it = cat2RoundCounters.find(catId);
+    if (it == cat2RoundCounters.end()) return RoundCounterMap();
+
+    return it->second;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchCounterCache::onMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState)
+  {
+    dirtyMatches.insert(matchId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchCounterCache::onRowChangesCommitted(const RowChangeSet& changes)
+  {
+    if (!(changes.isComplete))
+    {
+      invalidate();
+      return;
+    }
+
+    for (const RowChange& rc : changes.changes)
+    {
+      // re-reading a match also covers new and deleted matches
+      if (rc.tabName == TAB_MATCH)
+      {
+        dirtyMatches.insert(rc.rowId);
+        continue;
+      }
+
+      // the mapping of match groups to rounds
+      // might contain a deleted group
+      if ((rc.tabName == TAB_MATCH_GROUP) && (rc.type == RowChangeType::Delete))
+      {
+        invalidate();
+        return;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchCounterCache::invalidate()
+  {
+    needsRebuild = true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchCounterCache::syncIfNecessary()
+  {
+    if (needsRebuild)
+    {
+      rebuild();
+      return;
+    }
+
+    for (int maId : dirtyMatches)
+    {
+      // remove the old contribution of the match...
+      auto it = matches.find(maId);
+      if (it != matches.end())
+      {
+        applyMatch(it->second, -1);
+        matches.erase(it);
+      }
+
+      // ... and add the new one
+      auto r = matchTab->getSingleRowByColumnValue2("id", maId);
+      if (r != nullptr) readMatchRow(*r);
+    }
+    dirtyMatches.clear();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchCounterCache::rebuild()
+  {
+    tournamentCounters = MatchCounters{0, 0, 0, 0};
+    cat2RoundCounters.clear();
+    matches.clear();
+    groupId2CatAndRound.clear();
+    dirtyMatches.clear();
+
+    // pass 1: all match groups
+    auto it = groupTab->getRowsByWhereClause("id > 0");
+    while (!(it.isEnd()))
+    {
+      TabRow r = *it;
+      groupId2CatAndRound[r.getId()] = make_pair(r.getInt(MG_CAT_REF), r.getInt(MG_ROUND));
+
+      ++it;
+    }
+
+    // pass 2: all matches
+    it = matchTab->getRowsByWhereClause("id > 0");
+    while (!(it.isEnd()))
+    {
+      readMatchRow(*it);
+      ++it;
+    }
+
+    needsRebuild = false;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchCounterCache::readMatchRow(const TabRow& r)
+  {
+    MatchInfo mi;
+    tie(mi.catId, mi.round) = getCatAndRoundForGroup(r.getInt(MA_GRP_REF));
+    mi.state = static_cast<OBJ_STATE>(r.getInt(GENERIC_STATE_FIELD_NAME));
+    auto maNum = r.getInt2(MA_NUM);
+    mi.hasMatchNumber = ((!(maNum->isNull())) && (maNum->get() > 0));
+
+    applyMatch(mi, 1);
+    matches[r.getId()] = mi;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void MatchCounterCache::applyMatch(const MatchInfo& mi, int sign)
+  {
+    // new map entries are value-initialized, so all counters start at zero
+    MatchCounters& rc = cat2RoundCounters[mi.catId][mi.round];
+
+    for (MatchCounters* mc : {&tournamentCounters, &rc})
+    {
+      mc->total += sign;
+
+      if (mi.state == STAT_MA_RUNNING)
+      {
+        mc->running += sign;
+      }
+      else if (mi.state == STAT_MA_FINISHED)
+      {
+        mc->finished += sign;
+      }
+      else if (mi.hasMatchNumber)
+      {
+        mc->scheduled += sign;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  pair<int, int> MatchCounterCache::getCatAndRoundForGroup(int groupId)
+  {
+    auto it = groupId2CatAndRound.find(groupId);
+    if (it != groupId2CatAndRound.end()) return it->second;
+
+    // the group has been created after the last rebuild
+    auto r = groupTab->getSingleRowByColumnValue2("id", groupId);
+    if (r == nullptr) return make_pair(-1, -1);
+
+    pair<int, int> result = make_pair(r->getInt(MG_CAT_REF), r->getInt(MG_ROUND));
+    groupId2CatAndRound[groupId] = result;
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+}
@@ -0,0 +1,110 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATCHCOUNTERCACHE_H
+#define MATCHCOUNTERCACHE_H
+
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <QObject>
+
+#include <SqliteOverlay/DbTab.h>
+#include <SqliteOverlay/TabRow.h>
+
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  struct MatchCounters
+  {
+    int total;
+    int scheduled;   // has a match number but is neither running nor finished
+    int running;
+    int finished;    // includes walkovers
+  };
+
+  using RoundCounterMap = map<int, MatchCounters>;   // key: round number
+
+  //----------------------------------------------------------------------------
+
+  /*
+   * Match counters for the whole tournament, per category and
+   * per category round.
+   *
+   * The counters are built with one pass over the match group table
+   * and one pass over the match table. Afterwards, only those matches
+   * that have emitted a (faked) matchStatusRecorded() or that show up
+   * in the committed row change feed are re-read and their old
+   * contribution to the counters is replaced by the new one.
+   *
+   * New matches, deleted categories and rollbacks trigger a lazy rebuild.
+   */
+  class MatchCounterCache : public QObject
+  {
+    Q_OBJECT
+
+  public:
+    // ctor
+    MatchCounterCache(TournamentDB* _db);
+
+    // getters
+    MatchCounters getTournamentCounters();
+    MatchCounters getCategoryCounters(int catId);
+    RoundCounterMap getRoundCounters(int catId);
+
+  public slots:
+    void onMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState);
+    void onRowChangesCommitted(const RowChangeSet& changes);
+    void invalidate();
+
+  private:
+    struct MatchInfo
+    {
+      int catId;
+      int round;
+      OBJ_STATE state;
+      bool hasMatchNumber;
+    };
+
+    TournamentDB* db;
+    SqliteOverlay::DbTab* matchTab;
+    SqliteOverlay::DbTab* groupTab;
+    bool needsRebuild;
+
+    MatchCounters tournamentCounters;
+    unordered_map<int, RoundCounterMap> cat2RoundCounters;
+    unordered_map<int, MatchInfo> matches;
+    unordered_map<int, pair<int, int>> groupId2CatAndRound;
+
+    unordered_set<int> dirtyMatches;
+
+    void syncIfNecessary();
+    void rebuild();
+    void readMatchRow(const SqliteOverlay::TabRow& r);
+    void applyMatch(const MatchInfo& mi, int sign);
+    pair<int, int> getCatAndRoundForGroup(int groupId);
+  };
+
+}
+
+#endif // MATCHCOUNTERCACHE_H
@@ -0,0 +1,102 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdlib>
+
+#include "MatchDisplay.h"
+#include "HelperFunc.h"
+
+using namespace SqliteOverlay;
+
+namespace QTournament
+{
+
+  MatchDisplay MatchDisplay::fromRow(const TabRow& r)
+  {
+    auto getOptionalInt = [&r](const char* colName, int nullValue) {
+      auto v = r.getInt2(colName);
+      return v->isNull() ? nullValue : v->get();
+    };
+
+    auto getOptionalString = [&r](const char* colName) {
+      auto v = r.getString2(colName);
+      return v->isNull() ? QString() : stdString2QString(v->get());
+    };
+
+    MatchDisplay md;
+    md.matchId = r.getId();
+    md.seqNum = r.getInt(GENERIC_SEQNUM_FIELD_NAME);
+    md.matchNum = getOptionalInt(MA_NUM, MATCH_NUM_NOT_ASSIGNED);
+    md.state = static_cast<OBJ_STATE>(r.getInt(GENERIC_STATE_FIELD_NAME));
+    md.catId = getOptionalInt(MD_CAT_REF, -1);
+    md.catName = getOptionalString(MD_CAT_NAME);
+    md.matchSystem = static_cast<MATCH_SYSTEM>(getOptionalInt(MD_MATCH_SYSTEM, 0));
+    md.round = getOptionalInt(MD_ROUND, -1);
+    md.grpNum = getOptionalInt(MD_GRP_NUM, GRP_NUM__NOT_ASSIGNED);
+
+    int wr = getOptionalInt(MA_WINNER_RANK, -1);
+    md.winnerRank = (wr < 1) ? -1 : wr;
+
+    md.refereeMode = static_cast<REFEREE_MODE>(getOptionalInt(MA_REFEREE_MODE, static_cast<int>(REFEREE_MODE::USE_DEFAULT)));
+    md.refereeId = getOptionalInt(MA_REFEREE_REF, -1);
+    md.refereeName = getOptionalString(MD_REFEREE_NAME);
+    md.courtId = getOptionalInt(MA_COURT_REF, -1);
+
+    md.pairId[0] = getOptionalInt(MA_PAIR1_REF, -1);
+    md.pairId[1] = getOptionalInt(MA_PAIR2_REF, -1);
+    md.symbolicName[0] = getOptionalInt(MD_PAIR1_SYMBOLIC_NAME, 0);
+    md.symbolicName[1] = getOptionalInt(MD_PAIR2_SYMBOLIC_NAME, 0);
+    md.player1Name[0] = getOptionalString(MD_PAIR1_PLAYER1_NAME);
+    md.player2Name[0] = getOptionalString(MD_PAIR1_PLAYER2_NAME);
+    md.player1Name[1] = getOptionalString(MD_PAIR2_PLAYER1_NAME);
+    md.player2Name[1] = getOptionalString(MD_PAIR2_PLAYER2_NAME);
+    md.teamName[0] = getOptionalString(MD_PAIR1_TEAM_NAME);
+    md.teamName[1] = getOptionalString(MD_PAIR2_TEAM_NAME);
+
+    return md;
+  }
+
+  //----------------------------------------------------------------------------
+
+  QString MatchDisplay::getDisplayName(const QString& localWinnerName, const QString& localLoserName) const
+  {
+    QString name[2];
+    for (int i = 0; i < 2; ++i)
+    {
+      if (symbolicName[i] != 0)
+      {
+        name[i] = (symbolicName[i] > 0) ? localWinnerName : localLoserName;
+        name[i] += " #" + QString::number(abs(symbolicName[i]));
+        continue;
+      }
+
+      if (pairId[i] < 0)
+      {
+        name[i] = "??";
+        continue;
+      }
+
+      name[i] = player1Name[i];
+      if (!(player2Name[i].isEmpty())) name[i] += " / " + player2Name[i];
+    }
+
+    return name[0] + " : " + name[1];
+  }
+
+  //----------------------------------------------------------------------------
+
+}
@@ -0,0 +1,74 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MATCHDISPLAY_H
+#define MATCHDISPLAY_H
+
+#include <QString>
+
+#include <SqliteOverlay/TabRow.h>
+
+#include "TournamentDataDefs.h"
+
+namespace QTournament
+{
+  /*
+   * Everything that is necessary for listing a match, read
+   * from one row of the materialized match display table.
+   *
+   * The table is maintained by triggers in the database (see
+   * TournamentDB::createMatchDisplayTable()), so a match list
+   * doesn't need to instantiate the match group, category,
+   * player pairs, players and umpire for each match.
+   *
+   * The table is a TEMP table of the primary connection; it
+   * doesn't exist in snapshots and private copies.
+   */
+  struct MatchDisplay
+  {
+    int matchId;
+    int seqNum;
+    int matchNum;   // MATCH_NUM_NOT_ASSIGNED if not yet scheduled
+    OBJ_STATE state;
+    int catId;
+    QString catName;
+    MATCH_SYSTEM matchSystem;
+    int round;
+    int grpNum;
+    int winnerRank;   // -1 if not set
+    REFEREE_MODE refereeMode;   // the effective mode if retrieved via MatchMngr
+    int refereeId;   // -1 if no umpire has been assigned
+    QString refereeName;
+    int courtId;   // -1 if not assigned to a court
+
+    // index 0 for player pair 1, index 1 for player pair 2
+    int pairId[2];   // -1 if the pair is not yet known
+    int symbolicName[2];   // same semantics as in Match::getSymbolicPlayerPairName()
+    QString player1Name[2];
+    QString player2Name[2];   // empty for singles
+    QString teamName[2];
+
+    // returns the raw referee mode, including USE_DEFAULT
+    static MatchDisplay fromRow(const SqliteOverlay::TabRow& r);
+
+    // same output as Match::getDisplayName()
+    QString getDisplayName(const QString& localWinnerName, const QString& localLoserName) const;
+  };
+
+}
+
+#endif // MATCHDISPLAY_H
@@ -29,6 +29,8 @@
 #include "PlayerMngr.h"
 #include "CourtMngr.h"
 #include "CatMngr.h"
+#include "MatchCounterCache.h"
+#include "reports/BracketVisData.h"
 #include <SqliteOverlay/KeyValueTab.h>
 
 using namespace SqliteOverlay;
@@ -530,7 +532,7 @@ namespace QTournament {
 
     // we can close the group unconditionally
     grp.setState(STAT_MG_FROZEN);
-    CentralSignalEmitter::getInstance()->matchGroupStatusChanged(grp.getId(), grp.getSeqNum(), STAT_MG_CONFIG, STAT_MG_FROZEN);
+    CentralSignalEmitter::getInstance()->notifyMatchGroupStatusChanged(grp.getId(), grp.getSeqNum(), STAT_MG_CONFIG, STAT_MG_FROZEN);
 
     // call updateAllMatchGroupStates in case the group can be further promoted
     // to idle (which enables the group the be scheduled)
@@ -568,7 +570,7 @@ namespace QTournament {
     }
 
     // fake a match-changed-event in order to trigger UI updates
-    CentralSignalEmitter::getInstance()->matchStatusChanged(ma.getId(), ma.getSeqNum(), stat, stat);
+    CentralSignalEmitter::getInstance()->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), stat, stat);
 
     return OK;
   }
@@ -623,10 +625,10 @@ namespace QTournament {
     {
       assert(currentReferee != nullptr);
       currentReferee->setState(STAT_PL_IDLE);
-      cse->playerStatusChanged(currentReferee->getId(), currentReferee->getSeqNum(), STAT_PL_REFEREE, STAT_PL_IDLE);
+      cse->notifyPlayerStatusChanged(currentReferee->getId(), currentReferee->getSeqNum(), STAT_PL_REFEREE, STAT_PL_IDLE);
 
       p.setState(STAT_PL_REFEREE);
-      cse->playerStatusChanged(p.getId(), p.getSeqNum(), STAT_PL_IDLE, STAT_PL_REFEREE);
+      cse->notifyPlayerStatusChanged(p.getId(), p.getSeqNum(), STAT_PL_IDLE, STAT_PL_REFEREE);
     }
 
     // maybe the match status changes after the assignment, because we're now
@@ -635,7 +637,7 @@ namespace QTournament {
 
     // fake a match-changed-event in order to trigger UI updates
     OBJ_STATE stat = ma.getState();
-    cse->matchStatusChanged(ma.getId(), ma.getSeqNum(), stat, stat);
+    cse->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), stat, stat);
 
     // in case we're calling a match or swapping the umpire:
     //
@@ -685,7 +687,7 @@ namespace QTournament {
     updateMatchStatus(ma);
 
     // fake a match-changed-event in order to trigger UI updates
-    CentralSignalEmitter::getInstance()->matchStatusChanged(ma.getId(), ma.getSeqNum(), stat, stat);
+    CentralSignalEmitter::getInstance()->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), stat, stat);
 
     return OK;
   }
@@ -754,6 +756,11 @@ namespace QTournament {
     // have changed due to the player swap
     updateMatchStatus(ma);
 
+    // emit a faked state change to trigger a display update of the
+    // match and an update of the player schedules
+    stat = ma.getState();
+    CentralSignalEmitter::getInstance()->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), stat, stat);
+
     bool isOkay = tg ? tg->commit() : true;
     return isOkay ? OK : DATABASE_ERROR;
   }
@@ -834,7 +841,7 @@ namespace QTournament {
       if (isfinished)
       {
         mg.setState(STAT_MG_FINISHED);
-        cse->matchGroupStatusChanged(mg.getId(), mg.getSeqNum(), STAT_MG_SCHEDULED, STAT_MG_FINISHED);
+        cse->notifyMatchGroupStatusChanged(mg.getId(), mg.getSeqNum(), STAT_MG_SCHEDULED, STAT_MG_FINISHED);
       }
     }
 
@@ -874,7 +881,7 @@ namespace QTournament {
       if (canPromote)
       {
         mg.setState(STAT_MG_IDLE);
-        cse->matchGroupStatusChanged(mg.getId(), mg.getSeqNum(), STAT_MG_FROZEN, STAT_MG_IDLE);
+        cse->notifyMatchGroupStatusChanged(mg.getId(), mg.getSeqNum(), STAT_MG_FROZEN, STAT_MG_IDLE);
       }
     }
 
@@ -921,7 +928,7 @@ namespace QTournament {
     int grpId = grp.getId();
     TabRow r = groupTab->operator [](grpId);
     r.update(MG_STAGE_SEQ_NUM, nextStageSeqNum);
-    CentralSignalEmitter::getInstance()->matchGroupStatusChanged(grp.getId(), grp.getSeqNum(), STAT_MG_IDLE, STAT_MG_STAGED);
+    CentralSignalEmitter::getInstance()->notifyMatchGroupStatusChanged(grp.getId(), grp.getSeqNum(), STAT_MG_IDLE, STAT_MG_STAGED);
 
     // promote other groups from FROZEN to IDLE, if applicable
     updateAllMatchGroupStates(grp.getCategory());
@@ -1071,7 +1078,7 @@ namespace QTournament {
 
     CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
 
-    cse->matchGroupStatusChanged(grp.getId(), grp.getSeqNum(), STAT_MG_STAGED, STAT_MG_IDLE);
+    cse->notifyMatchGroupStatusChanged(grp.getId(), grp.getSeqNum(), STAT_MG_STAGED, STAT_MG_IDLE);
 
     // update all subsequent sequence numbers
     WhereClause wc;
@@ -1080,7 +1087,7 @@ namespace QTournament {
     {
       int old = mg.getStageSequenceNumber();
       mg.row.update(MG_STAGE_SEQ_NUM, old - 1);
-      cse->matchGroupStatusChanged(mg.getId(), mg.getSeqNum(), STAT_MG_STAGED, STAT_MG_STAGED);
+      cse->notifyMatchGroupStatusChanged(mg.getId(), mg.getSeqNum(), STAT_MG_STAGED, STAT_MG_STAGED);
     }
 
     // demote other rounds from IDLE to FROZEN
@@ -1108,7 +1115,7 @@ namespace QTournament {
 
       // in all other cases, the "IDLE" group has to be demoted to FROZEN
       mg.setState(STAT_MG_FROZEN);
-      cse->matchGroupStatusChanged(mg.getId(), mg.getSeqNum(), STAT_MG_IDLE, STAT_MG_FROZEN);
+      cse->notifyMatchGroupStatusChanged(mg.getId(), mg.getSeqNum(), STAT_MG_IDLE, STAT_MG_FROZEN);
     }
 
     return OK;
@@ -1156,7 +1163,7 @@ namespace QTournament {
       {
         ma.setState(STAT_MA_WAITING);
         curState = STAT_MA_WAITING;
-        cse->matchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_INCOMPLETE, STAT_MA_WAITING);
+        cse->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_INCOMPLETE, STAT_MA_WAITING);
       }
     }
 
@@ -1175,7 +1182,7 @@ namespace QTournament {
       {
         ma.setState(STAT_MA_FUZZY);
         curState = STAT_MA_FUZZY;
-        cse->matchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_INCOMPLETE, STAT_MA_FUZZY);
+        cse->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_INCOMPLETE, STAT_MA_FUZZY);
       }
     }
 
@@ -1192,7 +1199,7 @@ namespace QTournament {
       {
         ma.setState(STAT_MA_WAITING);
         curState = STAT_MA_WAITING;
-        cse->matchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_FUZZY, STAT_MA_WAITING);
+        cse->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_FUZZY, STAT_MA_WAITING);
       }
     }
 
@@ -1204,7 +1211,7 @@ namespace QTournament {
     {
       curState = playersAvail ? STAT_MA_READY : STAT_MA_BUSY;
       ma.setState(curState);
-      cse->matchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_WAITING, curState);
+      cse->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_WAITING, curState);
     }
 
     // from READY to BUSY
@@ -1212,7 +1219,7 @@ namespace QTournament {
     {
       ma.setState(STAT_MA_BUSY);
       curState = STAT_MA_BUSY;
-      cse->matchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_READY, STAT_MA_BUSY);
+      cse->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_READY, STAT_MA_BUSY);
     }
 
     // from BUSY to READY
@@ -1220,7 +1227,7 @@ namespace QTournament {
     {
       ma.setState(STAT_MA_READY);
       curState = STAT_MA_READY;
-      cse->matchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_BUSY, STAT_MA_READY);
+      cse->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_BUSY, STAT_MA_READY);
     }
 
     // RUNNING is handled separately
@@ -1321,7 +1328,7 @@ namespace QTournament {
         // Manually trigger (another) update, because assigning the match number
         // does not change the match state in all cases. So we need to have at
         // least this one trigger to tell everone that the data has changed
-        cse->matchStatusChanged(matchId, ma.getSeqNum(), ma.getState(), ma.getState());
+        cse->notifyMatchStatusChanged(matchId, ma.getSeqNum(), ma.getState(), ma.getState());
 
         ++nextMatchNumber;
       }
@@ -1330,7 +1337,7 @@ namespace QTournament {
       mg.setState(STAT_MG_SCHEDULED);
       TabRow r = groupTab->operator [](mg.getId());
       r.updateToNull(MG_STAGE_SEQ_NUM);  // delete the sequence number
-      cse->matchGroupStatusChanged(mg.getId(), mg.getSeqNum(), STAT_MG_STAGED, STAT_MG_SCHEDULED);
+      cse->notifyMatchGroupStatusChanged(mg.getId(), mg.getSeqNum(), STAT_MG_STAGED, STAT_MG_SCHEDULED);
     }
   }
 
@@ -1417,6 +1424,40 @@ namespace QTournament {
 
   //----------------------------------------------------------------------------
 
+  unique_ptr<MatchDisplay> MatchMngr::getMatchDisplay(int matchId) const
+  {
+    return getMatchDisplayByColumnValue("id", matchId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  unique_ptr<MatchDisplay> MatchMngr::getMatchDisplayBySeqNum(int maSeqNum) const
+  {
+    return getMatchDisplayByColumnValue(GENERIC_SEQNUM_FIELD_NAME, maSeqNum);
+  }
+
+  //----------------------------------------------------------------------------
+
+  /**
+   * Returns all matches with a match number between (and including)
+   * firstMatchNum and lastMatchNum, sorted by match number.
+   *
+   * This is a single query that uses the index on the match number column.
+   */
+  MatchList MatchMngr::getMatchesByMatchNumRange(int firstMatchNum, int lastMatchNum) const
+  {
+    if ((firstMatchNum > lastMatchNum) || (lastMatchNum < 1)) return MatchList();
+
+    WhereClause wc;
+    wc.addIntCol(MA_NUM, ">=", firstMatchNum);
+    wc.addIntCol(MA_NUM, "<=", lastMatchNum);
+    wc.setOrderColumn_Asc(MA_NUM);
+
+    return getObjectsByWhereClause<Match>(tab, wc);
+  }
+
+  //----------------------------------------------------------------------------
+
   /**
    * Determines the next callable match and the next free court. Can be used for
    * automatically calling the next match, e.g., after a previous match is finished
@@ -1523,6 +1564,13 @@ namespace QTournament {
     ERR e = canAssignMatchToCourt(ma, court);
     if (e != OK) return e;
 
+    // run all updates in one transaction; this way, the
+    // status changes of the match, the players, the court etc.
+    // are propagated as one batch after the commit
+    bool isDbErr;
+    auto tg = db->acquireTransactionGuard(false, &isDbErr);
+    if (isDbErr) return DATABASE_ERROR;
+
     // NORMALLY, we should first acquire the court and then assign the
     // match to this court. BUT acquiring triggers an update of the
     // associate court views and we want the update to show the match
@@ -1572,7 +1620,7 @@ namespace QTournament {
     matchRow.update(cvc);
 
     // tell the world that the match status has changed
-    CentralSignalEmitter::getInstance()->matchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_READY, STAT_MA_RUNNING);
+    CentralSignalEmitter::getInstance()->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_READY, STAT_MA_RUNNING);
 
     // update the player's status
     PlayerMngr pm{db};
@@ -1636,7 +1684,8 @@ namespace QTournament {
       }
     }
 
-    return OK;
+    isOkay = tg ? tg->commit() : true;
+    return isOkay ? OK : DATABASE_ERROR;
   }
 
   //----------------------------------------------------------------------------
@@ -1725,8 +1774,8 @@ namespace QTournament {
     }
 
     CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
-    cse->matchResultUpdated(maId, maSeqNum);
-    cse->matchStatusChanged(maId, maSeqNum, oldState, STAT_MA_FINISHED);
+    cse->notifyMatchResultUpdated(maId, maSeqNum);
+    cse->notifyMatchStatusChanged(maId, maSeqNum, oldState, STAT_MA_FINISHED);
 
     // if this was a regular, running match we need to release the court
     // and the players
@@ -1787,6 +1836,12 @@ namespace QTournament {
       cse->roundCompleted(ma.getCategory().getId(), lastFinishedRoundAfterMatch);
     }
 
+    // the winner and loser might show up in gaps of the bracket
+    // visualization; the bracket reports can't fill them themselves
+    // because they run on read-only snapshots
+    auto bvd = BracketVisData::getExisting(cat);
+    if (bvd != nullptr) bvd->fillMissingPlayerNames();
+
     // check all matches that are currently "BUSY" because
     // due to the player release, some of them might have
     // become "READY"
@@ -1848,7 +1903,7 @@ namespace QTournament {
     TabRow matchRow = tab->operator [](maId);
     matchRow.update(MA_RESULT, newScore.toString().toUtf8().constData());
     CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
-    cse->matchResultUpdated(maId, maSeqNum);
+    cse->notifyMatchResultUpdated(maId, maSeqNum);
 
     return OK;
   }
@@ -1927,7 +1982,7 @@ namespace QTournament {
     int maId = ma.getId();
     TabRow matchRow = tab->operator [](maId);
     matchRow.update(cvc);
-    CentralSignalEmitter::getInstance()->matchStatusChanged(maId, ma.getSeqNum(), STAT_MA_RUNNING, STAT_MA_READY);
+    CentralSignalEmitter::getInstance()->notifyMatchStatusChanged(maId, ma.getSeqNum(), STAT_MA_RUNNING, STAT_MA_READY);
 
     // release the court
     CourtMngr cm{db};
@@ -1999,21 +2054,16 @@ namespace QTournament {
 
   tuple<int, int, int, int> MatchMngr::getMatchStats() const
   {
-    // get the total number of matches
-    int nTotal = tab->length();
-
-    // get the number of currently running matches
-    int nRunning = tab->getMatchCountForColumnValue(GENERIC_STATE_FIELD_NAME, static_cast<int>(STAT_MA_RUNNING));
-
-    // get the number of finished matches
-    int nFinished = tab->getMatchCountForColumnValue(GENERIC_STATE_FIELD_NAME, static_cast<int>(STAT_MA_FINISHED));
+    MatchCounters mc = db->getMatchCounterCache()->getTournamentCounters();
+    return make_tuple(mc.total, mc.scheduled, mc.running, mc.finished);
+  }
 
-    // get the number of scheduled matches
-    WhereClause wc;
-    wc.addIntCol(MA_NUM, ">", 0);
-    int nScheduled = tab->getMatchCountForWhereClause(wc) - nRunning - nFinished;
+  //----------------------------------------------------------------------------
 
-    return make_tuple(nTotal, nScheduled, nRunning, nFinished);
+  tuple<int, int, int, int> MatchMngr::getMatchStatsForCategory(const Category& cat) const
+  {
+    MatchCounters mc = db->getMatchCounterCache()->getCategoryCounters(cat.getId());
+    return make_tuple(mc.total, mc.scheduled, mc.running, mc.finished);
   }
 
   //----------------------------------------------------------------------------
@@ -2042,7 +2092,7 @@ namespace QTournament {
           if (p.getId() == playerId)
           {
             ma.row.update(GENERIC_STATE_FIELD_NAME, static_cast<int>(STAT_MA_BUSY));
-            cse->matchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_READY, STAT_MA_BUSY);
+            cse->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_READY, STAT_MA_BUSY);
             break;  // no need to check other players for this match
           }
         }
@@ -2058,7 +2108,7 @@ namespace QTournament {
         if (pm.canAcquirePlayerPairsForMatch(ma) == OK)
         {
           ma.row.update(GENERIC_STATE_FIELD_NAME, static_cast<int>(STAT_MA_READY));
-          cse->matchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_BUSY, STAT_MA_READY);
+          cse->notifyMatchStatusChanged(ma.getId(), ma.getSeqNum(), STAT_MA_BUSY, STAT_MA_READY);
         }
       }
     }
@@ -2172,7 +2222,7 @@ namespace QTournament {
 
         // emit a faked state change to trigger a display update of the
         // match in the match tab view
-        cse->matchStatusChanged(m.getId(), m.getSeqNum(), stat, stat);
+        cse->notifyMatchStatusChanged(m.getId(), m.getSeqNum(), stat, stat);
       }
       // find all matches that use the winner of this match as player 2
       // and resolve their symbolic references
@@ -2188,7 +2238,7 @@ namespace QTournament {
 
         // emit a faked state change to trigger a display update of the
         // match in the match tab view
-        cse->matchStatusChanged(m.getId(), m.getSeqNum(), stat, stat);
+        cse->notifyMatchStatusChanged(m.getId(), m.getSeqNum(), stat, stat);
       }
     }
 
@@ -2208,7 +2258,7 @@ namespace QTournament {
 
         // emit a faked state change to trigger a display update of the
         // match in the match tab view
-        cse->matchStatusChanged(m.getId(), m.getSeqNum(), stat, stat);
+        cse->notifyMatchStatusChanged(m.getId(), m.getSeqNum(), stat, stat);
       }
       // find all matches that use the loser of this match as player 2
       // and resolve their symbolic references
@@ -2224,7 +2274,7 @@ namespace QTournament {
 
         // emit a faked state change to trigger a display update of the
         // match in the match tab view
-        cse->matchStatusChanged(m.getId(), m.getSeqNum(), stat, stat);
+        cse->notifyMatchStatusChanged(m.getId(), m.getSeqNum(), stat, stat);
       }
     }
 
@@ -2264,5 +2314,28 @@ namespace QTournament {
 
   //----------------------------------------------------------------------------
 
+  unique_ptr<MatchDisplay> MatchMngr::getMatchDisplayByColumnValue(const char* colName, int val) const
+  {
+    auto r = db->getTab(TAB_MATCH_DISPLAY)->getSingleRowByColumnValue2(colName, val);
+    if (r == nullptr) return nullptr;
+
+    auto result = make_unique<MatchDisplay>(MatchDisplay::fromRow(*r));
+    if (result->refereeMode == REFEREE_MODE::USE_DEFAULT)
+    {
+      result->refereeMode = getTournamentDefaultRefereeMode();
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  REFEREE_MODE MatchMngr::getTournamentDefaultRefereeMode() const
+  {
+    auto cfg = KeyValueTab::getTab(db, TAB_CFG, false);
+    return static_cast<REFEREE_MODE>(cfg->getInt(CFG_KEY_DEFAULT_REFEREE_MODE));
+  }
+
+  //----------------------------------------------------------------------------
 
 }
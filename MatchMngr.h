@@ -34,6 +34,7 @@
 #include "Match.h"
 #include "Court.h"
 #include "Score.h"
+#include "MatchDisplay.h"
 
 using namespace SqliteOverlay;
 
@@ -64,8 +65,14 @@ namespace QTournament
     unique_ptr<Match> getMatchForPlayerPairAndRound(const PlayerPair& pp, int round) const;
     unique_ptr<Match> getMatchBySeqNum(int maSeqNum) const;
     unique_ptr<Match> getMatchByMatchNum(int maNum) const;
+    MatchList getMatchesByMatchNumRange(int firstMatchNum, int lastMatchNum) const;   // sorted by match number
     unique_ptr<Match> getMatch(int id) const;
-    tuple<int, int, int, int> getMatchStats() const;
+    tuple<int, int, int, int> getMatchStats() const;   // total, scheduled, running, finished
+    tuple<int, int, int, int> getMatchStatsForCategory(const Category& cat) const;
+
+    // retrievers for the materialized match display data
+    unique_ptr<MatchDisplay> getMatchDisplay(int matchId) const;
+    unique_ptr<MatchDisplay> getMatchDisplayBySeqNum(int maSeqNum) const;
 
     // boolean hasXXXXX functions for MATCHES
     bool hasMatchesInCategory(const Category& cat, int round=-1) const;
@@ -126,6 +133,8 @@ namespace QTournament
 
   private:
     DbTab* groupTab;
+    unique_ptr<MatchDisplay> getMatchDisplayByColumnValue(const char* colName, int val) const;
+    REFEREE_MODE getTournamentDefaultRefereeMode() const;
     void updateAllMatchGroupStates(const Category& cat) const;
     bool hasUnfinishedMandatoryPredecessor(const Match& ma) const;
     void resolveSymbolicNamesAfterFinishedMatch(const Match& ma) const;
@@ -50,6 +50,16 @@ namespace QTournament
   {
     QString first = QString::fromUtf8(row[PL_FNAME].data());
     QString last = QString::fromUtf8(row[PL_LNAME].data());
+
+    return getDisplayName(first, last, maxLen);
+  }
+
+//----------------------------------------------------------------------------
+
+  QString Player::getDisplayName(const QString& _first, const QString& _last, int maxLen)
+  {
+    QString first = _first;
+    QString last = _last;
     
     QString fullName = last + ", " + first;
     
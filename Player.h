@@ -49,6 +49,7 @@ namespace QTournament
     
   public:
     QString getDisplayName(int maxLen = 0) const;
+    static QString getDisplayName(const QString& first, const QString& last, int maxLen = 0);
     QString getDisplayName_FirstNameFirst() const;
     QString getFirstName() const;
     QString getLastName() const;
@@ -23,6 +23,7 @@
 #include <QFile>
 
 #include "PlayerMngr.h"
+#include "PlayerScheduleIndex.h"
 #include "Player.h"
 #include "TournamentErrorCodes.h"
 #include "TournamentDataDefs.h"
@@ -321,7 +322,7 @@ namespace QTournament
       OBJ_STATE oldStat = p.getState();
       TabRow r = tab->operator [](p.getId());
       r.update(GENERIC_STATE_FIELD_NAME, static_cast<int>(STAT_PL_PLAYING));
-      CentralSignalEmitter::getInstance()->playerStatusChanged(p.getId(), p.getSeqNum(), oldStat, STAT_PL_PLAYING);
+      CentralSignalEmitter::getInstance()->notifyPlayerStatusChanged(p.getId(), p.getSeqNum(), oldStat, STAT_PL_PLAYING);
     }
 
     return OK;
@@ -340,7 +341,7 @@ namespace QTournament
       int dbErr;
       r.update(GENERIC_STATE_FIELD_NAME, static_cast<int>(STAT_PL_IDLE), &dbErr);
       if (dbErr != SQLITE_DONE) return DATABASE_ERROR;
-      CentralSignalEmitter::getInstance()->playerStatusChanged(p.getId(), p.getSeqNum(), STAT_PL_PLAYING, STAT_PL_IDLE);
+      CentralSignalEmitter::getInstance()->notifyPlayerStatusChanged(p.getId(), p.getSeqNum(), STAT_PL_PLAYING, STAT_PL_IDLE);
     }
 
     return OK;
@@ -437,7 +438,7 @@ namespace QTournament
 
       // switch to IDLE
       p.setState(STAT_PL_IDLE);
-      cse->playerStatusChanged(p.getId(), p.getSeqNum(), STAT_PL_WAIT_FOR_REGISTRATION, STAT_PL_IDLE);
+      cse->notifyPlayerStatusChanged(p.getId(), p.getSeqNum(), STAT_PL_WAIT_FOR_REGISTRATION, STAT_PL_IDLE);
       return OK;
     }
 
@@ -465,7 +466,7 @@ namespace QTournament
 
     // all checks passed ==> we can switch the player to "wait for registration"
     p.setState(STAT_PL_WAIT_FOR_REGISTRATION);
-    cse->playerStatusChanged(p.getId(), p.getSeqNum(), STAT_PL_IDLE, STAT_PL_WAIT_FOR_REGISTRATION);
+    cse->notifyPlayerStatusChanged(p.getId(), p.getSeqNum(), STAT_PL_IDLE, STAT_PL_WAIT_FOR_REGISTRATION);
 
     return OK;
   }
@@ -921,60 +922,21 @@ namespace QTournament
   {
     vector<Match> result;
 
-    // get all scheduled matches
-    QString where = "%1 > 0 AND %2 != %3 AND %2 != %4 ORDER BY %5 ASC";
-    where = where.arg(MA_NUM);
-    where = where.arg(GENERIC_STATE_FIELD_NAME);
-    where = where.arg(static_cast<int>(STAT_MA_RUNNING));
-    where = where.arg(static_cast<int>(STAT_MA_FINISHED));
-    where = where.arg(MA_NUM);
-
-    DbTab* matchTab = db->getTab(TAB_MATCH);
+    // the schedule is already sorted by match number, so
+    // we only need to pick the matches that are scheduled
+    // but not yet running or finished
     MatchMngr mm{db};
-    for (const Match& ma : getObjectsByWhereClause<Match>(matchTab, where.toUtf8().constData()))
+    for (const ScheduleEntry& se : db->getPlayerScheduleIndex()->getScheduleForPlayer(p.getId()))
     {
-      if (ma.hasPlayerPair1())
-      {
-        PlayerPair pp = ma.getPlayerPair1();
-        if (pp.getPlayer1() == p)
-        {
-          result.push_back(ma);
-          continue;
-        }
-
-        if (pp.hasPlayer2())
-        {
-          if (pp.getPlayer2() == p)
-          {
-            result.push_back(ma);
-            continue;
-          }
-        }
-      }
-
-      if (ma.hasPlayerPair2())
-      {
-        PlayerPair pp = ma.getPlayerPair2();
-        if (pp.getPlayer1() == p)
-        {
-          result.push_back(ma);
-          continue;
-        }
+      if ((se.roleFlags & SCHEDULE_ROLE_PAIR_MEMBER) == 0) continue;
+      if (se.matchNum <= 0) continue;
+      if ((se.state == STAT_MA_RUNNING) || (se.state == STAT_MA_FINISHED)) continue;
 
-        if (pp.hasPlayer2())
-        {
-          if (pp.getPlayer2() == p)
-          {
-            result.push_back(ma);
-            continue;
-          }
-        }
-      }
+      auto ma = mm.getMatch(se.matchId);
+      if (ma == nullptr) continue;
+      result.push_back(*ma);
 
-      // stop the loop if we only need one match
-      // (okay, since we use "continue" above, we make at least one
-      // extra cycle after the first match before we hit this "if")
-      if (findFirstOnly && (!(result.empty()))) return result;
+      if (findFirstOnly) break;
     }
 
     return result;
@@ -37,8 +37,7 @@ namespace QTournament
       finishCount{0}, walkoverCount{0}, scheduledCount{0},
       umpireFinishedCount{0}
   {
-    initMatchLists();
-    initMatchIds();
+    initFromSchedule();
   }
 
   //----------------------------------------------------------------------------
@@ -85,77 +84,71 @@ namespace QTournament
 
   //----------------------------------------------------------------------------
 
-  void PlayerProfile::initMatchIds()
+  void PlayerProfile::initFromSchedule()
   {
-    MatchMngr mm{db};
-
-    // loop over all umpire matches and find the next scheduled match,
-    // the currently running match and the last finished match
-    QDateTime lastFinishTime;
+    // a single pass over the player's schedule yields the
+    // match lists, all counters and the last / current / next
+    // match. The schedule is already sorted by match number.
+    PlayerScheduleIndex* psi = db->getPlayerScheduleIndex();
+    time_t lastFinishTime = 0;
+    time_t lastUmpireFinishTime = 0;
     int nextMatchNum = -1;
-    for (const Match& ma : matchesAsUmpire)
+    int nextUmpireMatchNum = -1;
+    for (const ScheduleEntry& se : psi->getScheduleForPlayer(p.getId()))
     {
-      OBJ_STATE stat = ma.getState();
-
-      if (stat == STAT_MA_FINISHED) ++umpireFinishedCount;
-
-      if (ma.getState() == STAT_MA_RUNNING)
+      //
+      // matches as UMPIRE
+      //
+      if (se.isUmpire())
       {
-        currentUmpireMatchId = ma.getId();
-        continue;
-      }
+        scheduleAsUmpire.push_back(se);
 
-      if (stat == STAT_MA_FINISHED)
-      {
-        QDateTime fTime = ma.getFinishTime();
-        if (fTime.isValid())
+        if (se.state == STAT_MA_RUNNING)
         {
-          if ((!(lastFinishTime.isValid())) || (fTime > lastFinishTime))  // this does not include walkovers
+          currentUmpireMatchId = se.matchId;
+        }
+        else if (se.state == STAT_MA_FINISHED)
+        {
+          ++umpireFinishedCount;
+
+          // a finish time of zero indicates a walkover
+          if (se.finishTime__UTC > lastUmpireFinishTime)
           {
-            lastFinishTime = fTime;
-            lastUmpireMatchId = ma.getId();
-            continue;
+            lastUmpireFinishTime = se.finishTime__UTC;
+            lastUmpireMatchId = se.matchId;
           }
         }
+        else if ((se.matchNum != MATCH_NUM_NOT_ASSIGNED) && ((se.matchNum < nextUmpireMatchNum) || (nextUmpireMatchNum < 0)))
+        {
+          nextUmpireMatchNum = se.matchNum;
+          nextUmpireMatchId = se.matchId;
+        }
       }
 
-      int maNum = ma.getMatchNumber();
-      if ((maNum != MATCH_NUM_NOT_ASSIGNED) && ((maNum < nextMatchNum) || (nextMatchNum < 0)))
-      {
-        nextMatchNum = maNum;
-        nextUmpireMatchId = ma.getId();
-      }
-    }
-
-
-    // loop over all player matches and find the next scheduled match,
-    // the currently running match and the last finished match
-    lastFinishTime = QDateTime{};   // set to "invalid"
-    nextMatchNum = -1;
-    for (const Match& ma : matchesAsPlayer)
-    {
-      OBJ_STATE stat = ma.getState();
-      int maNum = ma.getMatchNumber();
+      //
+      // matches as PLAYER
+      //
+      if (!(se.isPlayer())) continue;
+      scheduleAsPlayer.push_back(se);
 
       // count all scheduled matches
-      if (maNum != MATCH_NUM_NOT_ASSIGNED) ++scheduledCount;
+      if (se.matchNum != MATCH_NUM_NOT_ASSIGNED) ++scheduledCount;
 
-      if (stat == STAT_MA_RUNNING)
+      if (se.state == STAT_MA_RUNNING)
       {
-        currentMatchId = ma.getId();
+        currentMatchId = se.matchId;
         continue;
       }
 
-      if (stat == STAT_MA_FINISHED)
+      if (se.state == STAT_MA_FINISHED)
       {
         ++finishCount;
-        QDateTime fTime = ma.getFinishTime();
-        if (fTime.isValid())
+        if (se.finishTime__UTC > 0)
         {
-          if ((!(lastFinishTime.isValid())) || (fTime > lastFinishTime))
+          if (se.finishTime__UTC > lastFinishTime)
           {
-            lastFinishTime = fTime;
-            lastPlayedMatchId = ma.getId();
+            lastFinishTime = se.finishTime__UTC;
+            lastPlayedMatchId = se.matchId;
           }
         } else {
           // invalid finish time indicates a walkover
@@ -164,118 +157,39 @@ namespace QTournament
         continue;
       }
 
-      if ((maNum != MATCH_NUM_NOT_ASSIGNED) && ((maNum < nextMatchNum) || (nextMatchNum < 0)))
+      if ((se.matchNum != MATCH_NUM_NOT_ASSIGNED) && ((se.matchNum < nextMatchNum) || (nextMatchNum < 0)))
       {
-        nextMatchNum = maNum;
-        nextMatchId = ma.getId();
+        nextMatchNum = se.matchNum;
+        nextMatchId = se.matchId;
       }
     }
   }
 
   //----------------------------------------------------------------------------
 
-  void PlayerProfile::initMatchLists()
+  unique_ptr<Match> PlayerProfile::returnMatchOrNullptr(int maId) const
   {
-    //
-    // find all matches involving the participant as a PLAYER
-    //
-
-    // step 1: search via PlayerPairs
-    QString where = "%1=%2 OR %3=%2";
-    where = where.arg(PAIRS_PLAYER1_REF);
-    where = where.arg(p.getId());
-    where = where.arg(PAIRS_PLAYER2_REF);
-    DbTab* pairsTab = db->getTab(TAB_PAIRS);
-    auto it = pairsTab->getRowsByWhereClause(where.toUtf8().constData());
-    vector<int> matchIdList;
-
-    DbTab* matchTab = db->getTab(TAB_MATCH);
-    MatchMngr mm{db};
-    while (!(it.isEnd()))
-    {
-      TabRow r = *it;
-      int ppId = r.getId();
-
-      // search for all matches involving this player pair
-      where = "%1=%2 OR %3=%2";
-      where = where.arg(MA_PAIR1_REF);
-      where = where.arg(ppId);
-      where = where.arg(MA_PAIR2_REF);
-      auto matchIt = matchTab->getRowsByWhereClause(where.toUtf8().constData());
-      while (!(matchIt.isEnd()))
-      {
-        int maId = (*matchIt).getId();
-
-        if (!(Sloppy::isInVector<int>(matchIdList, maId))) matchIdList.push_back(maId);
-
-        ++matchIt;
-      }
-
-      ++it;
-    }
-
-    // step 2: search via ACTUAL_PLAYER
-    where = "%1=%2 OR %3=%2 OR %4=%2 OR %5=%2";
-    where = where.arg(MA_ACTUAL_PLAYER1A_REF);
-    where = where.arg(p.getId());
-    where = where.arg(MA_ACTUAL_PLAYER1B_REF);
-    where = where.arg(MA_ACTUAL_PLAYER2A_REF);
-    where = where.arg(MA_ACTUAL_PLAYER2B_REF);
-    it = matchTab->getRowsByWhereClause(where.toUtf8().constData());
-    while (!(it.isEnd()))
-    {
-      int maId = (*it).getId();
-
-      if (!(Sloppy::isInVector<int>(matchIdList, maId))) matchIdList.push_back(maId);
-
-      ++it;
-    }
-
-    // copy the results to the matchesAsPlayer-list
-    for (int maId : matchIdList)
-    {
-      auto ma = mm.getMatch(maId);
-      matchesAsPlayer.push_back(*ma);
-    }
-
-    // sort by match number
-    std::sort(matchesAsPlayer.begin(), matchesAsPlayer.end(), [](const Match& ma1, const Match& ma2)
-    {
-      return ma1.getMatchNumber() < ma2.getMatchNumber();
-    });
-
-
-    //
-    // find all matches involving the participant as an UMPIRE
-    //
-    matchIdList.clear();
-    it = matchTab->getRowsByColumnValue(MA_REFEREE_REF, p.getId());
-    while (!(it.isEnd()))
-    {
-      int maId = (*it).getId();
-
-      auto ma = mm.getMatch(maId);
-      matchesAsUmpire.push_back(*ma);
-
-      ++it;
-    }
-
-    // sort by match number
-    std::sort(matchesAsUmpire.begin(), matchesAsUmpire.end(), [](const Match& ma1, const Match& ma2)
-    {
-      return ma1.getMatchNumber() < ma2.getMatchNumber();
-    });
+    if (maId < 1) return nullptr;
 
+    MatchMngr mm{db};
+    return mm.getMatch(maId);
   }
 
   //----------------------------------------------------------------------------
 
-  unique_ptr<Match> PlayerProfile::returnMatchOrNullptr(int maId) const
+  QList<Match> PlayerProfile::schedule2MatchList(const PlayerSchedule& sched) const
   {
-    if (maId < 1) return nullptr;
-
+    // the match objects are only created on request,
+    // e.g. for filling the tables in the profile dialog
     MatchMngr mm{db};
-    return mm.getMatch(maId);
+    QList<Match> result;
+    for (const ScheduleEntry& se : sched)
+    {
+      auto ma = mm.getMatch(se.matchId);
+      if (ma != nullptr) result.push_back(*ma);
+    }
+
+    return result;
   }
 
   //----------------------------------------------------------------------------
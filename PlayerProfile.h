@@ -25,6 +25,7 @@
 
 #include "TournamentDB.h"
 #include "Match.h"
+#include "PlayerScheduleIndex.h"
 
 using namespace std;
 using namespace SqliteOverlay;
@@ -46,18 +47,18 @@ namespace QTournament
     unique_ptr<Match> getCurrentUmpireMatch() const;
     unique_ptr<Match> getNextUmpireMatch() const;
 
-    QList<Match> getMatchesAsPlayer() const { return matchesAsPlayer; }
-    QList<Match> getMatchesAsUmpire() const { return matchesAsUmpire; }
+    QList<Match> getMatchesAsPlayer() const { return schedule2MatchList(scheduleAsPlayer); }
+    QList<Match> getMatchesAsUmpire() const { return schedule2MatchList(scheduleAsUmpire); }
 
     int getWalkoverCount() const { return walkoverCount; }
     int getFinishCount() const { return finishCount; }  // includes walkovers
     int getActuallyPlayedCount() const { return (finishCount - walkoverCount); }
     int getScheduledMatchesCount() const { return scheduledCount; }
-    int getYetToBePlayedCount() const { return (matchesAsPlayer.length() - finishCount); }
+    int getYetToBePlayedCount() const { return (static_cast<int>(scheduleAsPlayer.size()) - finishCount); }
     int getScheduledAndNotFinishedCount() const { return (scheduledCount - finishCount); }
-    int getOthersCount() const { return (matchesAsPlayer.length() - scheduledCount); }
+    int getOthersCount() const { return (static_cast<int>(scheduleAsPlayer.size()) - scheduledCount); }
     int getUmpireFinishedCount() const { return umpireFinishedCount; }
-    int getUmpireScheduledAndNotFinishedCount() const { return (matchesAsUmpire.length() - umpireFinishedCount); }
+    int getUmpireScheduledAndNotFinishedCount() const { return (static_cast<int>(scheduleAsUmpire.size()) - umpireFinishedCount); }
 
   protected:
     TournamentDB* db;
@@ -74,13 +75,13 @@ namespace QTournament
     int scheduledCount;
     int umpireFinishedCount;
 
-    QList<Match> matchesAsPlayer;
-    QList<Match> matchesAsUmpire;
+    PlayerSchedule scheduleAsPlayer;
+    PlayerSchedule scheduleAsUmpire;
 
-    void initMatchIds();
-    void initMatchLists();
+    void initFromSchedule();
 
     unique_ptr<Match> returnMatchOrNullptr(int maId) const;
+    QList<Match> schedule2MatchList(const PlayerSchedule& sched) const;
   };
 
 }
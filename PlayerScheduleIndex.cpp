@@ -0,0 +1,287 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "PlayerScheduleIndex.h"
+#include "CentralSignalEmitter.h"
+
+using namespace SqliteOverlay;
+
+namespace QTournament
+{
+
+  PlayerScheduleIndex::PlayerScheduleIndex(TournamentDB* _db)
+    :QObject(), db(_db), matchTab(db->getTab(TAB_MATCH)), pairTab(db->getTab(TAB_PAIRS)),
+      needsRebuild(true)
+  {
+    // private copies of the database don't emit any signals
+    // and might be used in another thread; the database
+    // takes care of invalidating the cache in this case
+    if (db->getConnectionRole() != ConnectionRole::Primary) return;
+
+    CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
+
+    // all changes to a match that are relevant for us (match number,
+    // state, actual players, umpire, ...) come along with a
+    // real or faked change of the match state; the unbatched
+    // signal keeps us in sync within running transactions
+    connect(cse, SIGNAL(matchStatusRecorded(int,int,OBJ_STATE,OBJ_STATE)), this, SLOT(onMatchStatusChanged(int,int,OBJ_STATE,OBJ_STATE)), Qt::DirectConnection);
+
+    // structural changes trigger a complete rebuild
+    connect(cse, SIGNAL(endCreateMatch(int)), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(categoryStatusChanged(Category,OBJ_STATE,OBJ_STATE)), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(playersPaired(Category,Player,Player)), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(playersSplit(Category,Player,Player)), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(endDeleteCategory()), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(endDeletePlayer()), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(endResetAllModels()), this, SLOT(invalidate()), Qt::DirectConnection);
+
+    // a rollback might have reverted changes that we've already read
+    connect(cse, SIGNAL(statusChangeBatchDiscarded()), this, SLOT(invalidate()), Qt::DirectConnection);
+
+    // the committed row feed also catches modifications that
+    // haven't been announced by any of the signals above
+    connect(cse, SIGNAL(rowChangesCommitted(RowChangeSet)), this, SLOT(onRowChangesCommitted(RowChangeSet)), Qt::DirectConnection);
+  }
+
+  //----------------------------------------------------------------------------
+
+  PlayerSchedule PlayerScheduleIndex::getScheduleForPlayer(int playerId)
+  {
+    syncIfNecessary();
+
+    PlayerSchedule result;
+    auto it = player2MatchIds.find(playerId);
+    if (it == player2MatchIds.end()) return result;
+
+    result.reserve(it->second.size());
+    for (int maId : it->second)
+    {
+      const MatchInfo& mi = matches.at(maId);
+      result.push_back(ScheduleEntry{maId, mi.matchNum, mi.state, mi.finishTime__UTC, mi.playerId2RoleFlags.at(playerId)});
+    }
+
+    std::sort(result.begin(), result.end(), [](const ScheduleEntry& e1, const ScheduleEntry& e2) {
+      if (e1.matchNum != e2.matchNum) return (e1.matchNum < e2.matchNum);
+      return (e1.matchId < e2.matchId);
+    });
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  unordered_map<int, int> PlayerScheduleIndex::getNextMatchNumbers()
+  {
+    syncIfNecessary();
+
+    unordered_map<int, int> result;
+    for (const auto& maEntry : matches)
+    {
+      const MatchInfo& mi = maEntry.second;
+      if (mi.matchNum <= 0) continue;
+      if ((mi.state == STAT_MA_RUNNING) || (mi.state == STAT_MA_FINISHED)) continue;
+
+      for (const auto& plEntry : mi.playerId2RoleFlags)
+      {
+        if ((plEntry.second & SCHEDULE_ROLE_PAIR_MEMBER) == 0) continue;
+
+        auto it = result.find(plEntry.first);
+        if ((it == result.end()) || (mi.matchNum < it->second)) result[plEntry.first] = mi.matchNum;
+      }
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void PlayerScheduleIndex::onMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState)
+  {
+    dirtyMatches.insert(matchId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void PlayerScheduleIndex::onRowChangesCommitted(const RowChangeSet& changes)
+  {
+    if (!(changes.isComplete))
+    {
+      invalidate();
+      return;
+    }
+
+    for (const RowChange& rc : changes.changes)
+    {
+      // re-reading a match also covers new and deleted matches
+      if (rc.tabName == TAB_MATCH)
+      {
+        dirtyMatches.insert(rc.rowId);
+        continue;
+      }
+
+      // modified pairs affect all of their matches
+      if (rc.tabName == TAB_PAIRS)
+      {
+        invalidate();
+        return;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void PlayerScheduleIndex::invalidate()
+  {
+    needsRebuild = true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void PlayerScheduleIndex::syncIfNecessary()
+  {
+    if (needsRebuild)
+    {
+      rebuild();
+      return;
+    }
+
+    for (int maId : dirtyMatches)
+    {
+      removeMatch(maId);
+
+      auto r = matchTab->getSingleRowByColumnValue2("id", maId);
+      if (r != nullptr) readMatchRow(*r);
+    }
+    dirtyMatches.clear();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void PlayerScheduleIndex::rebuild()
+  {
+    matches.clear();
+    player2MatchIds.clear();
+    pairId2PlayerIds.clear();
+    dirtyMatches.clear();
+
+    // pass 1: all player pairs
+    auto it = pairTab->getRowsByWhereClause("id > 0");
+    while (!(it.isEnd()))
+    {
+      TabRow r = *it;
+      auto p2 = r.getInt2(PAIRS_PLAYER2_REF);
+      pairId2PlayerIds[r.getId()] = make_pair(r.getInt(PAIRS_PLAYER1_REF), p2->isNull() ? -1 : p2->get());
+
+      ++it;
+    }
+
+    // pass 2: all matches
+    it = matchTab->getRowsByWhereClause("id > 0");
+    while (!(it.isEnd()))
+    {
+      readMatchRow(*it);
+      ++it;
+    }
+
+    needsRebuild = false;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void PlayerScheduleIndex::readMatchRow(const TabRow& r)
+  {
+    int maId = r.getId();
+
+    MatchInfo mi;
+    auto maNum = r.getInt2(MA_NUM);
+    mi.matchNum = maNum->isNull() ? MATCH_NUM_NOT_ASSIGNED : maNum->get();
+    mi.state = static_cast<OBJ_STATE>(r.getInt(GENERIC_STATE_FIELD_NAME));
+    auto finishTime = r.getInt2(MA_FINISH_TIME);
+    mi.finishTime__UTC = finishTime->isNull() ? 0 : finishTime->get();
+
+    // members of the assigned player pairs
+    for (const char* colName : {MA_PAIR1_REF, MA_PAIR2_REF})
+    {
+      auto ppRef = r.getInt2(colName);
+      if (ppRef->isNull()) continue;
+
+      pair<int, int> ids = getPlayerIdsForPair(ppRef->get());
+      if (ids.first > 0) mi.playerId2RoleFlags[ids.first] |= SCHEDULE_ROLE_PAIR_MEMBER;
+      if (ids.second > 0) mi.playerId2RoleFlags[ids.second] |= SCHEDULE_ROLE_PAIR_MEMBER;
+    }
+
+    // the actual players, in case the pairs have been modified
+    // after the match has been called
+    for (const char* colName : {MA_ACTUAL_PLAYER1A_REF, MA_ACTUAL_PLAYER1B_REF, MA_ACTUAL_PLAYER2A_REF, MA_ACTUAL_PLAYER2B_REF})
+    {
+      auto pRef = r.getInt2(colName);
+      if (pRef->isNull()) continue;
+      mi.playerId2RoleFlags[pRef->get()] |= SCHEDULE_ROLE_ACTUAL_PLAYER;
+    }
+
+    // the umpire
+    auto refereeRef = r.getInt2(MA_REFEREE_REF);
+    if (!(refereeRef->isNull()))
+    {
+      mi.playerId2RoleFlags[refereeRef->get()] |= SCHEDULE_ROLE_UMPIRE;
+    }
+
+    for (const auto& pr : mi.playerId2RoleFlags)
+    {
+      player2MatchIds[pr.first].insert(maId);
+    }
+    matches[maId] = std::move(mi);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void PlayerScheduleIndex::removeMatch(int matchId)
+  {
+    auto it = matches.find(matchId);
+    if (it == matches.end()) return;
+
+    for (const auto& pr : it->second.playerId2RoleFlags)
+    {
+      player2MatchIds[pr.first].erase(matchId);
+    }
+    matches.erase(it);
+  }
+
+  //----------------------------------------------------------------------------
+
+  pair<int, int> PlayerScheduleIndex::getPlayerIdsForPair(int pairId)
+  {
+    auto it = pairId2PlayerIds.find(pairId);
+    if (it != pairId2PlayerIds.end()) return it->second;
+
+    // the pair has been created after the last rebuild
+    auto r = pairTab->getSingleRowByColumnValue2("id", pairId);
+    if (r == nullptr) return make_pair(-1, -1);
+
+    auto p2 = r->getInt2(PAIRS_PLAYER2_REF);
+    pair<int, int> result = make_pair(r->getInt(PAIRS_PLAYER1_REF), p2->isNull() ? -1 : p2->get());
+    pairId2PlayerIds[pairId] = result;
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+}
@@ -0,0 +1,122 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLAYERSCHEDULEINDEX_H
+#define PLAYERSCHEDULEINDEX_H
+
+#include <ctime>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <QObject>
+
+#include <SqliteOverlay/DbTab.h>
+#include <SqliteOverlay/TabRow.h>
+
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  // the role(s) of a player in a match; a player
+  // can have more than one role in the same match
+  // (e.g., listed in a pair and actually playing)
+  static constexpr int SCHEDULE_ROLE_PAIR_MEMBER = 1;     // member of one of the match's player pairs
+  static constexpr int SCHEDULE_ROLE_ACTUAL_PLAYER = 2;   // recorded as actual player when the match was called
+  static constexpr int SCHEDULE_ROLE_UMPIRE = 4;
+
+  struct ScheduleEntry
+  {
+    int matchId;
+    int matchNum;   // MATCH_NUM_NOT_ASSIGNED if not yet scheduled
+    OBJ_STATE state;
+    time_t finishTime__UTC;   // 0 if not finished or if finished by walkover
+    int roleFlags;
+
+    bool isPlayer() const { return ((roleFlags & (SCHEDULE_ROLE_PAIR_MEMBER | SCHEDULE_ROLE_ACTUAL_PLAYER)) != 0); }
+    bool isUmpire() const { return ((roleFlags & SCHEDULE_ROLE_UMPIRE) != 0); }
+  };
+
+  using PlayerSchedule = vector<ScheduleEntry>;
+
+  //----------------------------------------------------------------------------
+
+  /*
+   * Maps each player to all matches the player is involved in,
+   * either as a player or as an umpire.
+   *
+   * The index is built with one pass over the pair table and one
+   * pass over the match table. Afterwards, it's kept in sync by
+   * re-reading only those matches for which we've received a
+   * matchStatusRecorded() signal or a committed row change.
+   * Structural changes (new matches, new pairs, category changes)
+   * and rollbacks trigger a lazy rebuild.
+   */
+  class PlayerScheduleIndex : public QObject
+  {
+    Q_OBJECT
+
+  public:
+    // ctor
+    PlayerScheduleIndex(TournamentDB* _db);
+
+    // getters
+    PlayerSchedule getScheduleForPlayer(int playerId);   // sorted by match number
+
+    // the number of the next scheduled match for each player that
+    // has one; same criteria as PlayerMngr::getNextMatchForPlayer()
+    unordered_map<int, int> getNextMatchNumbers();
+
+  public slots:
+    void onMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState);
+    void onRowChangesCommitted(const RowChangeSet& changes);
+    void invalidate();
+
+  private:
+    struct MatchInfo
+    {
+      int matchNum;
+      OBJ_STATE state;
+      time_t finishTime__UTC;
+      unordered_map<int, int> playerId2RoleFlags;
+    };
+
+    TournamentDB* db;
+    SqliteOverlay::DbTab* matchTab;
+    SqliteOverlay::DbTab* pairTab;
+    bool needsRebuild;
+
+    unordered_map<int, MatchInfo> matches;
+    unordered_map<int, unordered_set<int>> player2MatchIds;
+    unordered_map<int, pair<int, int>> pairId2PlayerIds;   // second player is -1 for singles
+
+    unordered_set<int> dirtyMatches;
+
+    void syncIfNecessary();
+    void rebuild();
+    void readMatchRow(const SqliteOverlay::TabRow& r);
+    void removeMatch(int matchId);
+    pair<int, int> getPlayerIdsForPair(int pairId);
+  };
+
+}
+
+#endif // PLAYERSCHEDULEINDEX_H
@@ -28,6 +28,10 @@ win32 {
 # linking against BOOST fails if this is not set
 DEFINES += "BOOST_LOG_DYN_LINK=1"
 
+# required for the declaration of SQLite's session extension (change journal);
+# the linked SQLite library must have been built with these flags, too
+DEFINES += SQLITE_ENABLE_SESSION SQLITE_ENABLE_PREUPDATE_HOOK
+
 HEADERS += \
     Category.h \
     CatMngr.h \
@@ -150,7 +154,22 @@ HEADERS += \
     ui/DlgImportCSV_Step1.h \
     ui/DlgImportCSV_Step2.h \
     ui/DlgPickTeam.h \
-    ui/DlgPickCategory.h
+    ui/DlgPickCategory.h \
+    RefereeCandidateIndex.h \
+    PlayerScheduleIndex.h \
+    MatchCounterCache.h \
+    ui/EventLoopWatchdog.h \
+    CatInitWorker.h \
+    ui/DlgCatInitProgress.h \
+    reports/AsyncReportGenerator.h \
+    reports/BatchReportExporter.h \
+    ui/DlgBatchReportExport.h \
+    reports/LiveResultsExporter.h \
+    ChangeJournal.h \
+    BackgroundSaver.h \
+    SnapshotStore.h \
+    SqlProfiler.h \
+    MatchDisplay.h
 
 SOURCES += \
     Category.cpp \
@@ -273,7 +292,22 @@ SOURCES += \
     ui/DlgImportCSV_Step1.cpp \
     ui/DlgImportCSV_Step2.cpp \
     ui/DlgPickTeam.cpp \
-    ui/DlgPickCategory.cpp
+    ui/DlgPickCategory.cpp \
+    RefereeCandidateIndex.cpp \
+    PlayerScheduleIndex.cpp \
+    MatchCounterCache.cpp \
+    ui/EventLoopWatchdog.cpp \
+    CatInitWorker.cpp \
+    ui/DlgCatInitProgress.cpp \
+    reports/AsyncReportGenerator.cpp \
+    reports/BatchReportExporter.cpp \
+    ui/DlgBatchReportExport.cpp \
+    reports/LiveResultsExporter.cpp \
+    ChangeJournal.cpp \
+    BackgroundSaver.cpp \
+    SnapshotStore.cpp \
+    SqlProfiler.cpp \
+    MatchDisplay.cpp
 
 RESOURCES += \
     tournament.qrc
@@ -322,7 +356,7 @@ win32: INCLUDEPATH += D:/PortablePrograms/msys64/usr/local/include
 win32: LIBS += -lboost_filesystem-mt -lboost_system-mt -lboost_log-mt -lboost_log_setup-mt -lboost_date_time-mt -lboost_thread-mt -lboost_regex-mt -lboost_chrono-mt -lboost_atomic-mt -Ld:/PortablePrograms/msys64/usr/local/lib
 else: LIBS += -lboost_filesystem -lboost_system -lboost_log -lboost_log_setup -lboost_date_time -lboost_thread -lboost_regex -lboost_chrono -lboost_atomic
 
-LIBS += -lSqliteOverlay -lSloppy  
+LIBS += -lSqliteOverlay -lSloppy -lsqlite3
 
 #win32:CONFIG(release, debug|release): LIBS += -L$$PWD/../../../SqliteOverlay/release/ -lSqliteOverlay
 #else:win32:CONFIG(debug, debug|release): LIBS += -L$$PWD/../../../SqliteOverlay/debug/ -lSqliteOverlay
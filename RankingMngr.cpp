@@ -284,6 +284,57 @@ namespace QTournament
     return result;
   }
 
+//----------------------------------------------------------------------------
+
+  StandingsSnapshot RankingMngr::getStandingsSnapshot(const Category& cat, int round) const
+  {
+    StandingsSnapshot result;
+
+    // a single query for all entries of all groups; the
+    // sort order is the same as in getSortedRanking()
+    WhereClause wc;
+    wc.addIntCol(RA_CAT_REF, cat.getId());
+    wc.addIntCol(RA_ROUND, round);
+    wc.setOrderColumn_Asc(RA_GRP_NUM);
+    wc.setOrderColumn_Asc(RA_RANK);
+
+    auto intOrDefault = [](const TabRow& r, const char* colName, int defaultVal) {
+      auto v = r.getInt2(colName);
+      return v->isNull() ? defaultVal : v->get();
+    };
+
+    DbTab::CachingRowIterator it = tab->getRowsByWhereClause(wc);
+    while (!(it.isEnd()))
+    {
+      TabRow r = *it;
+      ++it;
+
+      int idx = result.size();
+      int grpNum = r.getInt(RA_GRP_NUM);
+      if ((idx == 0) || (grpNum != result.grpNum.back()))
+      {
+        result.groupStart.push_back(idx);
+      }
+
+      int rank = intOrDefault(r, RA_RANK, -1);
+      result.pairId.push_back(intOrDefault(r, RA_PAIR_REF, -1));
+      result.grpNum.push_back(grpNum);
+      result.rank.push_back((rank <= 0) ? RankingEntry::NO_RANK_ASSIGNED : rank);
+      result.matchesWon.push_back(intOrDefault(r, RA_MATCHES_WON, 0));
+      result.matchesDraw.push_back(intOrDefault(r, RA_MATCHES_DRAW, 0));
+      result.matchesLost.push_back(intOrDefault(r, RA_MATCHES_LOST, 0));
+      result.gamesWon.push_back(intOrDefault(r, RA_GAMES_WON, 0));
+      result.gamesLost.push_back(intOrDefault(r, RA_GAMES_LOST, 0));
+      result.pointsWon.push_back(intOrDefault(r, RA_POINTS_WON, 0));
+      result.pointsLost.push_back(intOrDefault(r, RA_POINTS_LOST, 0));
+    }
+
+    // close the last group
+    if (!(result.groupStart.empty())) result.groupStart.push_back(result.size());
+
+    return result;
+  }
+
 //----------------------------------------------------------------------------
 
   int RankingMngr::getHighestRoundWithRankingEntryForPlayerPair(const Category& cat, const PlayerPair& pp) const
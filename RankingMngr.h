@@ -42,6 +42,31 @@ namespace QTournament
   typedef vector<RankingEntry> RankingEntryList;
   typedef vector<RankingEntryList> RankingEntryListList;
 
+  /*
+   * A column-oriented copy of all ranking entries of a category round.
+   *
+   * The entries are sorted by group number and rank and element "i"
+   * of each vector belongs to the same ranking entry. The entries of
+   * group "g" are in the index range [groupStart[g], groupStart[g+1]).
+   */
+  struct StandingsSnapshot
+  {
+    vector<int> pairId;   // -1 if the entry has no player pair
+    vector<int> grpNum;
+    vector<int> rank;   // RankingEntry::NO_RANK_ASSIGNED if not yet assigned
+    vector<int> matchesWon;
+    vector<int> matchesDraw;
+    vector<int> matchesLost;
+    vector<int> gamesWon;
+    vector<int> gamesLost;
+    vector<int> pointsWon;
+    vector<int> pointsLost;
+    vector<int> groupStart;   // contains one more element than there are groups
+
+    int size() const { return pairId.size(); }
+    int getGroupCount() const { return groupStart.empty() ? 0 : groupStart.size() - 1; }
+  };
+
   class RankingMngr : public QObject, TournamentDatabaseObjectManager
   {
     Q_OBJECT
@@ -57,6 +82,7 @@ namespace QTournament
     unique_ptr<RankingEntry> getRankingEntry(const PlayerPair &pp, int round) const;
     unique_ptr<RankingEntry> getRankingEntry(const Category &cat, int round, int grpNum, int rank) const;
     RankingEntryListList getSortedRanking(const Category &cat, int round) const;
+    StandingsSnapshot getStandingsSnapshot(const Category &cat, int round) const;
 
     int getHighestRoundWithRankingEntryForPlayerPair(const Category &cat, const PlayerPair &pp) const;
 
@@ -0,0 +1,496 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QDateTime>
+
+#include <SqliteOverlay/ClausesAndQueries.h>
+#include <SqliteOverlay/TabRow.h>
+
+#include "RefereeCandidateIndex.h"
+#include "CentralSignalEmitter.h"
+#include "PlayerMngr.h"
+#include "TeamMngr.h"
+#include "MatchMngr.h"
+#include "Match.h"
+#include "PlayerPair.h"
+
+using namespace SqliteOverlay;
+
+namespace QTournament
+{
+  // allocate static variables
+  constexpr int RefereeCandidateIndex::MAX_RECENT_MATCHES;
+
+  //----------------------------------------------------------------------------
+
+  RefereeCandidateIndex::RefereeCandidateIndex(TournamentDB* _db)
+    :QObject(), db(_db), playerTab(db->getTab(TAB_PLAYER)), needsRebuild(true), needsSorting(false)
+  {
+    // private copies of the database don't emit any signals
+    // and might be used in another thread; the database
+    // takes care of invalidating the cache in this case
+    if (db->getConnectionRole() != ConnectionRole::Primary) return;
+
+    // status changes are taken from the unbatched signals
+    // because the index is queried within running transactions
+    CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
+    connect(cse, SIGNAL(playerStatusRecorded(int,int,OBJ_STATE,OBJ_STATE)), this, SLOT(onPlayerStatusChanged(int,int,OBJ_STATE,OBJ_STATE)), Qt::DirectConnection);
+    connect(cse, SIGNAL(playerRenamed(Player)), this, SLOT(onPlayerRenamed(Player)), Qt::DirectConnection);
+    connect(cse, SIGNAL(teamAssignmentChanged(Player,Team,Team)), this, SLOT(onTeamAssignmentChanged(Player,Team,Team)), Qt::DirectConnection);
+    connect(cse, SIGNAL(matchStatusRecorded(int,int,OBJ_STATE,OBJ_STATE)), this, SLOT(onMatchStatusChanged(int,int,OBJ_STATE,OBJ_STATE)), Qt::DirectConnection);
+    connect(cse, SIGNAL(matchResultRecorded(int,int)), this, SLOT(onMatchResultUpdated(int,int)), Qt::DirectConnection);
+
+    // rare events that affect many players at once
+    // trigger a complete rebuild of the index
+    connect(cse, SIGNAL(endCreatePlayer(int)), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(endDeletePlayer()), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(endCreateTeam(int)), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(teamRenamed(int)), this, SLOT(invalidate()), Qt::DirectConnection);
+    connect(cse, SIGNAL(endResetAllModels()), this, SLOT(invalidate()), Qt::DirectConnection);
+
+    // a rollback might have reverted changes that we've already read
+    connect(cse, SIGNAL(statusChangeBatchDiscarded()), this, SLOT(invalidate()), Qt::DirectConnection);
+
+    // the committed row feed also catches modifications that
+    // haven't been announced by any of the signals above
+    connect(cse, SIGNAL(rowChangesCommitted(RowChangeSet)), this, SLOT(onRowChangesCommitted(RowChangeSet)), Qt::DirectConnection);
+  }
+
+  //----------------------------------------------------------------------------
+
+  RefereeCandidateList RefereeCandidateIndex::getAllCandidates(bool idleOnly)
+  {
+    syncIfNecessary();
+
+    return idsToCandidates(allPlayerIds, idleOnly);
+  }
+
+  //----------------------------------------------------------------------------
+
+  RefereeCandidateList RefereeCandidateIndex::getCandidatesForTeam(int teamId, bool idleOnly)
+  {
+    syncIfNecessary();
+
+    auto it = team2PlayerIds.find(teamId);
+    if (it == team2PlayerIds.end()) return RefereeCandidateList();
+
+    return idsToCandidates(it->second, idleOnly);
+  }
+
+  //----------------------------------------------------------------------------
+
+  TaggedRefereeCandidateList RefereeCandidateIndex::getRecentFinishers(bool idleOnly)
+  {
+    syncIfNecessary();
+
+    TaggedRefereeCandidateList result;
+    for (RECENT_FINISHER_ROLE role : {RECENT_FINISHER_ROLE::WINNER, RECENT_FINISHER_ROLE::LOSER, RECENT_FINISHER_ROLE::DRAW})
+    {
+      // each player shows up only once per role
+      unordered_set<int> alreadyAdded;
+
+      for (const RecentMatch& rm : recentMatches)
+      {
+        const vector<int>& ids = (role == RECENT_FINISHER_ROLE::WINNER) ? rm.winnerIds :
+                                 ((role == RECENT_FINISHER_ROLE::LOSER) ? rm.loserIds : rm.drawIds);
+        for (int playerId : ids)
+        {
+          if (alreadyAdded.find(playerId) != alreadyAdded.end()) continue;
+
+          auto it = candidates.find(playerId);
+          if (it == candidates.end()) continue;
+          const RefereeCandidate& c = it->second;
+
+          // players that are already acting as umpires are never suggested
+          if (c.state == STAT_PL_REFEREE) continue;
+          if (idleOnly && (c.state != STAT_PL_IDLE)) continue;
+
+          alreadyAdded.insert(playerId);
+          result.push_back(make_pair(c, role));
+        }
+      }
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::onPlayerStatusChanged(int playerId, int, OBJ_STATE, OBJ_STATE)
+  {
+    dirtyPlayers.insert(playerId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::onPlayerRenamed(const Player& p)
+  {
+    dirtyPlayers.insert(p.getId());
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::onTeamAssignmentChanged(const Player& affectedPlayer, const Team&, const Team&)
+  {
+    dirtyPlayers.insert(affectedPlayer.getId());
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::onMatchStatusChanged(int matchId, int, OBJ_STATE fromState, OBJ_STATE toState)
+  {
+    // only calling, un-calling and finishing a match affects
+    // the state of the players, the umpire and the finish times.
+    //
+    // All other transitions (e.g., READY <--> BUSY) are frequent
+    // but irrelevant for us
+    if ((toState == STAT_MA_RUNNING) || (fromState == STAT_MA_RUNNING) || (toState == STAT_MA_FINISHED))
+    {
+      dirtyMatches.insert(matchId);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::onMatchResultUpdated(int matchId, int)
+  {
+    // a modified result might swap winner and loser
+    dirtyMatches.insert(matchId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::onRowChangesCommitted(const RowChangeSet& changes)
+  {
+    if (!(changes.isComplete))
+    {
+      invalidate();
+      return;
+    }
+
+    for (const RowChange& rc : changes.changes)
+    {
+      // re-reading a player also covers new and deleted players
+      if (rc.tabName == TAB_PLAYER)
+      {
+        dirtyPlayers.insert(rc.rowId);
+        continue;
+      }
+
+      // deleted matches don't have players anymore
+      if ((rc.tabName == TAB_MATCH) && (rc.type != RowChangeType::Delete))
+      {
+        dirtyMatches.insert(rc.rowId);
+        continue;
+      }
+
+      // the cached team names
+      if (rc.tabName == TAB_TEAM)
+      {
+        invalidate();
+        return;
+      }
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::invalidate()
+  {
+    needsRebuild = true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::syncIfNecessary()
+  {
+    if (needsRebuild)
+    {
+      rebuild();
+      return;
+    }
+
+    // process the matches first, because they
+    // might add more players to the dirty-list
+    for (int matchId : dirtyMatches)
+    {
+      refreshMatch(matchId);
+    }
+    dirtyMatches.clear();
+
+    for (int playerId : dirtyPlayers)
+    {
+      refreshPlayer(playerId);
+    }
+    dirtyPlayers.clear();
+
+    if (needsSorting) sortBuckets();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::rebuild()
+  {
+    candidates.clear();
+    team2PlayerIds.clear();
+    allPlayerIds.clear();
+    teamId2Name.clear();
+    recentMatches.clear();
+    dirtyPlayers.clear();
+    dirtyMatches.clear();
+
+    TeamMngr tm{db};
+    for (const Team& t : tm.getAllTeams())
+    {
+      teamId2Name[t.getId()] = t.getName();
+    }
+
+    PlayerMngr pm{db};
+    for (const Player& p : pm.getAllPlayers())
+    {
+      refreshPlayer(p.getId());
+    }
+
+    // a single pass over all finished matches yields the last
+    // finish time for every player and the most recent matches.
+    // Walkovers don't have a finish time; they come last and only
+    // fill up the list of recent matches, just like in
+    // PlayerMngr::getRecentFinishers()
+    WhereClause wc;
+    wc.addIntCol(GENERIC_STATE_FIELD_NAME, static_cast<int>(STAT_MA_FINISHED));
+    wc.setOrderColumn_Desc(MA_FINISH_TIME);
+    DbTab* matchTab = db->getTab(TAB_MATCH);
+    auto it = matchTab->getRowsByWhereClause(wc);
+    MatchMngr mm{db};
+    while (!(it.isEnd()))
+    {
+      TabRow row = *it;
+      auto ft = row.getInt2(MA_FINISH_TIME);
+      time_t finishTime = ft->isNull() ? 0 : ft->get();
+
+      for (const char* colName : {MA_ACTUAL_PLAYER1A_REF, MA_ACTUAL_PLAYER1B_REF, MA_ACTUAL_PLAYER2A_REF, MA_ACTUAL_PLAYER2B_REF})
+      {
+        auto pRef = row.getInt2(colName);
+        if (pRef->isNull()) continue;
+
+        auto candIt = candidates.find(pRef->get());
+        if (candIt == candidates.end()) continue;
+        if (candIt->second.lastFinishTime__UTC < finishTime) candIt->second.lastFinishTime__UTC = finishTime;
+      }
+
+      // we've ordered the rows by finish time, so the first
+      // rows are always the most recent matches
+      if (recentMatches.size() < MAX_RECENT_MATCHES)
+      {
+        auto ma = mm.getMatch(row.getId());
+        if (ma != nullptr) storeRecentMatch(*ma, finishTime);
+      }
+
+      ++it;
+    }
+
+    sortBuckets();
+    needsRebuild = false;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::refreshPlayer(int playerId)
+  {
+    // remove the player from its current team bucket, if any
+    auto candIt = candidates.find(playerId);
+    bool isNew = (candIt == candidates.end());
+    if (!isNew)
+    {
+      vector<int>& bucket = team2PlayerIds[candIt->second.teamId];
+      bucket.erase(remove(bucket.begin(), bucket.end(), playerId), bucket.end());
+    }
+
+    // the player might have been deleted in the meantime
+    PlayerMngr pm{db};
+    auto p = pm.getPlayer_up(playerId);
+    if (p == nullptr)
+    {
+      candidates.erase(playerId);
+      allPlayerIds.erase(remove(allPlayerIds.begin(), allPlayerIds.end(), playerId), allPlayerIds.end());
+      return;
+    }
+
+    RefereeCandidate& c = candidates[playerId];
+    if (isNew)
+    {
+      c.playerId = playerId;
+      c.lastFinishTime__UTC = 0;
+      allPlayerIds.push_back(playerId);
+    }
+    c.displayName = p->getDisplayName();
+    c.state = p->getState();
+    c.refereeCount = p->getRefereeCount();
+
+    // we read the team reference directly instead of using
+    // Player::getTeam() because the latter throws if the tournament
+    // doesn't use teams
+    auto teamRef = playerTab->operator [](playerId).getInt2(PL_TEAM_REF);
+    c.teamId = teamRef->isNull() ? -1 : teamRef->get();
+    c.teamName.clear();
+    if (c.teamId > 0)
+    {
+      auto teamIt = teamId2Name.find(c.teamId);
+      if (teamIt == teamId2Name.end())
+      {
+        TeamMngr tm{db};
+        teamId2Name[c.teamId] = tm.getTeamById(c.teamId).getName();
+        teamIt = teamId2Name.find(c.teamId);
+      }
+      c.teamName = teamIt->second;
+    }
+    team2PlayerIds[c.teamId].push_back(playerId);
+
+    needsSorting = true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::refreshMatch(int matchId)
+  {
+    MatchMngr mm{db};
+    auto ma = mm.getMatch(matchId);
+    if (ma == nullptr) return;
+
+    // the players and the umpire of this match have
+    // potentially changed their state
+    PlayerList actualPlayers = ma->determineActualPlayers();
+    for (const Player& p : actualPlayers)
+    {
+      dirtyPlayers.insert(p.getId());
+    }
+    upPlayer referee = ma->getAssignedReferee();
+    if (referee != nullptr) dirtyPlayers.insert(referee->getId());
+
+    if (ma->getState() != STAT_MA_FINISHED) return;
+
+    // walkovers don't have a finish time; they go to the end
+    // of the list of recent matches and don't change the
+    // time of the players' last finished match
+    QDateTime finishTime = ma->getFinishTime();
+    if (!(finishTime.isValid()))
+    {
+      storeRecentMatch(*ma, 0);
+      return;
+    }
+    time_t ft = finishTime.toTime_t();
+
+    for (const Player& p : actualPlayers)
+    {
+      auto candIt = candidates.find(p.getId());
+      if (candIt == candidates.end()) continue;
+      if (candIt->second.lastFinishTime__UTC < ft) candIt->second.lastFinishTime__UTC = ft;
+    }
+    needsSorting = true;
+
+    storeRecentMatch(*ma, ft);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::storeRecentMatch(const Match& ma, time_t finishTime)
+  {
+    RecentMatch rm;
+    rm.matchId = ma.getId();
+    rm.finishTime__UTC = finishTime;
+
+    auto pairToIds = [](const PlayerPair& pp, vector<int>& ids) {
+      ids.push_back(pp.getPlayer1().getId());
+      if (pp.hasPlayer2()) ids.push_back(pp.getPlayer2().getId());
+    };
+
+    auto winner = ma.getWinner();
+    auto loser = ma.getLoser();
+    if (winner != nullptr) pairToIds(*winner, rm.winnerIds);
+    if (loser != nullptr) pairToIds(*loser, rm.loserIds);
+
+    // handle draws
+    if ((winner == nullptr) && (loser == nullptr))
+    {
+      if (ma.hasPlayerPair1()) pairToIds(ma.getPlayerPair1(), rm.drawIds);
+      if (ma.hasPlayerPair2()) pairToIds(ma.getPlayerPair2(), rm.drawIds);
+    }
+
+    // replace an existing entry for the same match, e.g.
+    // after a result has been corrected
+    recentMatches.erase(remove_if(recentMatches.begin(), recentMatches.end(), [&rm](const RecentMatch& other) {
+      return (other.matchId == rm.matchId);
+    }), recentMatches.end());
+
+    // insert the match at the right position and
+    // drop the oldest matches if necessary
+    auto pos = find_if(recentMatches.begin(), recentMatches.end(), [&finishTime](const RecentMatch& other) {
+      return (other.finishTime__UTC < finishTime);
+    });
+    recentMatches.insert(pos, rm);
+    while (recentMatches.size() > MAX_RECENT_MATCHES)
+    {
+      recentMatches.pop_back();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void RefereeCandidateIndex::sortBuckets()
+  {
+    // most recent finishers first; among them those
+    // with the lowest number of umpire assignments
+    auto cmp = [this](int id1, int id2) {
+      const RefereeCandidate& c1 = candidates.at(id1);
+      const RefereeCandidate& c2 = candidates.at(id2);
+
+      if (c1.lastFinishTime__UTC != c2.lastFinishTime__UTC) return (c1.lastFinishTime__UTC > c2.lastFinishTime__UTC);
+      if (c1.refereeCount != c2.refereeCount) return (c1.refereeCount < c2.refereeCount);
+      return (c1.displayName < c2.displayName);
+    };
+
+    std::sort(allPlayerIds.begin(), allPlayerIds.end(), cmp);
+    for (auto& bucket : team2PlayerIds)
+    {
+      std::sort(bucket.second.begin(), bucket.second.end(), cmp);
+    }
+
+    needsSorting = false;
+  }
+
+  //----------------------------------------------------------------------------
+
+  RefereeCandidateList RefereeCandidateIndex::idsToCandidates(const vector<int>& ids, bool idleOnly) const
+  {
+    RefereeCandidateList result;
+    result.reserve(ids.size());
+    for (int playerId : ids)
+    {
+      const RefereeCandidate& c = candidates.at(playerId);
+      if (idleOnly && (c.state != STAT_PL_IDLE)) continue;
+      result.push_back(c);
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+}
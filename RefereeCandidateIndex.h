@@ -0,0 +1,144 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REFEREECANDIDATEINDEX_H
+#define REFEREECANDIDATEINDEX_H
+
+#include <ctime>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <QObject>
+#include <QString>
+
+#include <SqliteOverlay/DbTab.h>
+
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+#include "Player.h"
+#include "Team.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  class Match;
+
+  enum class RECENT_FINISHER_ROLE
+  {
+    WINNER,
+    LOSER,
+    DRAW,
+  };
+
+  struct RefereeCandidate
+  {
+    int playerId;
+    int teamId;   // -1 if the tournament doesn't use teams
+    QString displayName;
+    QString teamName;
+    OBJ_STATE state;
+    int refereeCount;
+    time_t lastFinishTime__UTC;   // 0 if the player hasn't finished a match yet
+  };
+
+  using RefereeCandidateList = vector<RefereeCandidate>;
+  using TaggedRefereeCandidate = pair<RefereeCandidate, RECENT_FINISHER_ROLE>;
+  using TaggedRefereeCandidateList = vector<TaggedRefereeCandidate>;
+
+  //----------------------------------------------------------------------------
+
+  /*
+   * An in-memory index of all players that could act as an umpire.
+   *
+   * The index is kept in sync by the signals of the CentralSignalEmitter,
+   * including the committed row change feed of the database. The slots
+   * only mark players or matches as "dirty"; the (cheap) re-read of the affected
+   * rows is deferred until the next query. This way we don't spend any cycles
+   * in the middle of a running transaction and we catch changes that happen
+   * after the signal has been emitted (e.g., the referee count that is increased
+   * after a match has been finished).
+   *
+   * The players are bucketed by team and each bucket is ordered by the time of
+   * the player's last finished match (most recent first) and the number of umpire
+   * assignments (lowest first).
+   */
+  class RefereeCandidateIndex : public QObject
+  {
+    Q_OBJECT
+
+  public:
+    // the number of recently finished matches that are
+    // taken into account for the "recent finishers" list
+    static constexpr int MAX_RECENT_MATCHES = 30;
+
+    // ctor
+    RefereeCandidateIndex(TournamentDB* _db);
+
+    // getters
+    RefereeCandidateList getAllCandidates(bool idleOnly);
+    RefereeCandidateList getCandidatesForTeam(int teamId, bool idleOnly);
+    TaggedRefereeCandidateList getRecentFinishers(bool idleOnly);
+
+  public slots:
+    void onPlayerStatusChanged(int playerId, int playerSeqNum, OBJ_STATE fromState, OBJ_STATE toState);
+    void onPlayerRenamed(const Player& p);
+    void onTeamAssignmentChanged(const Player& affectedPlayer, const Team& oldTeam, const Team& newTeam);
+    void onMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState);
+    void onMatchResultUpdated(int matchId, int matchSeqNum);
+    void onRowChangesCommitted(const RowChangeSet& changes);
+    void invalidate();
+
+  private:
+    struct RecentMatch
+    {
+      int matchId;
+      time_t finishTime__UTC;   // 0 for walkovers
+      vector<int> winnerIds;
+      vector<int> loserIds;
+      vector<int> drawIds;
+    };
+
+    TournamentDB* db;
+    SqliteOverlay::DbTab* playerTab;
+    bool needsRebuild;
+    bool needsSorting;
+
+    unordered_map<int, RefereeCandidate> candidates;
+    unordered_map<int, vector<int>> team2PlayerIds;
+    vector<int> allPlayerIds;
+    unordered_map<int, QString> teamId2Name;
+    deque<RecentMatch> recentMatches;   // most recent match first
+
+    unordered_set<int> dirtyPlayers;
+    unordered_set<int> dirtyMatches;
+
+    void syncIfNecessary();
+    void rebuild();
+    void refreshPlayer(int playerId);
+    void refreshMatch(int matchId);
+    void storeRecentMatch(const Match& ma, time_t finishTime);
+    void sortBuckets();
+    RefereeCandidateList idsToCandidates(const vector<int>& ids, bool idleOnly) const;
+  };
+
+}
+
+#endif // REFEREECANDIDATEINDEX_H
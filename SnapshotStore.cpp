@@ -0,0 +1,383 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QSaveFile>
+
+#include "SnapshotStore.h"
+#include "TournamentDataDefs.h"
+
+namespace QTournament
+{
+
+  QString SnapshotStore::getStoreFileName(const QString& dbFileName)
+  {
+    return dbFileName + ".snapshots";
+  }
+
+  //----------------------------------------------------------------------------
+
+  SnapshotStore::SnapshotStore(const QString& _fileName)
+    :fileName(_fileName), storePtr(nullptr)
+  {
+    int err = sqlite3_open_v2(fileName.toUtf8().constData(), &storePtr, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, nullptr);
+    if (err != SQLITE_OK)
+    {
+      sqlite3_close(storePtr);
+      storePtr = nullptr;
+      return;
+    }
+
+    // pages are shared between snapshots and can't be
+    // deleted as long as any snapshot refers to them
+    const char* schema =
+        "CREATE TABLE IF NOT EXISTS Page (hash BLOB PRIMARY KEY, data BLOB NOT NULL) WITHOUT ROWID;"
+        "CREATE TABLE IF NOT EXISTS Snapshot (id INTEGER PRIMARY KEY, label TEXT, created INTEGER,"
+        " pageSize INTEGER, pageCount INTEGER, newPageCount INTEGER);"
+        "CREATE TABLE IF NOT EXISTS SnapshotPage (snapId INTEGER, pageNum INTEGER, hash BLOB NOT NULL,"
+        " PRIMARY KEY (snapId, pageNum)) WITHOUT ROWID;";
+    if (!(execSql(storePtr, schema)))
+    {
+      sqlite3_close(storePtr);
+      storePtr = nullptr;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  SnapshotStore::~SnapshotStore()
+  {
+    if (storePtr != nullptr) sqlite3_close(storePtr);
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR SnapshotStore::createSnapshot(sqlite3* srcDbPtr, const QString& label, int* newSnapId)
+  {
+    if (!(isValid())) return DATABASE_ERROR;
+
+    // get a consistent image of the source database
+    sqlite3_int64 imgSize = 0;
+    unsigned char* img = sqlite3_serialize(srcDbPtr, "main", &imgSize, 0);
+    if (img == nullptr) return DATABASE_ERROR;
+
+    // the page size is stored as a big endian value at offset 16
+    // of the database header; the special value 1 means 65536
+    int pageSize = (img[16] << 8) | img[17];
+    if (pageSize == 1) pageSize = 65536;
+    if ((imgSize < 100) || (pageSize < 512) || ((imgSize % pageSize) != 0))
+    {
+      sqlite3_free(img);
+      return DATABASE_ERROR;
+    }
+    int pageCount = imgSize / pageSize;
+
+    sqlite3_stmt* probePage = nullptr;
+    sqlite3_stmt* insPage = nullptr;
+    sqlite3_stmt* insRef = nullptr;
+    bool isOkay = execSql(storePtr, "BEGIN IMMEDIATE");
+    isOkay = isOkay && (sqlite3_prepare_v2(storePtr, "SELECT 1 FROM Page WHERE hash = ?", -1, &probePage, nullptr) == SQLITE_OK);
+    isOkay = isOkay && (sqlite3_prepare_v2(storePtr, "INSERT INTO Page (hash, data) VALUES (?, ?)", -1, &insPage, nullptr) == SQLITE_OK);
+    isOkay = isOkay && (sqlite3_prepare_v2(storePtr, "INSERT INTO SnapshotPage (snapId, pageNum, hash) VALUES (?, ?, ?)", -1, &insRef, nullptr) == SQLITE_OK);
+
+    // create the snapshot entry first; the number of new
+    // pages is filled in after all pages have been stored
+    int snapId = -1;
+    if (isOkay)
+    {
+      sqlite3_stmt* insSnap = nullptr;
+      isOkay = (sqlite3_prepare_v2(storePtr, "INSERT INTO Snapshot (label, created, pageSize, pageCount, newPageCount) VALUES (?, ?, ?, ?, 0)", -1, &insSnap, nullptr) == SQLITE_OK);
+      if (isOkay)
+      {
+        QByteArray lbl = label.toUtf8();
+        sqlite3_bind_text(insSnap, 1, lbl.constData(), lbl.size(), SQLITE_TRANSIENT);
+        sqlite3_bind_int64(insSnap, 2, QDateTime::currentDateTimeUtc().toTime_t());
+        sqlite3_bind_int(insSnap, 3, pageSize);
+        sqlite3_bind_int(insSnap, 4, pageCount);
+        isOkay = (sqlite3_step(insSnap) == SQLITE_DONE);
+        snapId = sqlite3_last_insert_rowid(storePtr);
+      }
+      sqlite3_finalize(insSnap);
+    }
+
+    int newPageCount = 0;
+    for (int pageNum = 0; isOkay && (pageNum < pageCount); ++pageNum)
+    {
+      QByteArray page = QByteArray::fromRawData(reinterpret_cast<const char*>(img + pageNum * pageSize), pageSize);
+      QByteArray hash = QCryptographicHash::hash(page, QCryptographicHash::Sha1);
+
+      // only pages that we haven't seen before are compressed and stored
+      sqlite3_bind_blob(probePage, 1, hash.constData(), hash.size(), SQLITE_STATIC);
+      bool isKnown = (sqlite3_step(probePage) == SQLITE_ROW);
+      sqlite3_reset(probePage);
+
+      if (!isKnown)
+      {
+        QByteArray data = qCompress(page);
+        sqlite3_bind_blob(insPage, 1, hash.constData(), hash.size(), SQLITE_STATIC);
+        sqlite3_bind_blob(insPage, 2, data.constData(), data.size(), SQLITE_TRANSIENT);
+        isOkay = (sqlite3_step(insPage) == SQLITE_DONE);
+        sqlite3_reset(insPage);
+        ++newPageCount;
+      }
+
+      sqlite3_bind_int(insRef, 1, snapId);
+      sqlite3_bind_int(insRef, 2, pageNum);
+      sqlite3_bind_blob(insRef, 3, hash.constData(), hash.size(), SQLITE_STATIC);
+      isOkay = isOkay && (sqlite3_step(insRef) == SQLITE_DONE);
+      sqlite3_reset(insRef);
+    }
+    sqlite3_finalize(probePage);
+    sqlite3_finalize(insPage);
+    sqlite3_finalize(insRef);
+    sqlite3_free(img);
+
+    if (isOkay)
+    {
+      QString sql = "UPDATE Snapshot SET newPageCount = %1 WHERE id = %2";
+      sql = sql.arg(newPageCount).arg(snapId);
+      isOkay = execSql(storePtr, sql.toUtf8().constData());
+    }
+
+    if (!isOkay)
+    {
+      execSql(storePtr, "ROLLBACK");
+      return DATABASE_ERROR;
+    }
+    if (!(execSql(storePtr, "COMMIT"))) return DATABASE_ERROR;
+
+    if (newSnapId != nullptr) *newSnapId = snapId;
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<SnapshotInfo> SnapshotStore::listSnapshots() const
+  {
+    vector<SnapshotInfo> result;
+    if (!(isValid())) return result;
+
+    sqlite3_stmt* stmt = nullptr;
+    const char* sql = "SELECT id, label, created, pageCount, newPageCount FROM Snapshot ORDER BY id ASC";
+    if (sqlite3_prepare_v2(storePtr, sql, -1, &stmt, nullptr) != SQLITE_OK) return result;
+
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+      SnapshotInfo si;
+      si.id = sqlite3_column_int(stmt, 0);
+      si.label = QString::fromUtf8(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)));
+      si.created__UTC = sqlite3_column_int64(stmt, 2);
+      si.pageCount = sqlite3_column_int(stmt, 3);
+      si.newPageCount = sqlite3_column_int(stmt, 4);
+      result.push_back(si);
+    }
+    sqlite3_finalize(stmt);
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR SnapshotStore::diffSnapshots(int fromSnapId, int toSnapId, vector<TableDiff>& result) const
+  {
+    result.clear();
+
+    QByteArray fromImage;
+    ERR err = loadImage(fromSnapId, fromImage);
+    if (err != OK) return err;
+    QByteArray toImage;
+    err = loadImage(toSnapId, toImage);
+    if (err != OK) return err;
+
+    // load both snapshots as read-only schemas "main" and "other"
+    // into one in-memory connection. The images stay owned by
+    // the QByteArrays and must outlive the connection.
+    sqlite3* cmpPtr = nullptr;
+    if (sqlite3_open(":memory:", &cmpPtr) != SQLITE_OK)
+    {
+      sqlite3_close(cmpPtr);
+      return DATABASE_ERROR;
+    }
+    bool isOkay = execSql(cmpPtr, "ATTACH ':memory:' AS other");
+    isOkay = isOkay && (sqlite3_deserialize(cmpPtr, "main", reinterpret_cast<unsigned char*>(fromImage.data()),
+                                            fromImage.size(), fromImage.size(), SQLITE_DESERIALIZE_READONLY) == SQLITE_OK);
+    isOkay = isOkay && (sqlite3_deserialize(cmpPtr, "other", reinterpret_cast<unsigned char*>(toImage.data()),
+                                            toImage.size(), toImage.size(), SQLITE_DESERIALIZE_READONLY) == SQLITE_OK);
+    if (!isOkay)
+    {
+      sqlite3_close(cmpPtr);
+      return DATABASE_ERROR;
+    }
+
+    vector<QString> fromTabs = queryTableNames(cmpPtr, "main");
+    vector<QString> toTabs = queryTableNames(cmpPtr, "other");
+    vector<QString> allTabs = fromTabs;
+    for (const QString& t : toTabs)
+    {
+      if (std::find(allTabs.begin(), allTabs.end(), t) == allTabs.end()) allTabs.push_back(t);
+    }
+
+    for (const QString& t : allTabs)
+    {
+      bool inFrom = (std::find(fromTabs.begin(), fromTabs.end(), t) != fromTabs.end());
+      bool inTo = (std::find(toTabs.begin(), toTabs.end(), t) != toTabs.end());
+      QString quotedName = "\"" + QString{t}.replace("\"", "\"\"") + "\"";
+
+      TableDiff td;
+      td.tabName = t;
+      if (inFrom && inTo)
+      {
+        QString sql = "SELECT rowid FROM other.%1 WHERE rowid NOT IN (SELECT rowid FROM main.%1)";
+        td.addedRows = queryIds(cmpPtr, sql.arg(quotedName));
+
+        sql = "SELECT rowid FROM main.%1 WHERE rowid NOT IN (SELECT rowid FROM other.%1)";
+        td.removedRows = queryIds(cmpPtr, sql.arg(quotedName));
+
+        sql = "SELECT _rid FROM (SELECT rowid AS _rid, * FROM other.%1 EXCEPT SELECT rowid AS _rid, * FROM main.%1)";
+        sql += " WHERE _rid IN (SELECT rowid FROM main.%1)";
+        td.modifiedRows = queryIds(cmpPtr, sql.arg(quotedName));
+      }
+      else if (inTo)
+      {
+        td.addedRows = queryIds(cmpPtr, QString{"SELECT rowid FROM other.%1"}.arg(quotedName));
+      } else {
+        td.removedRows = queryIds(cmpPtr, QString{"SELECT rowid FROM main.%1"}.arg(quotedName));
+      }
+
+      if (td.addedRows.empty() && td.removedRows.empty() && td.modifiedRows.empty()) continue;
+      result.push_back(td);
+    }
+
+    sqlite3_close(cmpPtr);
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR SnapshotStore::restoreSnapshot(int snapId, const QString& dstFileName) const
+  {
+    QByteArray image;
+    ERR err = loadImage(snapId, image);
+    if (err != OK) return err;
+
+    // the image is a complete database file
+    QSaveFile f{dstFileName};
+    if (!(f.open(QIODevice::WriteOnly))) return FILE_IO_ERROR;
+    if (f.write(image) != image.size())
+    {
+      f.cancelWriting();
+      return FILE_IO_ERROR;
+    }
+
+    return f.commit() ? OK : FILE_IO_ERROR;
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR SnapshotStore::loadImage(int snapId, QByteArray& image) const
+  {
+    image.clear();
+    if (!(isValid())) return DATABASE_ERROR;
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(storePtr, "SELECT pageSize, pageCount FROM Snapshot WHERE id = ?", -1, &stmt, nullptr) != SQLITE_OK)
+    {
+      return DATABASE_ERROR;
+    }
+    sqlite3_bind_int(stmt, 1, snapId);
+    if (sqlite3_step(stmt) != SQLITE_ROW)
+    {
+      sqlite3_finalize(stmt);
+      return INVALID_ID;
+    }
+    int pageSize = sqlite3_column_int(stmt, 0);
+    int pageCount = sqlite3_column_int(stmt, 1);
+    sqlite3_finalize(stmt);
+
+    const char* sql = "SELECT p.data FROM SnapshotPage sp JOIN Page p ON p.hash = sp.hash WHERE sp.snapId = ? ORDER BY sp.pageNum ASC";
+    if (sqlite3_prepare_v2(storePtr, sql, -1, &stmt, nullptr) != SQLITE_OK) return DATABASE_ERROR;
+    sqlite3_bind_int(stmt, 1, snapId);
+
+    image.reserve(pageSize * pageCount);
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+      const char* data = reinterpret_cast<const char*>(sqlite3_column_blob(stmt, 0));
+      int len = sqlite3_column_bytes(stmt, 0);
+      image.append(qUncompress(reinterpret_cast<const uchar*>(data), len));
+    }
+    sqlite3_finalize(stmt);
+
+    // a missing or corrupt page invalidates the whole snapshot
+    if (image.size() != (pageSize * pageCount))
+    {
+      image.clear();
+      return DATABASE_ERROR;
+    }
+
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool SnapshotStore::execSql(sqlite3* dbPtr, const char* sql)
+  {
+    return (sqlite3_exec(dbPtr, sql, nullptr, nullptr, nullptr) == SQLITE_OK);
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<int> SnapshotStore::queryIds(sqlite3* dbPtr, const QString& sql)
+  {
+    vector<int> result;
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(dbPtr, sql.toUtf8().constData(), -1, &stmt, nullptr) != SQLITE_OK) return result;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+      result.push_back(sqlite3_column_int(stmt, 0));
+    }
+    sqlite3_finalize(stmt);
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<QString> SnapshotStore::queryTableNames(sqlite3* dbPtr, const QString& schema)
+  {
+    vector<QString> result;
+
+    // skip the match display table, it only contains derived data
+    QString sql = "SELECT name FROM %1.sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' AND name != '%2'";
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(dbPtr, sql.arg(schema).arg(TAB_MATCH_DISPLAY).toUtf8().constData(), -1, &stmt, nullptr) != SQLITE_OK) return result;
+    while (sqlite3_step(stmt) == SQLITE_ROW)
+    {
+      result.push_back(QString::fromUtf8(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0))));
+    }
+    sqlite3_finalize(stmt);
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+}
@@ -0,0 +1,97 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SNAPSHOTSTORE_H
+#define SNAPSHOTSTORE_H
+
+#include <vector>
+
+#include <QString>
+#include <QByteArray>
+
+#include <sqlite3.h>
+
+#include "TournamentErrorCodes.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  struct SnapshotInfo
+  {
+    int id;
+    QString label;
+    qint64 created__UTC;
+    int pageCount;
+    int newPageCount;   // pages that were not yet contained in the store
+  };
+
+  // the rows of one table that differ between two snapshots;
+  // rows are identified by their rowid (== the "id" column)
+  struct TableDiff
+  {
+    QString tabName;
+    vector<int> addedRows;
+    vector<int> removedRows;
+    vector<int> modifiedRows;
+  };
+
+  //----------------------------------------------------------------------------
+
+  /*
+   * A container file for baseline snapshots of a tournament database.
+   *
+   * The container is an SQLite database itself. Each snapshot is a
+   * list of references to database pages; the pages are stored once,
+   * compressed and addressed by their SHA-1 hash. Since most pages
+   * don't change between two baselines, a new snapshot usually adds
+   * only a few pages to the store.
+   */
+  class SnapshotStore
+  {
+  public:
+    static QString getStoreFileName(const QString& dbFileName);
+
+    SnapshotStore(const QString& _fileName);
+    ~SnapshotStore();
+    SnapshotStore(const SnapshotStore&) = delete;
+    SnapshotStore& operator=(const SnapshotStore&) = delete;
+
+    bool isValid() const { return (storePtr != nullptr); }
+    QString getFileName() const { return fileName; }
+
+    // use TournamentDB::createSnapshot() for the tournament database
+    ERR createSnapshot(sqlite3* srcDbPtr, const QString& label, int* newSnapId = nullptr);
+
+    vector<SnapshotInfo> listSnapshots() const;
+    ERR diffSnapshots(int fromSnapId, int toSnapId, vector<TableDiff>& result) const;
+    ERR restoreSnapshot(int snapId, const QString& dstFileName) const;
+
+  private:
+    QString fileName;
+    sqlite3* storePtr;
+
+    ERR loadImage(int snapId, QByteArray& image) const;
+    static bool execSql(sqlite3* dbPtr, const char* sql);
+    static vector<int> queryIds(sqlite3* dbPtr, const QString& sql);
+    static vector<QString> queryTableNames(sqlite3* dbPtr, const QString& schema);
+  };
+
+}
+
+#endif // SNAPSHOTSTORE_H
@@ -0,0 +1,307 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include <QFile>
+#include <QStringList>
+#include <QTextStream>
+#include <QtGlobal>
+
+#include "SqlProfiler.h"
+
+namespace QTournament
+{
+  // allocate static variables
+  constexpr int SqlProfiler::DEFAULT_SLOW_THRESHOLD__MS;
+  constexpr size_t SqlProfiler::MAX_SAMPLES_PER_STATEMENT;
+  SqlProfiler* SqlProfiler::instance = nullptr;
+
+  void SqlProfiler::initFromEnvironment()
+  {
+    if (instance != nullptr) return;
+
+    QString csvFileName = qgetenv("QTOURNAMENT_SQL_PROFILE");
+    if (csvFileName.isEmpty()) return;
+
+    int threshold = DEFAULT_SLOW_THRESHOLD__MS;
+    bool isOk;
+    int tmp = qgetenv("QTOURNAMENT_SQL_SLOW_MS").toInt(&isOk);
+    if (isOk && (tmp > 0)) threshold = tmp;
+
+    instance = new SqlProfiler(csvFileName, threshold);
+  }
+
+  //----------------------------------------------------------------------------
+
+  SqlProfiler* SqlProfiler::getInstance()
+  {
+    return instance;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void SqlProfiler::cleanUp()
+  {
+    if (instance != nullptr)
+    {
+      instance->writeCsv();
+      delete instance;
+      instance = nullptr;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  string SqlProfiler::normalizeSql(const char* sql)
+  {
+    // replace all string and numeric literals with "?" and
+    // collapse whitespace so that statements that only differ
+    // in their parameters end up in the same bucket
+    string result;
+    if (sql == nullptr) return result;
+
+    const char* p = sql;
+    while (*p != '\0')
+    {
+      char c = *p;
+
+      if (c == '\'')
+      {
+        // skip the string literal, including escaped quotes ('')
+        ++p;
+        while (*p != '\0')
+        {
+          if ((*p == '\'') && (*(p+1) == '\''))
+          {
+            p += 2;
+            continue;
+          }
+          if (*p == '\'') break;
+          ++p;
+        }
+        if (*p != '\0') ++p;
+        result += '?';
+        continue;
+      }
+
+      if (isdigit(static_cast<unsigned char>(c)))
+      {
+        // numbers that are part of an identifier (e.g. "col1") are no literals
+        bool isPartOfIdentifier = !(result.empty()) && (isalnum(static_cast<unsigned char>(result.back())) || (result.back() == '_'));
+        if (!isPartOfIdentifier)
+        {
+          while (isalnum(static_cast<unsigned char>(*p)) || (*p == '.')) ++p;
+          result += '?';
+          continue;
+        }
+      }
+
+      if (isspace(static_cast<unsigned char>(c)))
+      {
+        if (!(result.empty()) && (result.back() != ' ')) result += ' ';
+        ++p;
+        continue;
+      }
+
+      result += c;
+      ++p;
+    }
+
+    while (!(result.empty()) && (result.back() == ' ')) result.pop_back();
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool SqlProfiler::isFullTableScan(const QString& planDetail)
+  {
+    // older SQLite versions print "SCAN TABLE x", newer ones "SCAN x";
+    // scans of a (covering) index are no full table scans
+    return (planDetail.startsWith("SCAN ") && !(planDetail.contains("INDEX")));
+  }
+
+  //----------------------------------------------------------------------------
+
+  void SqlProfiler::recordExecution(const char* sql, sqlite3_int64 duration__ns, int fullScanSteps, int vmSteps)
+  {
+    if (sql == nullptr) return;
+
+    // don't profile our own query plan audits
+    if (strncmp(sql, "EXPLAIN", 7) == 0) return;
+
+    string normSql = normalizeSql(sql);
+
+    if (duration__ns >= threshold__ns)
+    {
+      qWarning("Slow SQL statement (%lld ms): %s", duration__ns / 1000000, sql);
+    }
+
+    lock_guard<mutex> lk{statsMutex};
+
+    auto it = stats.find(normSql);
+    if (it == stats.end())
+    {
+      it = stats.emplace(normSql, StatementStats{0, 0, 0, {}, 0, 0, false, false, QString()}).first;
+    }
+    StatementStats& st = it->second;
+
+    ++st.count;
+    st.total__ns += duration__ns;
+    st.max__ns = max(st.max__ns, duration__ns);
+    st.fullScanSteps += fullScanSteps;
+    st.vmSteps += vmSteps;
+
+    // reservoir sampling keeps a representative subset
+    // of all execution times for the percentile
+    if (st.samples__ns.size() < MAX_SAMPLES_PER_STATEMENT)
+    {
+      st.samples__ns.push_back(duration__ns);
+    } else {
+      unsigned long idx = rng() % st.count;
+      if (idx < MAX_SAMPLES_PER_STATEMENT) st.samples__ns[idx] = duration__ns;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  void SqlProfiler::auditQueryPlans(sqlite3* dbPtr)
+  {
+    // collect the statements first; the EXPLAIN statements
+    // below are traced as well and we must not hold the lock then
+    vector<string> newStatements;
+    {
+      lock_guard<mutex> lk{statsMutex};
+      for (const auto& pr : stats)
+      {
+        if (!(pr.second.isPlanCaptured)) newStatements.push_back(pr.first);
+      }
+    }
+
+    for (const string& sql : newStatements)
+    {
+      QString plan;
+      bool hasFullScan = false;
+
+      // the literals have been replaced by unbound parameters
+      // which is fine for determining the query plan
+      string explainSql = "EXPLAIN QUERY PLAN " + sql;
+      sqlite3_stmt* stmt = nullptr;
+      if (sqlite3_prepare_v2(dbPtr, explainSql.c_str(), -1, &stmt, nullptr) == SQLITE_OK)
+      {
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+          // the fourth column contains the description
+          QString detail = QString::fromUtf8(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)));
+          if (!(plan.isEmpty())) plan += " | ";
+          plan += detail;
+
+          if (isFullTableScan(detail)) hasFullScan = true;
+        }
+      } else {
+        plan = "(not available)";
+      }
+      sqlite3_finalize(stmt);
+
+      if (hasFullScan)
+      {
+        qWarning("Full table scan in SQL statement: %s  [%s]", sql.c_str(), qPrintable(plan));
+      }
+
+      lock_guard<mutex> lk{statsMutex};
+      StatementStats& st = stats.at(sql);
+      st.isPlanCaptured = true;
+      st.hasFullScan = hasFullScan;
+      st.queryPlan = plan;
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool SqlProfiler::writeCsv() const
+  {
+    QFile f{csvFileName};
+    if (!(f.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))) return false;
+    QTextStream out{&f};
+
+    lock_guard<mutex> lk{statsMutex};
+
+    // the most expensive statements first
+    vector<const pair<const string, StatementStats>*> sorted;
+    for (const auto& pr : stats) sorted.push_back(&pr);
+    std::sort(sorted.begin(), sorted.end(), [](const pair<const string, StatementStats>* p1, const pair<const string, StatementStats>* p2) {
+      return (p1->second.total__ns > p2->second.total__ns);
+    });
+
+    out << "statement;count;total_ms;avg_ms;p99_ms;max_ms;full_scan_rows;vm_steps;full_scan;query_plan\n";
+    for (const auto* pr : sorted)
+    {
+      const StatementStats& st = pr->second;
+
+      QStringList cols;
+      cols << quoteCsv(QString::fromUtf8(pr->first.c_str()));
+      cols << QString::number(st.count);
+      cols << QString::number(st.total__ns / 1e6, 'f', 3);
+      cols << QString::number((st.total__ns / 1e6) / st.count, 'f', 3);
+      cols << QString::number(getPercentile(st.samples__ns, 99) / 1e6, 'f', 3);
+      cols << QString::number(st.max__ns / 1e6, 'f', 3);
+      cols << QString::number(st.fullScanSteps);
+      cols << QString::number(st.vmSteps);
+      cols << (st.isPlanCaptured ? (st.hasFullScan ? "yes" : "no") : "");
+      cols << quoteCsv(st.queryPlan);
+
+      out << cols.join(";") << "\n";
+    }
+
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  SqlProfiler::SqlProfiler(const QString& _csvFileName, int _threshold__ms)
+    :csvFileName(_csvFileName), threshold__ns(_threshold__ms * 1000000LL)
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  sqlite3_int64 SqlProfiler::getPercentile(vector<sqlite3_int64> samples, int percent)
+  {
+    if (samples.empty()) return 0;
+
+    size_t idx = (samples.size() * percent) / 100;
+    if (idx >= samples.size()) idx = samples.size() - 1;
+    std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+
+    return samples[idx];
+  }
+
+  //----------------------------------------------------------------------------
+
+  QString SqlProfiler::quoteCsv(const QString& s)
+  {
+    QString result = s;
+    result.replace("\"", "\"\"");
+    return "\"" + result + "\"";
+  }
+
+  //----------------------------------------------------------------------------
+
+}
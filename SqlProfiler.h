@@ -0,0 +1,106 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SQLPROFILER_H
+#define SQLPROFILER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <random>
+
+#include <QString>
+
+#include <sqlite3.h>
+
+using namespace std;
+
+namespace QTournament
+{
+  /*
+   * Opt-in profiling of all SQL statements of all databases.
+   *
+   * The profiler is only active if the environment variable
+   * QTOURNAMENT_SQL_PROFILE contains the name of a CSV file. The optional
+   * variable QTOURNAMENT_SQL_SLOW_MS overrides the default threshold for
+   * logging slow statements.
+   *
+   * TournamentDB reports each completed statement (SQLITE_TRACE_PROFILE).
+   * Statements are aggregated after replacing all literals with "?"; for
+   * each normalized statement we collect the number of executions, the
+   * total and the 99th percentile execution time, the rows that have been
+   * visited by full table scans and the query plan. Statements whose plan
+   * contains a full table scan are flagged in the CSV file.
+   *
+   * recordExecution() can be called from any thread.
+   */
+  class SqlProfiler
+  {
+  public:
+    static constexpr int DEFAULT_SLOW_THRESHOLD__MS = 20;
+    static constexpr size_t MAX_SAMPLES_PER_STATEMENT = 1000;   // for the percentile estimation
+
+    static void initFromEnvironment();
+    static SqlProfiler* getInstance();   // nullptr if not active
+    static bool isActive() { return (instance != nullptr); }
+    static void cleanUp();   // writes the CSV file
+
+    static string normalizeSql(const char* sql);
+    static bool isFullTableScan(const QString& planDetail);
+
+    void recordExecution(const char* sql, sqlite3_int64 duration__ns, int fullScanSteps, int vmSteps);
+
+    // captures the query plans of all statements that have
+    // been executed since the last call; must not be called
+    // from within an SQLite callback
+    void auditQueryPlans(sqlite3* dbPtr);
+
+    bool writeCsv() const;
+
+  private:
+    struct StatementStats
+    {
+      unsigned long count;
+      sqlite3_int64 total__ns;
+      sqlite3_int64 max__ns;
+      vector<sqlite3_int64> samples__ns;
+      unsigned long long fullScanSteps;
+      unsigned long long vmSteps;
+      bool isPlanCaptured;
+      bool hasFullScan;
+      QString queryPlan;
+    };
+
+    SqlProfiler(const QString& _csvFileName, int _threshold__ms);
+    static SqlProfiler* instance;
+
+    QString csvFileName;
+    sqlite3_int64 threshold__ns;
+
+    mutable mutex statsMutex;
+    unordered_map<string, StatementStats> stats;
+    minstd_rand rng;
+
+    static sqlite3_int64 getPercentile(vector<sqlite3_int64> samples, int percent);
+    static QString quoteCsv(const QString& s);
+  };
+
+}
+
+#endif // SQLPROFILER_H
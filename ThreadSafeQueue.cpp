@@ -33,6 +33,8 @@ ProgressQueue::ProgressQueue(int _maxVal)
 
 void ProgressQueue::step(int numSteps)
 {
+  if (cancellationRequested) throw OperationCancelled();
+
   if (numSteps <= 0) return;
 
   // acquire a lock on the mutex
@@ -71,3 +73,13 @@ void ProgressQueue::reset(int _maxVal)
   scaleFac = 100.0 / maxVal;
   counter = 0;
 }
+
+void ProgressQueue::requestCancellation()
+{
+  cancellationRequested = true;
+}
+
+bool ProgressQueue::isCancellationRequested() const
+{
+  return cancellationRequested;
+}
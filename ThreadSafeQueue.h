@@ -25,6 +25,8 @@
 #include <condition_variable>
 #include <memory>
 #include <cassert>
+#include <atomic>
+#include <stdexcept>
 
 using namespace std;
 
@@ -105,6 +107,15 @@ protected:
 
 using ThreadSafeIntQueue = ThreadSafeQueue<int>;
 
+// thrown by ProgressQueue::step() if the consumer of the
+// queue has requested the cancellation of the operation
+class OperationCancelled : public std::runtime_error
+{
+public:
+  OperationCancelled()
+    :std::runtime_error("Operation cancelled by the user") {}
+};
+
 class ProgressQueue : public ThreadSafeIntQueue
 {
 public:
@@ -112,10 +123,17 @@ public:
   void step(int numSteps = 1);
   void reset(int _maxVal = 100);
 
+  // cancellation requests from the consumer's side;
+  // the producer is aborted with an OperationCancelled
+  // exception upon its next call to step()
+  void requestCancellation();
+  bool isCancellationRequested() const;
+
 private:
   int maxVal = 100;
   int counter = 0;
   double scaleFac = 1.0;
+  atomic<bool> cancellationRequested{false};
 };
 
 #endif // THREADSAFEQUEUE_H
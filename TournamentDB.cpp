@@ -19,6 +19,12 @@
 #include <QString>
 #include <QStringList>
 #include <QFile>
+#include <QTimer>
+#include <QCoreApplication>
+
+#include <cstring>
+
+#include <sqlite3.h>
 
 #include <SqliteOverlay/TableCreator.h>
 #include <SqliteOverlay/KeyValueTab.h>
@@ -27,13 +33,69 @@
 #include "TournamentDataDefs.h"
 #include "HelperFunc.h"
 #include "TournamentErrorCodes.h"
+#include "RefereeCandidateIndex.h"
+#include "PlayerScheduleIndex.h"
+#include "MatchCounterCache.h"
+#include "ChangeJournal.h"
+#include "SnapshotStore.h"
+#include "SqlProfiler.h"
+#include "CentralSignalEmitter.h"
 
 namespace QTournament
 {
+  // allocate static variables
+  bool TournamentDB::isStatementCountingEnabled = false;
+  std::atomic<unsigned long> TournamentDB::statementCount{0};
+  constexpr size_t TournamentDB::MAX_PENDING_CAT_CHANGES;
+  constexpr size_t TournamentDB::MAX_PENDING_ROW_CHANGES;
+  std::atomic<unsigned long> TournamentDB::versionClock{0};
+
+  namespace
+  {
+    // tables with rows that belong to a category and the
+    // column that refers to the category; matches refer
+    // to their category via their match group
+    struct CatRelatedTable
+    {
+      const char* tabName;
+      const char* catRefCol;
+    };
+
+    const CatRelatedTable catRelatedTables[] = {
+      {TAB_P2C, P2C_CAT_REF},
+      {TAB_PAIRS, PAIRS_CAT_REF},
+      {TAB_MATCH_GROUP, MG_CAT_REF},
+      {TAB_MATCH, nullptr},
+      {TAB_RANKING, RA_CAT_REF},
+      {TAB_BRACKET_VIS, BV_CAT_REF},
+    };
+  }
+
+  TournamentDB::TournamentDB(string fName, bool createNew, ConnectionRole role)
+    : SqliteOverlay::SqliteDatabase(fName, createNew), connectionRole{role}, writeLocked{false}, hasExternalChanges{false}, externalChangeCount{0}, curTrans{nullptr}, refereeCandidateIndex{nullptr},
+      playerScheduleIndex{nullptr}, matchCounterCache{nullptr}, isRowFeedOverflow{false}
+  {
+    unsigned traceMask = 0;
+    if (isStatementCountingEnabled) traceMask |= SQLITE_TRACE_STMT;
+    if (SqlProfiler::isActive()) traceMask |= SQLITE_TRACE_PROFILE;
+    if (traceMask != 0)
+    {
+      sqlite3_trace_v2(dbPtr, traceMask, &TournamentDB::traceCallback, this);
+    }
+
+    resetDataVersions();
+    sqlite3_update_hook(dbPtr, &TournamentDB::updateHookCallback, this);
+    sqlite3_commit_hook(dbPtr, &TournamentDB::commitHookCallback, this);
+    sqlite3_rollback_hook(dbPtr, &TournamentDB::rollbackHookCallback, this);
+  }
 
-  TournamentDB::TournamentDB(string fName, bool createNew)
-    : SqliteOverlay::SqliteDatabase(fName, createNew), curTrans{nullptr}
+  //----------------------------------------------------------------------------
+
+  TournamentDB::~TournamentDB()
   {
+    // a connection that has been opened from a shared image has to
+    // be closed before the image can be released with our members
+    if (sourceImage != nullptr) close();
   }
 
   //----------------------------------------------------------------------------
@@ -105,6 +167,15 @@ namespace QTournament
       // destroyed when leaving the scope
     }
 
+    // add indices and derived tables that have been introduced
+    // after the file has been created; files that need a
+    // conversion get them during the conversion
+    if (!(newDb->needsConversion()))
+    {
+      newDb->createMissingIndices();
+      newDb->createMatchDisplayTable();
+    }
+
     // return the new database pointer
     if (err != nullptr) *err = OK;
     return newDb;
@@ -112,6 +183,34 @@ namespace QTournament
 
   //----------------------------------------------------------------------------
 
+  unique_ptr<TournamentDB> TournamentDB::loadIntoMemory(const QString& fName, int* dbErr)
+  {
+    auto newDb = SqliteOverlay::SqliteDatabase::get<TournamentDB>(":memory:", true);
+    if (newDb == nullptr)
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_ERROR);
+      return nullptr;
+    }
+
+    int err;
+    newDb->restoreFromFile(fName.toUtf8().constData(), &err);
+    newDb->setLogLevel(Sloppy::Logger::SeverityLevel::error);
+    Sloppy::assignIfNotNull<int>(dbErr, err);
+    if (err != SQLITE_OK) return nullptr;
+
+    // the restore has replaced the main schema without firing
+    // any triggers, so the match display table is still empty
+    if (!(newDb->rebuildMatchDisplayTable()))
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_ERROR);
+      return nullptr;
+    }
+
+    return newDb;
+  }
+
+  //----------------------------------------------------------------------------
+
   void TournamentDB::populateTables()
   {
     SqliteOverlay::TableCreator tc{this};
@@ -247,7 +346,7 @@ namespace QTournament
 
   void TournamentDB::populateViews()
   {
-
+    createMatchDisplayTable();
   }
 
   //----------------------------------------------------------------------------
@@ -275,7 +374,7 @@ namespace QTournament
     indexCreationHelper(TAB_P2C, P2C_PLAYER_REF);
 
     indexCreationHelper(TAB_PAIRS, PAIRS_PLAYER1_REF);
-    indexCreationHelper(TAB_PAIRS, PAIRS_PLAYER1_REF);
+    indexCreationHelper(TAB_PAIRS, PAIRS_PLAYER2_REF);
     indexCreationHelper(TAB_PAIRS, PAIRS_CAT_REF);
 
     indexCreationHelper(TAB_MATCH_GROUP, MG_CAT_REF);
@@ -299,6 +398,296 @@ namespace QTournament
     indexCreationHelper(TAB_BRACKET_VIS, BV_PAIR2_REF);
 
     //indexCreationHelper(TAB_, );
+
+    createCompositeIndices();
+    createMissingIndices();
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool TournamentDB::createCompositeIndices()
+  {
+    // indices for queries that filter on more than one column;
+    // introduced with file format version 2.4
+    Sloppy::StringList sqlList;
+
+    // calling and predicting matches: state plus match number
+    QString sql = "CREATE INDEX IF NOT EXISTS %1 ON %2(%3, %4)";
+    sql = sql.arg(IDX_MATCH_STATE_NUM).arg(TAB_MATCH).arg(GENERIC_STATE_FIELD_NAME).arg(MA_NUM);
+    sqlList.push_back(QString2StdString(sql));
+
+    // sorted rankings per category, round and group; the
+    // rank makes the index cover the ORDER BY as well
+    sql = "CREATE INDEX IF NOT EXISTS %1 ON %2(%3, %4, %5, %6)";
+    sql = sql.arg(IDX_RANKING_CAT_ROUND_GRP).arg(TAB_RANKING).arg(RA_CAT_REF).arg(RA_ROUND).arg(RA_GRP_NUM).arg(RA_RANK);
+    sqlList.push_back(QString2StdString(sql));
+
+    // MatchMngr::getMatchGroup()
+    sql = "CREATE INDEX IF NOT EXISTS %1 ON %2(%3, %4, %5)";
+    sql = sql.arg(IDX_MATCH_GROUP_CAT_ROUND_GRP).arg(TAB_MATCH_GROUP).arg(MG_CAT_REF).arg(MG_ROUND).arg(MG_GRP_NUM);
+    sqlList.push_back(QString2StdString(sql));
+
+    for (const string& s : sqlList)
+    {
+      int dbErr;
+      if (!(execNonQuery(s.c_str(), &dbErr))) return false;
+    }
+
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::createMissingIndices()
+  {
+    // indices that have been added without a change of the
+    // file format. They don't harm older versions of QTournament,
+    // so we simply create them if they don't exist yet.
+    Sloppy::StringList sqlList;
+
+    // lookups and range queries for match numbers
+    QString sql = "CREATE INDEX IF NOT EXISTS %1_%2 ON %1(%2)";
+    sqlList.push_back(QString2StdString(sql.arg(TAB_MATCH).arg(MA_NUM)));
+
+    for (const string& s : sqlList)
+    {
+      int dbErr;
+      execNonQuery(s.c_str(), &dbErr);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool TournamentDB::createMatchDisplayTable()
+  {
+    //
+    // the match display table is a materialized version of the
+    // view VIEW_MATCH_DISPLAY that joins each match with its group,
+    // category, player pairs, players, teams and umpire.
+    //
+    // Triggers on the base tables keep the table up to date, so
+    // listing a match only requires a single indexed lookup. The
+    // table and its triggers live in the TEMP schema of the connection,
+    // so they never end up in the tournament file and the table is
+    // rebuilt from scratch whenever a file is opened.
+    //
+
+    auto fullName = [](const char* alias) {
+      QString s = "%1.%2 || ', ' || %1.%3";
+      return s.arg(alias).arg(PL_LNAME).arg(PL_FNAME);
+    };
+
+    // "Team A / Team B" if the players of a pair are in different teams
+    auto teamName = [](const char* alias1, const char* alias2) {
+      QString s = "CASE WHEN %2.id IS NULL OR %2.id = %1.id THEN %1.%3 ELSE %1.%3 || ' / ' || %2.%3 END";
+      return s.arg(alias1).arg(alias2).arg(GENERIC_NAME_FIELD_NAME);
+    };
+
+    // same logic as in Match::getSymbolicPlayerPairName(): the number of the
+    // match that the symbolic name refers to, positive for the winner,
+    // negative for the loser and zero if there is no symbolic name (yet)
+    auto symName = [](const char* ppCol, const char* symCol, const char* alias) {
+      QString s = "CASE WHEN m.%1 IS NOT NULL OR %3.%4 IS NULL OR %3.%4 < 1 THEN 0 WHEN m.%2 > 0 THEN %3.%4 ELSE -%3.%4 END";
+      return s.arg(ppCol).arg(symCol).arg(alias).arg(MA_NUM);
+    };
+
+    auto col = [](const char* alias, const char* colName) {
+      return QString("%1.%2").arg(alias).arg(colName);
+    };
+
+    struct MatchDisplayCol
+    {
+      const char* colName;
+      const char* colType;
+      QString expr;
+    };
+
+    const vector<MatchDisplayCol> allCols{
+      {"id", "INTEGER PRIMARY KEY", "m.id"},
+      {GENERIC_SEQNUM_FIELD_NAME, "INTEGER", col("m", GENERIC_SEQNUM_FIELD_NAME)},
+      {MA_NUM, "INTEGER", col("m", MA_NUM)},
+      {GENERIC_STATE_FIELD_NAME, "INTEGER", col("m", GENERIC_STATE_FIELD_NAME)},
+      {MA_GRP_REF, "INTEGER", col("m", MA_GRP_REF)},
+      {MD_CAT_REF, "INTEGER", col("g", MG_CAT_REF)},
+      {MD_CAT_NAME, "TEXT", col("c", GENERIC_NAME_FIELD_NAME)},
+      {MD_MATCH_SYSTEM, "INTEGER", col("c", CAT_SYS)},
+      {MD_ROUND, "INTEGER", col("g", MG_ROUND)},
+      {MD_GRP_NUM, "INTEGER", col("g", MG_GRP_NUM)},
+      {MA_WINNER_RANK, "INTEGER", col("m", MA_WINNER_RANK)},
+      {MA_REFEREE_MODE, "INTEGER", col("m", MA_REFEREE_MODE)},
+      {MA_REFEREE_REF, "INTEGER", col("m", MA_REFEREE_REF)},
+      {MD_REFEREE_NAME, "TEXT", fullName("rf")},
+      {MA_COURT_REF, "INTEGER", col("m", MA_COURT_REF)},
+      {MA_PAIR1_REF, "INTEGER", col("m", MA_PAIR1_REF)},
+      {MA_PAIR2_REF, "INTEGER", col("m", MA_PAIR2_REF)},
+      {MD_PAIR1_SYMBOLIC_NAME, "INTEGER", symName(MA_PAIR1_REF, MA_PAIR1_SYMBOLIC_VAL, "sm1")},
+      {MD_PAIR2_SYMBOLIC_NAME, "INTEGER", symName(MA_PAIR2_REF, MA_PAIR2_SYMBOLIC_VAL, "sm2")},
+      {MD_PAIR1_PLAYER1_NAME, "TEXT", fullName("p11")},
+      {MD_PAIR1_PLAYER2_NAME, "TEXT", fullName("p12")},
+      {MD_PAIR2_PLAYER1_NAME, "TEXT", fullName("p21")},
+      {MD_PAIR2_PLAYER2_NAME, "TEXT", fullName("p22")},
+      {MD_PAIR1_TEAM_NAME, "TEXT", teamName("t11", "t12")},
+      {MD_PAIR2_TEAM_NAME, "TEXT", teamName("t21", "t22")},
+    };
+
+    QStringList colNames;
+    QStringList colDefs;
+    QStringList selectList;
+    for (const MatchDisplayCol& mdc : allCols)
+    {
+      colNames.append(mdc.colName);
+      colDefs.append(QString("%1 %2").arg(mdc.colName).arg(mdc.colType));
+      selectList.append(QString("%1 AS %2").arg(mdc.expr).arg(mdc.colName));
+    }
+
+    QStringList joins;
+    joins.append(QString("%1 m").arg(TAB_MATCH));
+    auto addJoin = [&joins](const char* tabName, const char* alias, const QString& refExpr) {
+      QString s = "LEFT JOIN %1 %2 ON %2.id = %3";
+      joins.append(s.arg(tabName).arg(alias).arg(refExpr));
+    };
+    addJoin(TAB_MATCH_GROUP, "g", col("m", MA_GRP_REF));
+    addJoin(TAB_CATEGORY, "c", col("g", MG_CAT_REF));
+    addJoin(TAB_PAIRS, "pp1", col("m", MA_PAIR1_REF));
+    addJoin(TAB_PAIRS, "pp2", col("m", MA_PAIR2_REF));
+    addJoin(TAB_PLAYER, "p11", col("pp1", PAIRS_PLAYER1_REF));
+    addJoin(TAB_PLAYER, "p12", col("pp1", PAIRS_PLAYER2_REF));
+    addJoin(TAB_PLAYER, "p21", col("pp2", PAIRS_PLAYER1_REF));
+    addJoin(TAB_PLAYER, "p22", col("pp2", PAIRS_PLAYER2_REF));
+    addJoin(TAB_TEAM, "t11", col("p11", PL_TEAM_REF));
+    addJoin(TAB_TEAM, "t12", col("p12", PL_TEAM_REF));
+    addJoin(TAB_TEAM, "t21", col("p21", PL_TEAM_REF));
+    addJoin(TAB_TEAM, "t22", col("p22", PL_TEAM_REF));
+    addJoin(TAB_PLAYER, "rf", col("m", MA_REFEREE_REF));
+    addJoin(TAB_MATCH, "sm1", QString("abs(m.%1)").arg(MA_PAIR1_SYMBOLIC_VAL));
+    addJoin(TAB_MATCH, "sm2", QString("abs(m.%1)").arg(MA_PAIR2_SYMBOLIC_VAL));
+
+    // (re-)materializes all matches that match a where clause
+    auto refresh = [&colNames](const QString& whereClause) {
+      QString s = "INSERT OR REPLACE INTO %1 (%2) SELECT %2 FROM %3 WHERE %4;";
+      return s.arg(TAB_MATCH_DISPLAY).arg(colNames.join(", ")).arg(VIEW_MATCH_DISPLAY).arg(whereClause);
+    };
+
+    // all matches that involve a set of player pairs
+    auto matchesWithPairs = [](const QString& pairSelect) {
+      QString s = "id IN (SELECT id FROM %1 WHERE %2 IN (%4) OR %3 IN (%4))";
+      return s.arg(TAB_MATCH).arg(MA_PAIR1_REF).arg(MA_PAIR2_REF).arg(pairSelect);
+    };
+
+    // all player pairs that contain a set of players
+    auto pairsWithPlayers = [](const QString& playerSelect) {
+      QString s = "SELECT id FROM %1 WHERE %2 IN (%4) OR %3 IN (%4)";
+      return s.arg(TAB_PAIRS).arg(PAIRS_PLAYER1_REF).arg(PAIRS_PLAYER2_REF).arg(playerSelect);
+    };
+
+    Sloppy::StringList sqlList;
+
+    QString sql = "CREATE TEMP VIEW IF NOT EXISTS %1 AS SELECT %2 FROM %3";
+    sql = sql.arg(VIEW_MATCH_DISPLAY).arg(selectList.join(", ")).arg(joins.join(" "));
+    sqlList.push_back(QString2StdString(sql));
+
+    sql = "CREATE TEMP TABLE IF NOT EXISTS %1 (%2)";
+    sql = sql.arg(TAB_MATCH_DISPLAY).arg(colDefs.join(", "));
+    sqlList.push_back(QString2StdString(sql));
+
+    // indices for the typical lookups; the sequence number index
+    // is not unique because sequence numbers are shifted one match
+    // at a time when matches are deleted
+    for (const char* colName : {GENERIC_SEQNUM_FIELD_NAME, MA_NUM})
+    {
+      sql = "CREATE INDEX IF NOT EXISTS temp.%1_%2 ON %1(%2)";
+      sqlList.push_back(QString2StdString(sql.arg(TAB_MATCH_DISPLAY).arg(colName)));
+    }
+
+    // always start from scratch, in case we're called
+    // on a connection that already has the table
+    sql = "DELETE FROM temp.%1";
+    sqlList.push_back(QString2StdString(sql.arg(TAB_MATCH_DISPLAY)));
+    sql = "INSERT INTO temp.%1 (%2) SELECT %2 FROM temp.%3";
+    sql = sql.arg(TAB_MATCH_DISPLAY).arg(colNames.join(", ")).arg(VIEW_MATCH_DISPLAY);
+    sqlList.push_back(QString2StdString(sql));
+
+    // the triggers
+    QString where;
+    QString trigger = "CREATE TEMP TRIGGER IF NOT EXISTS %1_%2 AFTER %3 ON %4 BEGIN %5 END";
+    trigger = trigger.arg(TAB_MATCH_DISPLAY);
+
+    sql = trigger.arg("MatchInsert").arg("INSERT").arg(TAB_MATCH).arg(refresh("id = NEW.id"));
+    sqlList.push_back(QString2StdString(sql));
+
+    // only the columns that show up in the table; the match number
+    // of other matches' symbolic names is handled by "MatchNumber"
+    QStringList matchCols{GENERIC_SEQNUM_FIELD_NAME, MA_NUM, GENERIC_STATE_FIELD_NAME, MA_GRP_REF, MA_WINNER_RANK,
+                          MA_REFEREE_MODE, MA_REFEREE_REF, MA_COURT_REF, MA_PAIR1_REF, MA_PAIR2_REF,
+                          MA_PAIR1_SYMBOLIC_VAL, MA_PAIR2_SYMBOLIC_VAL};
+    sql = QString("UPDATE OF %1").arg(matchCols.join(", "));
+    sql = trigger.arg("MatchUpdate").arg(sql).arg(TAB_MATCH).arg(refresh("id = NEW.id"));
+    sqlList.push_back(QString2StdString(sql));
+
+    sql = "DELETE FROM %1 WHERE id = OLD.id;";
+    sql = trigger.arg("MatchDelete").arg("DELETE").arg(TAB_MATCH).arg(sql.arg(TAB_MATCH_DISPLAY));
+    sqlList.push_back(QString2StdString(sql));
+
+    // matches with symbolic names show the number of the referenced match
+    sql = "id IN (SELECT id FROM %1 WHERE %2 IN (NEW.id, -NEW.id) OR %3 IN (NEW.id, -NEW.id))";
+    sql = sql.arg(TAB_MATCH).arg(MA_PAIR1_SYMBOLIC_VAL).arg(MA_PAIR2_SYMBOLIC_VAL);
+    sql = trigger.arg("MatchNumber").arg(QString("UPDATE OF %1").arg(MA_NUM)).arg(TAB_MATCH).arg(refresh(sql));
+    sqlList.push_back(QString2StdString(sql));
+
+    sql = QString("UPDATE OF %1, %2, %3").arg(MG_CAT_REF).arg(MG_ROUND).arg(MG_GRP_NUM);
+    sql = trigger.arg("GroupUpdate").arg(sql).arg(TAB_MATCH_GROUP).arg(refresh(QString("%1 = NEW.id").arg(MA_GRP_REF)));
+    sqlList.push_back(QString2StdString(sql));
+
+    where = "%1 IN (SELECT id FROM %2 WHERE %3 = NEW.id)";
+    where = where.arg(MA_GRP_REF).arg(TAB_MATCH_GROUP).arg(MG_CAT_REF);
+    sql = QString("UPDATE OF %1, %2").arg(GENERIC_NAME_FIELD_NAME).arg(CAT_SYS);
+    sql = trigger.arg("CategoryUpdate").arg(sql).arg(TAB_CATEGORY).arg(refresh(where));
+    sqlList.push_back(QString2StdString(sql));
+
+    sql = QString("UPDATE OF %1, %2").arg(PAIRS_PLAYER1_REF).arg(PAIRS_PLAYER2_REF);
+    sql = trigger.arg("PairUpdate").arg(sql).arg(TAB_PAIRS).arg(refresh(matchesWithPairs("NEW.id")));
+    sqlList.push_back(QString2StdString(sql));
+
+    where = "%1 OR id IN (SELECT id FROM %2 WHERE %3 = NEW.id)";
+    where = where.arg(matchesWithPairs(pairsWithPlayers("NEW.id"))).arg(TAB_MATCH).arg(MA_REFEREE_REF);
+    sql = QString("UPDATE OF %1, %2, %3").arg(PL_FNAME).arg(PL_LNAME).arg(PL_TEAM_REF);
+    sql = trigger.arg("PlayerUpdate").arg(sql).arg(TAB_PLAYER).arg(refresh(where));
+    sqlList.push_back(QString2StdString(sql));
+
+    where = "SELECT id FROM %1 WHERE %2 = NEW.id";
+    where = matchesWithPairs(pairsWithPlayers(where.arg(TAB_PLAYER).arg(PL_TEAM_REF)));
+    sql = QString("UPDATE OF %1").arg(GENERIC_NAME_FIELD_NAME);
+    sql = trigger.arg("TeamUpdate").arg(sql).arg(TAB_TEAM).arg(refresh(where));
+    sqlList.push_back(QString2StdString(sql));
+
+    // create everything in one transaction so that we never
+    // end up with a table that hasn't been filled
+    bool isDbErr;
+    auto tg = acquireTransactionGuard(false, &isDbErr);
+    if (isDbErr) return false;
+
+    int dbErr;
+    for (const string& s : sqlList)
+    {
+      if (!(execNonQuery(s.c_str(), &dbErr))) return false;   // implicit rollback through tg's dtor
+    }
+
+    return (tg == nullptr) ? true : tg->commit(&dbErr);
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool TournamentDB::rebuildMatchDisplayTable()
+  {
+    // no TransactionGuard here: the caller is in the middle of
+    // replacing the database content and takes care of notifying
+    // the row change subscribers when it's done
+    QString sql = "BEGIN; DELETE FROM temp.%1; INSERT INTO temp.%1 SELECT * FROM temp.%2; COMMIT;";
+    sql = sql.arg(TAB_MATCH_DISPLAY).arg(VIEW_MATCH_DISPLAY);
+    if (sqlite3_exec(dbPtr, sql.toUtf8().constData(), nullptr, nullptr, nullptr) == SQLITE_OK) return true;
+
+    sqlite3_exec(dbPtr, "ROLLBACK", nullptr, nullptr, nullptr);
+    return false;
   }
 
   //----------------------------------------------------------------------------
@@ -461,6 +850,26 @@ namespace QTournament
       minor = 3;
     }
 
+    // convert from 2.3 to 2.4
+    if (minor == 3)
+    {
+      // older versions indexed the first player of a pair twice
+      // and the second player not at all
+      QString sql = "CREATE INDEX IF NOT EXISTS %1_%2 ON %1(%2)";
+      sql = sql.arg(TAB_PAIRS).arg(PAIRS_PLAYER2_REF);
+      int dbErr;
+      bool isOkay = execNonQuery(sql.toUtf8().constData(), &dbErr);
+      if (!isOkay) return false;
+
+      isOkay = createCompositeIndices();
+      if (!isOkay) return false;
+
+      minor = 4;
+    }
+
+    createMissingIndices();
+    if (!(createMatchDisplayTable())) return false;
+
     // store the new database version
     QString dbVersion = "%1.%2";
     dbVersion = dbVersion.arg(DB_VERSION_MAJOR);
@@ -497,7 +906,15 @@ namespace QTournament
 
     bool isOkay = curTrans->commit(dbErr);
 
-    if (isOkay) curTrans.reset();
+    if (isOkay)
+    {
+      curTrans.reset();
+
+      // make the committed changes durable before we return
+      if (changeJournal != nullptr) changeJournal->flush();
+
+      publishRowChanges();
+    }
 
     return isOkay;
   }
@@ -543,8 +960,694 @@ namespace QTournament
 
   //----------------------------------------------------------------------------
 
+  void TournamentDB::setStatementCountingEnabled(bool isEnabled)
+  {
+    isStatementCountingEnabled = isEnabled;
+  }
+
+  //----------------------------------------------------------------------------
+
+  unsigned long TournamentDB::getStatementCount()
+  {
+    return statementCount.load();
+  }
+
+  //----------------------------------------------------------------------------
+
+  int TournamentDB::traceCallback(unsigned traceType, void* ctx, void* p, void* x)
+  {
+    if (traceType == SQLITE_TRACE_STMT) ++statementCount;
+
+    if (traceType == SQLITE_TRACE_PROFILE)
+    {
+      // p: the statement; x: the execution time in nanoseconds.
+      // Reset the statement counters so that we get the
+      // values for this execution only.
+      sqlite3_stmt* stmt = static_cast<sqlite3_stmt*>(p);
+      sqlite3_int64 duration = *static_cast<sqlite3_int64*>(x);
+      int fullScanSteps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_FULLSCAN_STEP, 1);
+      int vmSteps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 1);
+      SqlProfiler::getInstance()->recordExecution(sqlite3_sql(stmt), duration, fullScanSteps, vmSteps);
+    }
+
+    return 0;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::auditQueryPlans()
+  {
+    if (SqlProfiler::isActive()) SqlProfiler::getInstance()->auditQueryPlans(dbPtr);
+  }
+
+  //----------------------------------------------------------------------------
+
+  RefereeCandidateIndex* TournamentDB::getRefereeCandidateIndex()
+  {
+    // create the index on first use; it will be populated lazily
+    // upon the first query
+    if (refereeCandidateIndex == nullptr)
+    {
+      refereeCandidateIndex = make_unique<RefereeCandidateIndex>(this);
+    }
+
+    return refereeCandidateIndex.get();
+  }
+
+  //----------------------------------------------------------------------------
+
+  PlayerScheduleIndex* TournamentDB::getPlayerScheduleIndex()
+  {
+    if (playerScheduleIndex == nullptr)
+    {
+      playerScheduleIndex = make_unique<PlayerScheduleIndex>(this);
+    }
+
+    return playerScheduleIndex.get();
+  }
+
+  //----------------------------------------------------------------------------
+
+  MatchCounterCache* TournamentDB::getMatchCounterCache()
+  {
+    if (matchCounterCache == nullptr)
+    {
+      matchCounterCache = make_unique<MatchCounterCache>(this);
+    }
+
+    return matchCounterCache.get();
+  }
+
+  //----------------------------------------------------------------------------
+
+  unique_ptr<TournamentDB> TournamentDB::createInMemoryCopy(ConnectionRole role, int* dbErr)
+  {
+    if (role == ConnectionRole::Primary)
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_MISUSE);
+      return nullptr;
+    }
+
+    // read-only snapshots don't need a copy of their own
+    if (role == ConnectionRole::ReadOnlySnapshot)
+    {
+      auto img = getSnapshotImage(dbErr);
+      if (img == nullptr) return nullptr;
+      return openSnapshotImage(img, dbErr);
+    }
+
+    // the schema is copied along with the content, so we
+    // skip populateTables() / populateViews() here
+    auto newDb = openSecondaryConnection(role, dbErr);
+    if (newDb == nullptr) return nullptr;
+
+    if (!(copyContentTo(newDb.get(), dbErr))) return nullptr;
+
+    return newDb;
+  }
+
+  //----------------------------------------------------------------------------
+
+  shared_ptr<const DatabaseImage> TournamentDB::getSnapshotImage(int* dbErr)
+  {
+    // re-use the last image if nothing has changed since then
+    if ((lastSnapshotImage != nullptr) && (lastSnapshotImage->getVersion() == dbVersion))
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_OK);
+      return lastSnapshotImage;
+    }
+
+    // the image would contain the changes
+    // of a not yet committed transaction
+    if (!(sqlite3_get_autocommit(dbPtr)))
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_BUSY);
+      return nullptr;
+    }
+
+    sqlite3_int64 size = 0;
+    unsigned char* data = sqlite3_serialize(dbPtr, "main", &size, 0);
+    if (data == nullptr)
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_NOMEM);
+      return nullptr;
+    }
+
+    lastSnapshotImage = make_shared<DatabaseImage>(data, size, dbVersion);
+    Sloppy::assignIfNotNull<int>(dbErr, SQLITE_OK);
+    return lastSnapshotImage;
+  }
+
+  //----------------------------------------------------------------------------
+
+  unique_ptr<TournamentDB> TournamentDB::openSnapshotImage(const shared_ptr<const DatabaseImage>& img, int* dbErr)
+  {
+    if (img == nullptr)
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_MISUSE);
+      return nullptr;
+    }
+
+    auto newDb = openSecondaryConnection(ConnectionRole::ReadOnlySnapshot, dbErr);
+    if (newDb == nullptr) return nullptr;
+
+    // the connection works directly on the shared image; SQLite
+    // never modifies or frees the memory of a read-only image and
+    // rejects all attempts to modify the snapshot
+    newDb->sourceImage = img;
+    int err = sqlite3_deserialize(newDb->dbPtr, "main", img->getData(), img->getSize(), img->getSize(), SQLITE_DESERIALIZE_READONLY);
+    Sloppy::assignIfNotNull<int>(dbErr, err);
+    if (err != SQLITE_OK) return nullptr;
+
+    // the deserialization doesn't trigger the update
+    // hook, so we have to consider all data as modified
+    newDb->resetDataVersions();
+
+    return newDb;
+  }
+
+  //----------------------------------------------------------------------------
+
+  unique_ptr<TournamentDB> TournamentDB::openSecondaryConnection(ConnectionRole role, int* dbErr)
+  {
+    // we don't use SqliteDatabase::get() here because it would
+    // create the full schema in a connection that is overwritten
+    // immediately afterwards. Furthermore, the role has to be known
+    // before the first statement is executed, otherwise the connection
+    // would interfere with the signals of the primary connection.
+    unique_ptr<TournamentDB> newDb;
+    try
+    {
+      newDb.reset(new TournamentDB(":memory:", false, role));
+    }
+    catch (std::exception&)
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_ERROR);
+      return nullptr;
+    }
+    newDb->setLogLevel(Sloppy::Logger::SeverityLevel::error);
+
+    return newDb;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool TournamentDB::copyContentTo(TournamentDB* dst, int* dbErr)
+  {
+    if ((dst == nullptr) || (dst == this))
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_MISUSE);
+      return false;
+    }
+
+    // we can't copy into a database with pending modifications
+    if (dst->isTransactionRunning())
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_BUSY);
+      return false;
+    }
+
+    if (dst->isWriteLocked())
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_READONLY);
+      return false;
+    }
+
+    // the backup bypasses the change journal of the destination,
+    // so we let the journal record the difference instead
+    ChangeJournal* cj = dst->changeJournal.get();
+    if ((cj != nullptr) && (cj->beginExternalChange() != OK))
+    {
+      // without the difference, a crash recovery would apply all
+      // later changes to the wrong base; the autosave falls back
+      // to full copies of the database
+      dst->stopChangeJournal(true);
+      cj = nullptr;
+    }
+
+    sqlite3_backup* bck = sqlite3_backup_init(dst->dbPtr, "main", dbPtr, "main");
+    if (bck == nullptr)
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, sqlite3_errcode(dst->dbPtr));
+      if ((cj != nullptr) && (cj->endExternalChange() != OK)) dst->stopChangeJournal(true);
+      return false;
+    }
+
+    // copy everything in one step; both databases
+    // are usually in memory so this is fast
+    sqlite3_backup_step(bck, -1);
+    int err = sqlite3_backup_finish(bck);
+    Sloppy::assignIfNotNull<int>(dbErr, err);
+
+    // also called after a failed backup because
+    // parts of the content might have been copied
+    if ((cj != nullptr) && (cj->endExternalChange() != OK)) dst->stopChangeJournal(true);
+
+    // the backup only replaces the main schema; the match
+    // display table in the TEMP schema is now outdated
+    if (dst->connectionRole == ConnectionRole::Primary) dst->rebuildMatchDisplayTable();
+
+    // the backup doesn't trigger the update hook, so
+    // we have to consider all data as modified
+    dst->resetDataVersions();
+
+    // the backup doesn't count as a modification either; but the
+    // new content of the tournament database has to be saved
+    if (dst->connectionRole == ConnectionRole::Primary) dst->markDirty();
+
+    // the same holds for the subscribers of the row change feed;
+    // they get an overflow in the next event loop iteration, after
+    // the caller has finished replacing the content (e.g., a model reset)
+    if (dst->connectionRole == ConnectionRole::Primary)
+    {
+      dst->uncommittedRowChanges.clear();
+      dst->committedRowChanges.clear();
+      dst->isRowFeedOverflow = true;
+      dst->scheduleRowChangePublication();
+    }
+
+    return (err == SQLITE_OK);
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool TournamentDB::setWriteLocked(bool isLocked, int* dbErr)
+  {
+    // secondary connections are never modified by the GUI
+    if (connectionRole != ConnectionRole::Primary)
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_MISUSE);
+      return false;
+    }
+
+    if (isLocked == writeLocked)
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_OK);
+      return true;
+    }
+
+    // a running transaction would be stuck with a lock
+    if (isLocked && isTransactionRunning())
+    {
+      Sloppy::assignIfNotNull<int>(dbErr, SQLITE_BUSY);
+      return false;
+    }
+
+    // SQLite rejects every statement that would modify the
+    // database, no matter which part of the program issues it
+    int err = sqlite3_exec(dbPtr, isLocked ? "PRAGMA query_only = ON" : "PRAGMA query_only = OFF", nullptr, nullptr, nullptr);
+    Sloppy::assignIfNotNull<int>(dbErr, err);
+    if (err != SQLITE_OK) return false;
+
+    writeLocked = isLocked;
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::markDirty()
+  {
+    hasExternalChanges = true;
+
+    // the autosave compares dirty counters
+    ++externalChangeCount;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool TournamentDB::isDirty()
+  {
+    return (hasExternalChanges || SqliteDatabase::isDirty());
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::resetDirtyFlag()
+  {
+    hasExternalChanges = false;
+    SqliteDatabase::resetDirtyFlag();
+  }
+
+  //----------------------------------------------------------------------------
+
+  int TournamentDB::getDirtyCounter()
+  {
+    return SqliteDatabase::getDirtyCounter() + externalChangeCount;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool TournamentDB::startChangeJournal(const QString& journalFileName)
+  {
+    // private copies are never saved, so they don't need a journal
+    if (connectionRole != ConnectionRole::Primary) return false;
+
+    changeJournal.reset();
+    auto cj = make_unique<ChangeJournal>(dbPtr, journalFileName);
+    if (!(cj->isValid())) return false;
+
+    changeJournal = std::move(cj);
+    return true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::stopChangeJournal(bool removeFile)
+  {
+    if (changeJournal == nullptr) return;
+
+    QString fName = changeJournal->getFileName();
+    changeJournal.reset();
+
+    if (removeFile) QFile::remove(fName);
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR TournamentDB::replayChangeJournal(const QString& journalFileName, int* nRecords)
+  {
+    // don't record the replayed changes in a running journal
+    if (changeJournal != nullptr) return WRONG_STATE;
+
+    return ChangeJournal::replay(dbPtr, journalFileName, nRecords);
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR TournamentDB::createSnapshot(SnapshotStore& store, const QString& label, int* newSnapId)
+  {
+    return store.createSnapshot(dbPtr, label, newSnapId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  unsigned long TournamentDB::getTableVersion(const string& tabName) const
+  {
+    auto it = tabVersions.find(tabName);
+
+    // tables without changes have the initial version
+    // of the database
+    return (it == tabVersions.end()) ? baseVersion : it->second;
+  }
+
+  //----------------------------------------------------------------------------
+
+  unsigned long TournamentDB::getCategoryVersion(int catId)
+  {
+    resolvePendingCatChanges();
+
+    auto it = catVersions.find(catId);
+    if (it == catVersions.end()) return allCatsVersion;
+
+    return max(it->second, allCatsVersion);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::updateHookCallback(void* ctx, int op, const char* dbName, const char* tabName, sqlite3_int64 rowId)
+  {
+    static_cast<TournamentDB*>(ctx)->onRowChanged(op, tabName, rowId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  int TournamentDB::commitHookCallback(void* ctx)
+  {
+    // explicit transactions are flushed to the journal
+    // by commitRunningTransaction()
+    TournamentDB* db = static_cast<TournamentDB*>(ctx);
+    if ((db->changeJournal != nullptr) && (db->curTrans == nullptr)) db->changeJournal->onCommit();
+
+    if (!(db->uncommittedRowChanges.empty()))
+    {
+      auto& committed = db->committedRowChanges;
+      auto& uncommitted = db->uncommittedRowChanges;
+      committed.insert(committed.end(), make_move_iterator(uncommitted.begin()), make_move_iterator(uncommitted.end()));
+      uncommitted.clear();
+    }
+
+    // the commit of a running transaction publishes the changes
+    // itself; auto-committed statements are published later
+    // because we must not access the database from within the hook
+    if ((db->curTrans == nullptr) && (db->connectionRole == ConnectionRole::Primary)) db->scheduleRowChangePublication();
+
+    return 0;   // don't convert the commit into a rollback
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::rollbackHookCallback(void* ctx)
+  {
+    TournamentDB* db = static_cast<TournamentDB*>(ctx);
+    db->uncommittedRowChanges.clear();
+
+    // the indices might contain data that has been rolled back
+    if (db->connectionRole == ConnectionRole::PrivateCopy) db->invalidateIndices();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::onRowChanged(int op, const char* tabName, sqlite3_int64 rowId)
+  {
+    unsigned long v = ++versionClock;
+    dbVersion = v;
+    tabVersions[tabName] = v;
+    recordRowChange(op, tabName, rowId);
+
+    // a modifiable private copy doesn't emit signals that would keep
+    // the indices in sync, so they start over upon their next query
+    if (connectionRole == ConnectionRole::PrivateCopy) invalidateIndices();
+
+    if (strcmp(tabName, TAB_CATEGORY) == 0)
+    {
+      catVersions[static_cast<int>(rowId)] = v;
+      return;
+    }
+
+    // we must not query the database from within the
+    // update hook, so we only store the row for later
+    // lookup of its category
+    int tabIndex = 0;
+    for (const CatRelatedTable& crt : catRelatedTables)
+    {
+      if (strcmp(tabName, crt.tabName) == 0) break;
+      ++tabIndex;
+    }
+    if (tabIndex == (sizeof(catRelatedTables) / sizeof(CatRelatedTable))) return;
+
+    // deleted rows can't be mapped to a category anymore;
+    // the same holds if too many changes have piled up
+    if ((op == SQLITE_DELETE) || (pendingCatChanges.size() >= MAX_PENDING_CAT_CHANGES))
+    {
+      allCatsVersion = v;
+      pendingCatChanges.clear();
+      return;
+    }
+
+    pendingCatChanges.push_back(PendingCatChange{tabIndex, static_cast<int>(rowId), v});
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::invalidateIndices()
+  {
+    // only sets flags, so it's safe to call this from within the hooks
+    if (refereeCandidateIndex != nullptr) refereeCandidateIndex->invalidate();
+    if (playerScheduleIndex != nullptr) playerScheduleIndex->invalidate();
+    if (matchCounterCache != nullptr) matchCounterCache->invalidate();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::recordRowChange(int op, const char* tabName, sqlite3_int64 rowId)
+  {
+    // private copies don't emit any signals
+    if ((connectionRole != ConnectionRole::Primary) || isRowFeedOverflow) return;
+
+    // too many changes since the last publication, e.g. because
+    // there is no event loop; the subscribers have to assume
+    // that everything has been modified
+    if ((uncommittedRowChanges.size() + committedRowChanges.size()) >= MAX_PENDING_ROW_CHANGES)
+    {
+      isRowFeedOverflow = true;
+      uncommittedRowChanges.clear();
+      committedRowChanges.clear();
+      return;
+    }
+
+    RowChangeType t = RowChangeType::Update;
+    if (op == SQLITE_INSERT) t = RowChangeType::Insert;
+    if (op == SQLITE_DELETE) t = RowChangeType::Delete;
+    uncommittedRowChanges.push_back(RowChange{tabName, static_cast<int>(rowId), t});
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::scheduleRowChangePublication()
+  {
+    if ((committedRowChanges.empty()) && !isRowFeedOverflow) return;
+
+    // without an event loop (e.g., in unit tests) the
+    // changes are only published after explicit commits
+    if (QCoreApplication::instance() == nullptr) return;
+
+    if (rowFeedTimer == nullptr)
+    {
+      rowFeedTimer = make_unique<QTimer>();
+      rowFeedTimer->setObjectName("rowFeedTimer");
+      rowFeedTimer->setSingleShot(true);
+      rowFeedTimer->setInterval(0);
+      QObject::connect(rowFeedTimer.get(), &QTimer::timeout, [this]() { publishRowChanges(); });
+    }
+
+    if (!(rowFeedTimer->isActive())) rowFeedTimer->start();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::publishRowChanges()
+  {
+    if ((committedRowChanges.empty()) && !isRowFeedOverflow) return;
+
+    // move the changes out of the way before publishing
+    // them; the subscribers might modify the database
+    vector<RowChange> rawChanges;
+    std::swap(rawChanges, committedRowChanges);
+    bool isComplete = !isRowFeedOverflow;
+    isRowFeedOverflow = false;
+
+    // private copies don't emit any signals
+    if (connectionRole != ConnectionRole::Primary) return;
+
+    RowChangeSet cs;
+    cs.isComplete = isComplete;
+    if (isComplete) cs.changes = mergeRowChanges(rawChanges);
+
+    CentralSignalEmitter::getInstance()->rowChangesCommitted(cs);
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<RowChange> TournamentDB::mergeRowChanges(vector<RowChange>& rawChanges)
+  {
+    vector<RowChange> result;
+    vector<bool> isDropped;
+    unordered_map<string, unordered_map<int, size_t>> tab2RowIdx;
+
+    for (RowChange& rc : rawChanges)
+    {
+      unordered_map<int, size_t>& rowIdx = tab2RowIdx[rc.tabName];
+      auto it = rowIdx.find(rc.rowId);
+      if (it == rowIdx.end())
+      {
+        rowIdx[rc.rowId] = result.size();
+        result.push_back(std::move(rc));
+        isDropped.push_back(false);
+        continue;
+      }
+
+      size_t idx = it->second;
+      RowChange& prev = result[idx];
+      if (isDropped[idx])
+      {
+        // a row that has been inserted and deleted before
+        prev.type = rc.type;
+        isDropped[idx] = false;
+      }
+      else if ((prev.type == RowChangeType::Insert) && (rc.type == RowChangeType::Delete))
+      {
+        isDropped[idx] = true;
+      }
+      else if ((prev.type == RowChangeType::Delete) && (rc.type == RowChangeType::Insert))
+      {
+        prev.type = RowChangeType::Update;
+      }
+      else if (prev.type != RowChangeType::Insert)
+      {
+        // an update of an inserted row is still an insert;
+        // everything else is determined by the last change
+        prev.type = rc.type;
+      }
+    }
+
+    // remove rows that have been inserted and deleted again
+    size_t dst = 0;
+    for (size_t src = 0; src < result.size(); ++src)
+    {
+      if (isDropped[src]) continue;
+      if (dst != src) result[dst] = std::move(result[src]);
+      ++dst;
+    }
+    result.resize(dst);
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::resetDataVersions()
+  {
+    unsigned long v = ++versionClock;
+    baseVersion = v;
+    dbVersion = v;
+    allCatsVersion = v;
+    tabVersions.clear();
+    catVersions.clear();
+    pendingCatChanges.clear();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::resolvePendingCatChanges()
+  {
+    if (pendingCatChanges.empty()) return;
+
+    vector<PendingCatChange> changes;
+    std::swap(changes, pendingCatChanges);
+
+    unordered_map<int, int> grpId2CatId;
+    SqliteOverlay::DbTab* grpTab = getTab(TAB_MATCH_GROUP);
+    for (const PendingCatChange& pcc : changes)
+    {
+      const CatRelatedTable& crt = catRelatedTables[pcc.tabIndex];
+      auto r = getTab(crt.tabName)->getSingleRowByColumnValue2("id", pcc.rowId);
+
+      int catId = -1;
+      if ((r != nullptr) && (crt.catRefCol != nullptr))
+      {
+        catId = r->getInt(crt.catRefCol);
+      }
+      else if (r != nullptr)
+      {
+        // matches: look up the category of the match group
+        int grpId = r->getInt(MA_GRP_REF);
+        auto it = grpId2CatId.find(grpId);
+        if (it != grpId2CatId.end())
+        {
+          catId = it->second;
+        } else {
+          auto grpRow = grpTab->getSingleRowByColumnValue2("id", grpId);
+          if (grpRow != nullptr) catId = grpRow->getInt(MG_CAT_REF);
+          grpId2CatId[grpId] = catId;
+        }
+      }
+
+      // the row has been deleted in the meantime
+      if (catId < 1)
+      {
+        allCatsVersion = max(allCatsVersion, pcc.version);
+        continue;
+      }
+
+      unsigned long& cv = catVersions[catId];
+      cv = max(cv, pcc.version);
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
   TournamentDB::TransactionGuard::TransactionGuard(TournamentDB* _db, bool _commitOnDestruction)
-    :db{_db}, commitOnDestruction{_commitOnDestruction}
+    :db{_db}, commitOnDestruction{_commitOnDestruction}, isBatchingSignals{false}
   {
     if (db->isTransactionRunning())
     {
@@ -560,6 +1663,13 @@ namespace QTournament
       throw std::runtime_error(msg);
     }
     cerr << "TransactionGuard: created. Transaction running." << endl;
+
+    // private copies of the database don't emit any signals
+    if (db->getConnectionRole() == ConnectionRole::Primary)
+    {
+      CentralSignalEmitter::getInstance()->beginBatch();
+      isBatchingSignals = true;
+    }
   }
 
   //----------------------------------------------------------------------------
@@ -571,6 +1681,7 @@ namespace QTournament
     if (db->isTransactionRunning())
     {
       bool isOkay = commitOnDestruction ? db->commitRunningTransaction(&dbErr) : db->rollbackRunningTransaction(&dbErr);
+      endSignalBatch(commitOnDestruction && isOkay);
 
       if (!isOkay)
       {
@@ -584,6 +1695,10 @@ namespace QTournament
       cerr << "TransactionGuard: dtor. Commit = " << commitOnDestruction << endl;
     } else {
       cerr << "TransactionGuard: dtor without running transaction." << endl;
+
+      // the transaction has been finished behind our
+      // back; we assume it has been committed
+      endSignalBatch(true);
     }
   }
 
@@ -600,6 +1715,10 @@ namespace QTournament
     cerr << msg << endl;
     Sloppy::assignIfNotNull<int>(dbErr, e);
 
+    // if the commit failed, the transaction is still
+    // running and the dtor will roll it back
+    if (isOkay) endSignalBatch(true);
+
     return isOkay;
   }
 
@@ -615,8 +1734,19 @@ namespace QTournament
     msg += to_string(e);
     cerr << msg << endl;
     Sloppy::assignIfNotNull<int>(dbErr, e);
+    endSignalBatch(false);
 
     return isOkay;
   }
 
+  //----------------------------------------------------------------------------
+
+  void TournamentDB::TransactionGuard::endSignalBatch(bool deliver)
+  {
+    if (!isBatchingSignals) return;
+
+    isBatchingSignals = false;
+    CentralSignalEmitter::getInstance()->endBatch(deliver);
+  }
+
 }
@@ -20,6 +20,13 @@
 #define	TOURNAMENTDB_H
 
 #include <tuple>
+#include <memory>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <sqlite3.h>
 
 #include <SqliteOverlay/SqliteDatabase.h>
 #include <SqliteOverlay/Transaction.h>
@@ -27,8 +34,48 @@
 #include "TournamentDataDefs.h"
 #include "TournamentErrorCodes.h"
 
+class QTimer;
+
 namespace QTournament
 {
+  class RefereeCandidateIndex;
+  class PlayerScheduleIndex;
+  class MatchCounterCache;
+  class ChangeJournal;
+  class BackgroundSaver;
+  class SnapshotStore;
+
+  // the role of a database connection; private copies are
+  // used for work in background threads and never emit
+  // signals through the CentralSignalEmitter
+  enum class ConnectionRole
+  {
+    Primary,            // the tournament database that is used by the GUI
+    ReadOnlySnapshot,   // a frozen copy, e.g. for generating reports
+    PrivateCopy,        // a modifiable copy, e.g. for generating matches
+  };
+
+  // an immutable, serialized copy of a complete database;
+  // it can be shared by any number of read-only connections
+  // in any thread (see TournamentDB::openSnapshotImage())
+  class DatabaseImage
+  {
+  public:
+    DatabaseImage(unsigned char* _data, sqlite3_int64 _size, unsigned long _version)
+      :data(_data), size(_size), version(_version) {}
+    ~DatabaseImage() { sqlite3_free(data); }
+    DatabaseImage(const DatabaseImage&) = delete;
+    DatabaseImage& operator=(const DatabaseImage&) = delete;
+
+    unsigned char* getData() const { return data; }
+    sqlite3_int64 getSize() const { return size; }
+    unsigned long getVersion() const { return version; }   // the data version of the source
+
+  private:
+    unsigned char* data;   // allocated by sqlite3_serialize()
+    sqlite3_int64 size;
+    unsigned long version;
+  };
 
   enum class TransactionState
   {
@@ -37,17 +84,47 @@ namespace QTournament
     Failed,
   };
 
+  enum class RowChangeType
+  {
+    Insert,
+    Update,
+    Delete,
+  };
+
+  // a committed change of a single table row
+  struct RowChange
+  {
+    string tabName;
+    int rowId;
+    RowChangeType type;
+  };
+
+  // the committed row changes since the last publication;
+  // multiple changes of the same row are merged into one entry
+  struct RowChangeSet
+  {
+    vector<RowChange> changes;   // in the order of the first change of each row
+    bool isComplete;   // false if too many changes have piled up; consider everything as modified
+  };
+
   class TournamentDB : public SqliteOverlay::SqliteDatabase
   {
     friend class SqliteOverlay::SqliteDatabase;
+    friend class BackgroundSaver;   // needs the raw handle for sqlite3_backup_init()
 
   public:
     static unique_ptr<TournamentDB> createNew(const QString& fName, const TournamentSettings& cfg, ERR* err=nullptr);
     static unique_ptr<TournamentDB> openExisting(const QString& fName, ERR* err=nullptr);
+    static unique_ptr<TournamentDB> loadIntoMemory(const QString& fName, int* dbErr=nullptr);
+    virtual ~TournamentDB();
 
     virtual void populateTables();
     virtual void populateViews();
     void createIndices();
+    void createMissingIndices();
+    bool createCompositeIndices();
+    bool createMatchDisplayTable();
+    bool rebuildMatchDisplayTable();
 
     tuple<int, int> getVersion();
 
@@ -63,6 +140,9 @@ namespace QTournament
     bool commitRunningTransaction(int* dbErr = nullptr);
     bool rollbackRunningTransaction(int* dbErr = nullptr);
 
+    // on the primary connection, the guard also batches the status
+    // signals of the CentralSignalEmitter; they are delivered after
+    // a successful commit and discarded after a rollback
     class TransactionGuard
     {
     public:
@@ -74,14 +154,134 @@ namespace QTournament
     private:
       TournamentDB* db;
       bool commitOnDestruction;
+      bool isBatchingSignals;
+
+      void endSignalBatch(bool deliver);
     };
 
     unique_ptr<TransactionGuard> acquireTransactionGuard(bool commitOnDestruction, bool* isDbErr = nullptr, bool* transRunning = nullptr);
 
+    // optional counting of all executed SQL statements for
+    // diagnostic purposes; has to be enabled before the
+    // database is opened
+    static void setStatementCountingEnabled(bool isEnabled);
+    static unsigned long getStatementCount();
+
+    // lets the SQL profiler (if active) determine the query
+    // plans of all statements that have been executed so far
+    void auditQueryPlans();
+
+    // in-memory indices that live as long as the database
+    RefereeCandidateIndex* getRefereeCandidateIndex();
+    PlayerScheduleIndex* getPlayerScheduleIndex();
+    MatchCounterCache* getMatchCounterCache();
+
+    // copies of the complete database content, e.g. for
+    // working on a private connection in a background thread
+    unique_ptr<TournamentDB> createInMemoryCopy(ConnectionRole role, int* dbErr = nullptr);
+    ConnectionRole getConnectionRole() const { return connectionRole; }
+    bool copyContentTo(TournamentDB* dst, int* dbErr = nullptr);
+
+    // lets SQLite reject all modifications of the primary connection,
+    // e.g. while a private copy is being modified in a background
+    // thread and will replace the primary's content afterwards
+    bool setWriteLocked(bool isLocked, int* dbErr = nullptr);
+    bool isWriteLocked() const { return writeLocked; }
+
+    // the dirty flag of SqliteDatabase only counts the changes made by
+    // SQL statements; content that has been copied into the database
+    // (see copyContentTo()) has to be marked explicitly
+    void markDirty();
+    bool isDirty();
+    void resetDirtyFlag();
+    int getDirtyCounter();
+
+    // cheap read-only snapshots: the image has to be created in the
+    // database's own thread and is re-used as long as the data version
+    // doesn't change. The connections can be opened and used in any
+    // thread; they all share the image's memory.
+    shared_ptr<const DatabaseImage> getSnapshotImage(int* dbErr = nullptr);
+    static unique_ptr<TournamentDB> openSnapshotImage(const shared_ptr<const DatabaseImage>& img, int* dbErr = nullptr);
+
+    // data versions for detecting modifications, e.g. for caching.
+    // All versions are drawn from one process-wide clock, so a version
+    // is never re-used, not even by another database instance.
+    unsigned long getDatabaseVersion() const { return dbVersion; }
+    unsigned long getTableVersion(const string& tabName) const;
+    unsigned long getCategoryVersion(int catId);
+
+    // a durable journal of all changes since the last full save;
+    // only available for the primary connection
+    bool startChangeJournal(const QString& journalFileName);
+    void stopChangeJournal(bool removeFile);
+    ChangeJournal* getChangeJournal() const { return changeJournal.get(); }
+    ERR replayChangeJournal(const QString& journalFileName, int* nRecords = nullptr);
+
+    // stores the current content as a new baseline snapshot
+    ERR createSnapshot(SnapshotStore& store, const QString& label, int* newSnapId = nullptr);
+
+    // a feed of all committed row changes of the primary connection. The
+    // changes are published through the CentralSignalEmitter directly after
+    // a commit of a running transaction and in the next event loop iteration
+    // for auto-committed statements. Calling this function publishes
+    // all outstanding changes immediately.
+    void publishRowChanges();
+
   private:
-    TournamentDB(string fName, bool createNew);
+    TournamentDB(string fName, bool createNew, ConnectionRole role = ConnectionRole::Primary);
+    static unique_ptr<TournamentDB> openSecondaryConnection(ConnectionRole role, int* dbErr);
+
+    static bool isStatementCountingEnabled;
+    static std::atomic<unsigned long> statementCount;
+    static int traceCallback(unsigned traceType, void* ctx, void* p, void* x);
+
+    // a changed row that belongs to a yet unknown category
+    struct PendingCatChange
+    {
+      int tabIndex;   // index in the list of category related tables
+      int rowId;
+      unsigned long version;
+    };
+
+    static constexpr size_t MAX_PENDING_CAT_CHANGES = 10000;
+    static constexpr size_t MAX_PENDING_ROW_CHANGES = 10000;
+    static std::atomic<unsigned long> versionClock;
+    static void updateHookCallback(void* ctx, int op, const char* dbName, const char* tabName, sqlite3_int64 rowId);
+    static int commitHookCallback(void* ctx);
+    static void rollbackHookCallback(void* ctx);
+    void onRowChanged(int op, const char* tabName, sqlite3_int64 rowId);
+    void recordRowChange(int op, const char* tabName, sqlite3_int64 rowId);
+    void invalidateIndices();
+    void scheduleRowChangePublication();
+    static vector<RowChange> mergeRowChanges(vector<RowChange>& rawChanges);
+    void resetDataVersions();
+    void resolvePendingCatChanges();
+
+    unsigned long baseVersion;   // the version of all data after opening or copying
+    unsigned long dbVersion;
+    unsigned long allCatsVersion;
+    unordered_map<string, unsigned long> tabVersions;
+    unordered_map<int, unsigned long> catVersions;
+    vector<PendingCatChange> pendingCatChanges;
+
+    // the row change feed; the hooks must not access the database,
+    // so we only collect the raw changes there
+    vector<RowChange> uncommittedRowChanges;
+    vector<RowChange> committedRowChanges;
+    bool isRowFeedOverflow;
+    unique_ptr<QTimer> rowFeedTimer;
 
+    ConnectionRole connectionRole;
+    bool writeLocked;
+    bool hasExternalChanges;   // see markDirty()
+    int externalChangeCount;
     unique_ptr<SqliteOverlay::Transaction> curTrans;
+    unique_ptr<RefereeCandidateIndex> refereeCandidateIndex;
+    unique_ptr<PlayerScheduleIndex> playerScheduleIndex;
+    unique_ptr<MatchCounterCache> matchCounterCache;
+    unique_ptr<ChangeJournal> changeJournal;
+    shared_ptr<const DatabaseImage> lastSnapshotImage;   // the most recent image of this database
+    shared_ptr<const DatabaseImage> sourceImage;   // the image this connection has been opened from
   };
 
 }
@@ -24,7 +24,7 @@
 namespace QTournament
 {
 #define DB_VERSION_MAJOR 2
-#define DB_VERSION_MINOR 3
+#define DB_VERSION_MINOR 4
 #define MIN_REQUIRED_DB_VERSION 2
 
 //----------------------------------------------------------------------------
@@ -169,6 +169,7 @@ namespace QTournament
 #define MA_LOSER_RANK  "LoserRank"
 #define MA_REFEREE_MODE  "RefereeMode"
 #define MA_REFEREE_REF  "RefereeRefId"
+#define IDX_MATCH_STATE_NUM  "Match_StateAndNumber"
 //#define MA_  ""
 //#define MA_  ""
 //#define MA_  ""
@@ -181,6 +182,7 @@ namespace QTournament
 #define MG_ROUND  "Round"
 #define MG_GRP_NUM  "RoundRobinGroupNumber"
 #define MG_STAGE_SEQ_NUM  "StageSequenceNumber"
+#define IDX_MATCH_GROUP_CAT_ROUND_GRP  "MatchGroup_CatRoundGroup"
 //#define MG_  ""
 //#define MG_  ""
 //#define MG_  ""
@@ -216,6 +218,7 @@ namespace QTournament
 #define RA_RANK  "Rank"
 #define RA_CAT_REF  "CategoryRef"
 #define RA_GRP_NUM  "MatchGroupNumber"
+#define IDX_RANKING_CAT_ROUND_GRP  "Ranking_CatRoundGroup"
 //#define RA_  ""
 //#define RA_  ""
 //#define RA_  ""
@@ -248,6 +251,28 @@ namespace QTournament
 
 //----------------------------------------------------------------------------
 
+// a materialized view that contains everything that is necessary
+// for listing a match; the table is maintained by triggers and
+// the match-related columns use the same names as in TAB_MATCH
+#define TAB_MATCH_DISPLAY "MatchDisplay"
+#define VIEW_MATCH_DISPLAY "v_MatchDisplay"
+#define MD_CAT_REF  "CategoryRefId"
+#define MD_CAT_NAME  "CategoryName"
+#define MD_MATCH_SYSTEM  "MatchSystem"
+#define MD_ROUND  "Round"
+#define MD_GRP_NUM  "GroupNumber"
+#define MD_REFEREE_NAME  "RefereeName"
+#define MD_PAIR1_PLAYER1_NAME  "Pair1Player1Name"
+#define MD_PAIR1_PLAYER2_NAME  "Pair1Player2Name"
+#define MD_PAIR2_PLAYER1_NAME  "Pair2Player1Name"
+#define MD_PAIR2_PLAYER2_NAME  "Pair2Player2Name"
+#define MD_PAIR1_TEAM_NAME  "Pair1TeamName"
+#define MD_PAIR2_TEAM_NAME  "Pair2TeamName"
+#define MD_PAIR1_SYMBOLIC_NAME  "Pair1SymbolicName"
+#define MD_PAIR2_SYMBOLIC_NAME  "Pair2SymbolicName"
+
+//----------------------------------------------------------------------------
+
   
 //----------------------------------------------------------------------------
 
@@ -99,6 +99,9 @@ namespace QTournament
         REFEREE_NOT_IDLE,
         COURT_NOT_DISABLED,
         COURT_ALREADY_USED,
+        OPERATION_CANCELLED,
+        FILE_IO_ERROR,
+        DATABASE_LOCKED,
     };
 }
 
@@ -24,15 +24,106 @@
 #include <QFile>
 #include <QLocale>
 #include <QStyleFactory>
+#include <QTextStream>
 
 #include "ui/MainFrame.h"
+#include "ui/EventLoopWatchdog.h"
+#include "reports/BatchReportExporter.h"
+#include "reports/BracketVisData.h"
+#include "CatMngr.h"
+#include "SqlProfiler.h"
+
+using namespace QTournament;
+
+// headless export of all reports:
+//
+//   QTournament --export-reports <tournament file> <output directory> [<number of threads>]
+//
+// On systems without a display, set QT_QPA_PLATFORM=offscreen
+int exportReportsHeadless(const QStringList& args)
+{
+  QTextStream out{stdout};
+  QTextStream err{stderr};
+
+  if ((args.size() < 4) || (args.size() > 5))
+  {
+    err << "Usage: " << args.at(0) << " --export-reports <tournament file> <output directory> [<number of threads>]" << endl;
+    return 1;
+  }
+
+  int nThreads = -1;
+  if (args.size() == 5)
+  {
+    bool isOk;
+    nThreads = args.at(4).toInt(&isOk);
+    if (!isOk || (nThreads <= 0))
+    {
+      err << "Invalid number of threads: " << args.at(4) << endl;
+      return 1;
+    }
+  }
+
+  // we never modify the file: we work on a copy in memory and
+  // refuse to work on files that need a conversion. Indices that
+  // have been introduced after the file has been created are
+  // only added to the copy.
+  if (!(QFile::exists(args.at(2))))
+  {
+    err << "Could not open " << args.at(2) << endl;
+    return 1;
+  }
+  int dbErr;
+  auto db = TournamentDB::loadIntoMemory(args.at(2), &dbErr);
+  if ((dbErr != SQLITE_OK) || (db == nullptr) || !(db->isCompatibleDatabaseVersion()) || (db->needsConversion()))
+  {
+    err << "Could not open " << args.at(2) << endl;
+    return 1;
+  }
+  db->createMissingIndices();
+
+  // older versions filled the gaps in the brackets only when a
+  // bracket report was shown; the reports are read-only now, so
+  // we fill the gaps in the copy, just like the GUI does
+  CatMngr cm{db.get()};
+  for (const Category& cat : cm.getAllCategories())
+  {
+    auto bvd = BracketVisData::getExisting(cat);
+    if (bvd != nullptr) bvd->fillMissingPlayerNames();
+  }
+
+  BatchReportExporter exporter{db.get(), args.at(3), nThreads};
+  ERR e = exporter.start();
+  if (e != OK)
+  {
+    err << "Could not start the export, error code " << static_cast<int>(e) << endl;
+    return 1;
+  }
+  exporter.waitForFinished();
+  db->auditQueryPlans();
+
+  out << exporter.getTimingSummary() << endl;
+
+  for (const ReportExportResult& r : exporter.getResults())
+  {
+    if (r.fileName.isEmpty()) return 2;
+  }
+  return 0;
+}
+
+//----------------------------------------------------------------------------
 
 int main(int argc, char *argv[])
 {
   // initialize resources, if needed
   Q_INIT_RESOURCE(tournament);
 
-  QApplication app(argc, argv);
+  InstrumentedApplication app(argc, argv);
+
+  // optional diagnostics for a blocked event loop
+  EventLoopWatchdog::initFromEnvironment();
+
+  // optional profiling of all SQL statements
+  SqlProfiler::initFromEnvironment();
 
   // use the "Fusion" style
   QStyle* fusionStyle = QStyleFactory::create("fusion");
@@ -72,11 +163,26 @@ int main(int argc, char *argv[])
   tournamentTranslator.load(app.applicationDirPath() + "/../tournament_de");
 #endif*/
   app.installTranslator(&tournamentTranslator);
+
+  // no GUI for batch exports
+  QStringList args = app.arguments();
+  if ((args.size() > 1) && (args.at(1) == "--export-reports"))
+  {
+    int result = exportReportsHeadless(args);
+    EventLoopWatchdog::cleanUp();
+    SqlProfiler::cleanUp();
+    return result;
+  }
   
   MainFrame w;
   w.show();
 
   // create and show your widgets here
 
-  return app.exec();
+  int result = app.exec();
+
+  EventLoopWatchdog::cleanUp();
+  SqlProfiler::cleanUp();
+
+  return result;
 }
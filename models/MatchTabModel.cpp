@@ -34,7 +34,7 @@ MatchTableModel::MatchTableModel(TournamentDB* _db)
   CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
   connect(cse, SIGNAL(beginCreateMatch()), this, SLOT(onBeginCreateMatch()), Qt::DirectConnection);
   connect(cse, SIGNAL(endCreateMatch(int)), this, SLOT(onEndCreateMatch(int)), Qt::DirectConnection);
-  connect(cse, SIGNAL(matchStatusChanged(int,int,OBJ_STATE,OBJ_STATE)), this, SLOT(onMatchStatusChanged(int,int,OBJ_STATE,OBJ_STATE)), Qt::DirectConnection);
+  connect(cse, SIGNAL(rowChangesCommitted(RowChangeSet)), this, SLOT(onRowChangesCommitted(RowChangeSet)), Qt::DirectConnection);
   connect(cse, SIGNAL(beginResetAllModels()), this, SLOT(onBeginResetModel()), Qt::DirectConnection);
   connect(cse, SIGNAL(endResetAllModels()), this, SLOT(onEndResetModel()), Qt::DirectConnection);
   connect(cse, SIGNAL(endCreateCourt(int)), this, SLOT(recalcPrediction()), Qt::DirectConnection);
@@ -76,33 +76,34 @@ QVariant MatchTableModel::data(const QModelIndex& index, int role) const
     if (role != Qt::DisplayRole)
       return QVariant();
     
+    // everything except for the time prediction comes
+    // from the materialized match display table
     MatchMngr mm{db};
-    auto ma = mm.getMatchBySeqNum(index.row());
-    auto mg = ma->getMatchGroup();
+    auto md = mm.getMatchDisplayBySeqNum(index.row());
+    if (md == nullptr) return QVariant();
     
     // first column: match num
     if (index.column() == MATCH_NUM_COL_ID)
     {
-      return ma->getMatchNumber();
+      return md->matchNum;
     }
 
     // second column: match name
     if (index.column() == 1)
     {
-      return ma->getDisplayName(tr("Winner"), tr("Loser"));
+      return md->getDisplayName(tr("Winner"), tr("Loser"));
     }
 
     // third column: category name
     if (index.column() == 2)
     {
-      Category c = mg.getCategory();
-      return c.getName();
+      return md->catName;
     }
 
     // fourth column: round
     if (index.column() == 3)
     {
-      return mg.getRound();
+      return md->round;
     }
 
     // fifth column: players group, if applicable
@@ -110,35 +111,33 @@ QVariant MatchTableModel::data(const QModelIndex& index, int role) const
     {
       // if this is a match that has a winner rank assigned,
       // we abuse this column to print the target rank
-      int winnerRank = ma->getWinnerRank();
-      if (winnerRank > 0)
+      if (md->winnerRank > 0)
       {
         QString txt = tr("Pl. %1");
-        txt = txt.arg(winnerRank);
+        txt = txt.arg(md->winnerRank);
         return txt;
       }
 
       // if we have a ranking bracket, labels like "QF", "SF"
       // or "FI" do not really make sense. So we display
       // nothing instead
-      Category c = mg.getCategory();
-      if (c.getMatchSystem() == RANKING) return "--";
+      if (md->matchSystem == RANKING) return "--";
 
       // in all other cases, try to print a group number
-      return GuiHelpers::groupNumToString(mg.getGroupNumber());
+      return GuiHelpers::groupNumToString(md->grpNum);
     }
 
     // sixth column: the match state; this column is used for filtering and
     // needs to be hidden in the view
     if (index.column() == STATE_COL_ID)
     {
-      return static_cast<int>(ma->getState());
+      return static_cast<int>(md->state);
     }
 
     // seventh column: the referee mode for the match
     if (index.column() == REFEREE_MODE_COL_ID)
     {
-      REFEREE_MODE mode = ma->get_EFFECTIVE_RefereeMode();
+      REFEREE_MODE mode = md->refereeMode;
 
       // if there is already a referee assigned, display
       // the referee name
@@ -146,10 +145,9 @@ QVariant MatchTableModel::data(const QModelIndex& index, int role) const
           (mode == REFEREE_MODE::RECENT_FINISHERS) ||
           (mode == REFEREE_MODE::SPECIAL_TEAM))
       {
-        upPlayer referee = ma->getAssignedReferee();
-        if (referee != nullptr)
+        if (md->refereeId > 0)
         {
-          return referee->getDisplayName();
+          return md->refereeName;
         }
       }
 
@@ -177,6 +175,8 @@ QVariant MatchTableModel::data(const QModelIndex& index, int role) const
 
     // for all following columns, we need the
     // estimated start/finish time for the match
+    auto ma = mm.getMatch(md->matchId);
+    if (ma == nullptr) return QVariant();
     MatchTimePrediction mtp = matchTimePredictor->getPredictionForMatch(*ma);
 
     // the estimated start time
@@ -284,11 +284,41 @@ void MatchTableModel::onEndCreateMatch(int newMatchSeqNum)
 
 //----------------------------------------------------------------------------
 
-void MatchTableModel::onMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState)
+void MatchTableModel::onRowChangesCommitted(const RowChangeSet& changes)
 {
-  QModelIndex startIdx = createIndex(matchSeqNum, 0);
-  QModelIndex endIdx = createIndex(matchSeqNum, COLUMN_COUNT-1);
-  emit dataChanged(startIdx, endIdx);
+  int nRows = rowCount();
+  if (nRows == 0) return;
+
+  if (!(changes.isComplete))
+  {
+    emit dataChanged(createIndex(0, 0), createIndex(nRows-1, COLUMN_COUNT-1));
+    return;
+  }
+
+  // the match display table is maintained by triggers and
+  // thus also reflects renamed players, teams, categories, ...
+  //
+  // the triggers refresh the display rows with INSERT OR REPLACE,
+  // so modified rows show up as inserts
+  DbTab* displayTab = db->getTab(TAB_MATCH_DISPLAY);
+  int minSeqNum = -1;
+  int maxSeqNum = -1;
+  for (const RowChange& rc : changes.changes)
+  {
+    if ((rc.type == RowChangeType::Delete) || (rc.tabName != TAB_MATCH_DISPLAY)) continue;
+
+    auto r = displayTab->getSingleRowByColumnValue2("id", rc.rowId);
+    if (r == nullptr) continue;
+
+    int seqNum = r->getInt(GENERIC_SEQNUM_FIELD_NAME);
+    if (seqNum >= nRows) continue;
+    if ((minSeqNum < 0) || (seqNum < minSeqNum)) minSeqNum = seqNum;
+    if (seqNum > maxSeqNum) maxSeqNum = seqNum;
+  }
+  if (minSeqNum < 0) return;
+
+  // a single update for the range of all affected rows
+  emit dataChanged(createIndex(minSeqNum, 0), createIndex(maxSeqNum, COLUMN_COUNT-1));
 
   // no need for recalculation match times here:
   //
@@ -297,8 +327,6 @@ void MatchTableModel::onMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STA
   //
   // all other changes (e.g. adding matches to the schedule) will be
   // captured by a periodic update every 10 seconds
-
-  return;
 }
 
 //----------------------------------------------------------------------------
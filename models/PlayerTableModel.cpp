@@ -16,6 +16,8 @@
  *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+
 #include "PlayerTableModel.h"
 
 #include "Player.h"
@@ -37,6 +39,7 @@ PlayerTableModel::PlayerTableModel(TournamentDB* _db)
   connect(cse, SIGNAL(endCreatePlayer(int)), this, SLOT(onEndCreatePlayer(int)), Qt::DirectConnection);
   connect(cse, SIGNAL(playerRenamed(Player)), this, SLOT(onPlayerRenamed(Player)), Qt::DirectConnection);
   connect(cse, SIGNAL(playerStatusChanged(int,int,OBJ_STATE,OBJ_STATE)), this, SLOT(onPlayerStatusChanged(int,int)), Qt::DirectConnection);
+  connect(cse, SIGNAL(statusChangeBatchDelivered(StatusChangeSet)), this, SLOT(onStatusChangeBatchDelivered(StatusChangeSet)), Qt::DirectConnection);
   connect(cse, SIGNAL(beginDeletePlayer(int)), this, SLOT(onBeginDeletePlayer(int)), Qt::DirectConnection);
   connect(cse, SIGNAL(endDeletePlayer()), this, SLOT(onEndDeletePlayer()), Qt::DirectConnection);
 
@@ -199,6 +202,9 @@ void PlayerTableModel::onPlayerRenamed(const Player& p)
 
 void PlayerTableModel::onPlayerStatusChanged(int playerId, int playerSeqNum)
 {
+  // the changes of a committed transaction are handled in one go
+  if (CentralSignalEmitter::getInstance()->isDeliveringBatch()) return;
+
   QModelIndex startIdx = createIndex(playerSeqNum, 0);
   QModelIndex endIdx = createIndex(playerSeqNum, COLUMN_COUNT-1);
   emit dataChanged(startIdx, endIdx);
@@ -206,6 +212,22 @@ void PlayerTableModel::onPlayerStatusChanged(int playerId, int playerSeqNum)
 
 //----------------------------------------------------------------------------
 
+void PlayerTableModel::onStatusChangeBatchDelivered(const StatusChangeSet& changes)
+{
+  if (changes.players.empty()) return;
+
+  // a single update for the range of all affected rows
+  auto minMax = std::minmax_element(changes.players.begin(), changes.players.end(), [](const StatusChange& sc1, const StatusChange& sc2) {
+    return (sc1.seqNum < sc2.seqNum);
+  });
+
+  QModelIndex startIdx = createIndex(minMax.first->seqNum, 0);
+  QModelIndex endIdx = createIndex(minMax.second->seqNum, COLUMN_COUNT-1);
+  emit dataChanged(startIdx, endIdx);
+}
+
+//----------------------------------------------------------------------------
+
 void PlayerTableModel::onBeginDeletePlayer(int playerSeqNum)
 {
   beginRemoveRows(QModelIndex(), playerSeqNum, playerSeqNum);
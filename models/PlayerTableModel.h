@@ -28,6 +28,8 @@
 
 namespace QTournament
 {
+  struct StatusChangeSet;
+
 
   class Tournament;
 
@@ -58,6 +60,7 @@ namespace QTournament
     void onPlayerRenamed(const Player& p);
     void onTeamRenamed(int teamSeqNum);
     void onPlayerStatusChanged(int playerId, int playerSeqNum);
+    void onStatusChangeBatchDelivered(const StatusChangeSet& changes);
     void onBeginDeletePlayer(int playerSeqNum);
     void onEndDeletePlayer();
     void onBeginResetModel();
@@ -34,8 +34,8 @@ namespace QTournament
   constexpr char AbstractReport::RESULTSHEET_GAMELABEL_STYLE[];
   constexpr char AbstractReport::BOLD_STYLE[];
 
-AbstractReport::AbstractReport(TournamentDB* _db, const QString& _name)
-  :db(_db), name(_name), cfg(KeyValueTab::getTab(db, TAB_CFG))
+AbstractReport::AbstractReport(TournamentDB* _db, const QString& _name, int _dataCatId)
+  :db(_db), name(_name), cfg(KeyValueTab::getTab(db, TAB_CFG)), dataCatId(_dataCatId)
 {
   if (db == nullptr)
   {
@@ -328,6 +328,21 @@ void AbstractReport::setHeaderAndFooter(upSimpleReport& rep, const QString& repo
 
 //----------------------------------------------------------------------------
 
+DataVersion AbstractReport::getDataVersion() const
+{
+  if (dataCatId < 1) return DataVersion{db->getDatabaseVersion()};
+
+  // the matches, pairs, rankings etc. of the category plus
+  // everything that's printed along with them (names, teams,
+  // courts, tournament name in the header)
+  return DataVersion{
+    db->getCategoryVersion(dataCatId),
+    db->getTableVersion(TAB_PLAYER),
+    db->getTableVersion(TAB_TEAM),
+    db->getTableVersion(TAB_COURT),
+    db->getTableVersion(TAB_CFG),
+  };
+}
 
 //----------------------------------------------------------------------------
 
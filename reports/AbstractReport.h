@@ -20,6 +20,7 @@
 #define ABSTRACTREPORT_H
 
 #include <memory>
+#include <vector>
 
 #include <QString>
 
@@ -37,6 +38,9 @@ namespace QTournament
   typedef unique_ptr<SimpleReportLib::SimpleReportGenerator> upSimpleReport;
   typedef shared_ptr<SimpleReportLib::SimpleReportGenerator> spSimpleReport;
 
+  // the versions of all data that a report depends on
+  typedef vector<unsigned long> DataVersion;
+
   class AbstractReport
   {
   public:
@@ -57,12 +61,19 @@ namespace QTournament
     static constexpr char RESULTSHEET_GAMELABEL_STYLE[] = "ResultSheet_GameLabel";
     static constexpr char BOLD_STYLE[] = "Bold";
 
-    AbstractReport(TournamentDB* _db, const QString& _name);
+    AbstractReport(TournamentDB* _db, const QString& _name, int _dataCatId = -1);
     virtual ~AbstractReport();
 
     virtual upSimpleReport regenerateReport() { throw std::runtime_error("Unimplemented Method: regenerateReport"); };
     virtual QStringList getReportLocators() const { throw std::runtime_error("Unimplemented Method: getReportLocators"); };
 
+    // a generated report remains valid as long as its data version
+    // doesn't change. Reports that have been constructed with a
+    // category ID only depend on that category and the data printed
+    // along with it; for all other reports, any modification of the
+    // database invalidates the report
+    virtual DataVersion getDataVersion() const;
+
     upSimpleReport createEmptyReport_Portrait() const;
     upSimpleReport createEmptyReport_Landscape() const;
 
@@ -73,6 +84,7 @@ namespace QTournament
     TournamentDB* db;
     QString name;
     unique_ptr<KeyValueTab> cfg;
+    int dataCatId;
 
     void prepStyles(upSimpleReport& rep) const;
     void printIntermediateHeader(upSimpleReport& rep, const QString& txt, double skipBefore__MM=SKIP_BEFORE_INTERMEDIATE_HEADER__MM) const;
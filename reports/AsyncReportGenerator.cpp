@@ -0,0 +1,187 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AsyncReportGenerator.h"
+#include "ReportFactory.h"
+
+namespace QTournament
+{
+
+  AsyncReportGenerator::AsyncReportGenerator(QObject* parent)
+    :QObject(parent), lastRequestId(0), pendingRequest(nullptr), isWorkerRunning(false),
+      runningRequestId(0), isRunningRequestCancelled(false), workerResult(nullptr),
+      readyRequestId(0), readyReport(nullptr)
+  {
+  }
+
+  //----------------------------------------------------------------------------
+
+  AsyncReportGenerator::~AsyncReportGenerator()
+  {
+    // we can't interrupt a report generation, so we
+    // have to wait for the worker to finish
+    if (workerThread.joinable()) workerThread.join();
+  }
+
+  //----------------------------------------------------------------------------
+
+  int AsyncReportGenerator::requestReport(TournamentDB* db, const QString& repName)
+  {
+    if (db == nullptr) return 0;
+
+    ++lastRequestId;
+
+    // a new request replaces any request that's still waiting
+    pendingRequest = make_unique<Request>(Request{lastRequestId, db, repName});
+
+    if (!isWorkerRunning) startNextRequest();
+
+    return lastRequestId;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void AsyncReportGenerator::cancelAll()
+  {
+    // drop the waiting request and make a
+    // running request stale; we don't even cache
+    // its result because the database might have
+    // been closed in the meantime
+    pendingRequest.reset();
+    ++lastRequestId;
+    isRunningRequestCancelled = true;
+
+    readyReport.reset();
+    readyRequestId = 0;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool AsyncReportGenerator::isBusy() const
+  {
+    return (isWorkerRunning || (pendingRequest != nullptr));
+  }
+
+  //----------------------------------------------------------------------------
+
+  spSimpleReport AsyncReportGenerator::takeReport(int requestId)
+  {
+    if ((requestId == 0) || (requestId != readyRequestId)) return nullptr;
+
+    readyRequestId = 0;
+    return std::move(readyReport);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void AsyncReportGenerator::onWorkerFinished()
+  {
+    if (workerThread.joinable()) workerThread.join();
+    isWorkerRunning = false;
+
+    spSimpleReport rep;
+    {
+      lock_guard<mutex> lk{resultMutex};
+      rep = std::move(workerResult);
+    }
+
+    // the report remains valid as long as the data
+    // of the snapshot hasn't changed
+    if (!isRunningRequestCancelled && !(runningDataVersion.empty()))
+    {
+      ReportFactory::storeReportInCache(runningRepName, runningDataVersion, rep);
+    }
+
+    // forward the result only if nobody has
+    // requested another report in the meantime
+    if (runningRequestId == lastRequestId)
+    {
+      readyRequestId = runningRequestId;
+      readyReport = std::move(rep);
+      emit reportReady(readyRequestId);
+    }
+
+    startNextRequest();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void AsyncReportGenerator::startNextRequest()
+  {
+    if (pendingRequest == nullptr) return;
+
+    unique_ptr<Request> req = std::move(pendingRequest);
+
+    // the snapshot has to be created in the GUI thread because
+    // the tournament database may only be accessed from here
+    int dbErr;
+    auto snapshot = req->db->createInMemoryCopy(ConnectionRole::ReadOnlySnapshot, &dbErr);
+    if (snapshot == nullptr)
+    {
+      readyRequestId = req->id;
+      readyReport.reset();
+      emit reportReady(req->id);
+      return;
+    }
+
+    // determine the data version of the snapshot
+    // for caching the report later on
+    ReportFactory repFab{req->db};
+    upAbstractReport abstractRep = repFab.getReportByName(req->repName);
+    runningDataVersion = (abstractRep != nullptr) ? abstractRep->getDataVersion() : DataVersion();
+
+    isWorkerRunning = true;
+    runningRequestId = req->id;
+    runningRepName = req->repName;
+    isRunningRequestCancelled = false;
+    workerThread = thread{&AsyncReportGenerator::runWorker, this, std::move(snapshot), req->repName};
+  }
+
+  //----------------------------------------------------------------------------
+
+  void AsyncReportGenerator::runWorker(unique_ptr<TournamentDB> snapshot, QString repName)
+  {
+    upSimpleReport rep;
+
+    try
+    {
+      // re-create the report object for the snapshot
+      ReportFactory repFab{snapshot.get()};
+      upAbstractReport abstractRep = repFab.getReportByName(repName);
+      if (abstractRep != nullptr) rep = abstractRep->regenerateReport();
+    }
+    catch (std::exception&)
+    {
+      rep.reset();
+    }
+
+    // the snapshot is not needed anymore
+    snapshot.reset();
+
+    {
+      lock_guard<mutex> lk{resultMutex};
+      workerResult = std::move(rep);
+    }
+
+    // continue in the GUI thread
+    QMetaObject::invokeMethod(this, "onWorkerFinished", Qt::QueuedConnection);
+  }
+
+  //----------------------------------------------------------------------------
+
+}
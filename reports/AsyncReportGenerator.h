@@ -0,0 +1,109 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ASYNCREPORTGENERATOR_H
+#define ASYNCREPORTGENERATOR_H
+
+#include <memory>
+#include <thread>
+#include <mutex>
+
+#include <QObject>
+#include <QString>
+
+#include "TournamentDB.h"
+#include "AbstractReport.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  /*
+   * Generates reports in a background thread.
+   *
+   * Each request takes a read-only snapshot of the tournament
+   * database when it is started. The report is then generated on
+   * that snapshot, so the tournament database can be modified
+   * while the report is being generated.
+   *
+   * Only one report is generated at a time. A new request makes all
+   * older requests stale. A request that is still waiting is replaced
+   * by the new one. A report that is already being generated runs to
+   * completion, but its result is discarded.
+   *
+   * reportReady() is emitted in the GUI thread for the latest request
+   * only. The report can then be fetched with takeReport().
+   *
+   * All generated reports are stored in the ReportFactory's report
+   * cache, even those of stale requests.
+   */
+  class AsyncReportGenerator : public QObject
+  {
+    Q_OBJECT
+
+  public:
+    AsyncReportGenerator(QObject* parent = nullptr);
+    ~AsyncReportGenerator();
+
+    // all functions have to be called from the GUI thread
+    int requestReport(TournamentDB* db, const QString& repName);
+    void cancelAll();
+    bool isBusy() const;
+    spSimpleReport takeReport(int requestId);
+
+  signals:
+    // emitted for the latest request only; the report
+    // might be nullptr if the generation failed
+    void reportReady(int requestId);
+
+  private slots:
+    void onWorkerFinished();
+
+  private:
+    struct Request
+    {
+      int id;
+      TournamentDB* db;
+      QString repName;
+    };
+
+    int lastRequestId;
+    unique_ptr<Request> pendingRequest;
+
+    thread workerThread;
+    bool isWorkerRunning;
+    int runningRequestId;
+    QString runningRepName;
+    DataVersion runningDataVersion;
+    bool isRunningRequestCancelled;
+
+    // written by the worker, read in the GUI thread
+    mutex resultMutex;
+    upSimpleReport workerResult;
+
+    // results that are ready for takeReport()
+    int readyRequestId;
+    spSimpleReport readyReport;
+
+    void startNextRequest();
+    void runWorker(unique_ptr<TournamentDB> snapshot, QString repName);
+  };
+
+}
+
+#endif // ASYNCREPORTGENERATOR_H
@@ -0,0 +1,217 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QDir>
+#include <QThread>
+
+#include "BatchReportExporter.h"
+#include "ReportFactory.h"
+
+namespace QTournament
+{
+
+  BatchReportExporter::BatchReportExporter(TournamentDB* _db, const QString& _outDir, int _nThreads)
+    :db(_db), outDir(_outDir), nThreads(_nThreads), nextIndex(0), finishedCount(0),
+      runningWorkers(0), isCancelled(false), totalDuration__ms(0)
+  {
+    if (nThreads <= 0) nThreads = QThread::idealThreadCount();
+    if (nThreads <= 0) nThreads = 1;
+  }
+
+  //----------------------------------------------------------------------------
+
+  BatchReportExporter::~BatchReportExporter()
+  {
+    requestCancellation();
+    waitForFinished();
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR BatchReportExporter::start()
+  {
+    if (db == nullptr) return DATABASE_ERROR;
+    if (!(workers.empty())) return OK;   // already started
+
+    QDir dir;
+    if (!(dir.mkpath(outDir))) return FILE_NOT_EXISTING;
+
+    ReportFactory repFab{db};
+    catalogue = repFab.getReportCatalogue();
+    results.clear();
+    for (const QString& repName : catalogue)
+    {
+      results.push_back(ReportExportResult{repName, QString(), 0});
+    }
+
+    // the snapshot image has to be created here because the
+    // tournament database may only be accessed from its own thread;
+    // all workers share the same image
+    int dbErr;
+    auto img = db->getSnapshotImage(&dbErr);
+    if (img == nullptr) return DATABASE_ERROR;
+
+    int nWorkers = min(nThreads, catalogue.size());
+    clock.start();
+    runningWorkers = nWorkers;
+    for (int i=0; i < nWorkers; ++i)
+    {
+      workers.push_back(thread{&BatchReportExporter::runWorker, this, img});
+    }
+
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void BatchReportExporter::requestCancellation()
+  {
+    // reports that are being generated will
+    // be finished, all others will be skipped
+    isCancelled = true;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void BatchReportExporter::waitForFinished()
+  {
+    for (thread& t : workers)
+    {
+      if (t.joinable()) t.join();
+    }
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool BatchReportExporter::isFinished() const
+  {
+    return (runningWorkers == 0);
+  }
+
+  //----------------------------------------------------------------------------
+
+  qint64 BatchReportExporter::getTotalDuration__ms() const
+  {
+    lock_guard<mutex> lk{resultMutex};
+    return totalDuration__ms;
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<ReportExportResult> BatchReportExporter::getResults() const
+  {
+    lock_guard<mutex> lk{resultMutex};
+    return results;
+  }
+
+  //----------------------------------------------------------------------------
+
+  QString BatchReportExporter::getTimingSummary() const
+  {
+    QString result;
+    int nFailed = 0;
+    for (const ReportExportResult& r : getResults())
+    {
+      if (r.fileName.isEmpty())
+      {
+        ++nFailed;
+        result += QString("%1: FAILED\n").arg(r.repName);
+        continue;
+      }
+
+      result += QString("%1: %2 ms\n").arg(r.repName).arg(r.duration__ms);
+    }
+
+    QString total = "%1 reports, %2 failed, %3 threads, %4 ms total";
+    total = total.arg(catalogue.size()).arg(nFailed).arg(workers.size()).arg(getTotalDuration__ms());
+    result += total;
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  QString BatchReportExporter::getFileNameForReport(const QString& repName)
+  {
+    // report names contain user-defined category names,
+    // so we have to get rid of all "dangerous" characters
+    QString result;
+    for (const QChar& c : repName)
+    {
+      result += (c.isLetterOrNumber() || (c == '-') || (c == '_')) ? c : QChar('_');
+    }
+
+    return result + ".pdf";
+  }
+
+  //----------------------------------------------------------------------------
+
+  void BatchReportExporter::runWorker(shared_ptr<const DatabaseImage> img)
+  {
+    // if we can't open a connection, the
+    // other workers take over our share
+    auto snapshot = TournamentDB::openSnapshotImage(img);
+    ReportFactory repFab{snapshot.get()};
+    QDir dir{outDir};
+
+    while ((snapshot != nullptr) && !isCancelled)
+    {
+      int idx = nextIndex++;
+      if (idx >= catalogue.size()) break;
+
+      const QString& repName = catalogue.at(idx);
+      QElapsedTimer repClock;
+      repClock.start();
+
+      QString fileName;
+      try
+      {
+        upAbstractReport abstractRep = repFab.getReportByName(repName);
+        upSimpleReport rep = (abstractRep != nullptr) ? abstractRep->regenerateReport() : nullptr;
+        if (rep != nullptr)
+        {
+          QString fullName = dir.absoluteFilePath(getFileNameForReport(repName));
+          if (rep->createPdf(fullName)) fileName = fullName;
+        }
+      }
+      catch (std::exception&)
+      {
+        fileName.clear();
+      }
+
+      {
+        lock_guard<mutex> lk{resultMutex};
+        results[idx].fileName = fileName;
+        results[idx].duration__ms = repClock.elapsed();
+      }
+      ++finishedCount;
+    }
+
+    // the snapshot is not needed anymore
+    snapshot.reset();
+
+    // the last worker stops the clock
+    lock_guard<mutex> lk{resultMutex};
+    if (--runningWorkers == 0) totalDuration__ms = clock.elapsed();
+  }
+
+  //----------------------------------------------------------------------------
+
+}
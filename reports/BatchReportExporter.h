@@ -0,0 +1,103 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BATCHREPORTEXPORTER_H
+#define BATCHREPORTEXPORTER_H
+
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include <QString>
+#include <QStringList>
+#include <QElapsedTimer>
+
+#include "TournamentDB.h"
+#include "TournamentErrorCodes.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  struct ReportExportResult
+  {
+    QString repName;
+    QString fileName;   // empty if the export failed
+    qint64 duration__ms;
+  };
+
+  //----------------------------------------------------------------------------
+
+  /*
+   * Exports all reports of the report catalogue as PDF files
+   * into a directory.
+   *
+   * The reports are generated by a pool of worker threads. Each
+   * worker operates on its own read-only snapshot of the tournament
+   * database, so the tournament database can be modified while
+   * the export is running.
+   *
+   * start() and the destructor have to be called from the thread
+   * that owns the tournament database; all other functions can be
+   * called from any thread.
+   */
+  class BatchReportExporter
+  {
+  public:
+    BatchReportExporter(TournamentDB* _db, const QString& _outDir, int _nThreads = -1);
+    ~BatchReportExporter();
+
+    ERR start();
+    void requestCancellation();
+    void waitForFinished();
+
+    bool isFinished() const;
+    bool isCancellationRequested() const { return isCancelled; }
+    int getReportCount() const { return catalogue.size(); }
+    int getFinishedCount() const { return finishedCount; }
+    qint64 getTotalDuration__ms() const;
+    vector<ReportExportResult> getResults() const;   // in catalogue order; only complete after the export has finished
+    QString getTimingSummary() const;
+
+    static QString getFileNameForReport(const QString& repName);
+
+  private:
+    TournamentDB* db;
+    QString outDir;
+    int nThreads;
+
+    QStringList catalogue;
+    vector<thread> workers;
+    atomic<int> nextIndex;
+    atomic<int> finishedCount;
+    atomic<int> runningWorkers;
+    atomic<bool> isCancelled;
+
+    mutable mutex resultMutex;
+    vector<ReportExportResult> results;
+    QElapsedTimer clock;
+    qint64 totalDuration__ms;
+
+    void runWorker(shared_ptr<const DatabaseImage> img);
+  };
+
+}
+
+#endif // BATCHREPORTEXPORTER_H
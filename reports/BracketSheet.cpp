@@ -29,6 +29,8 @@
 #include "MatchMngr.h"
 #include "BracketGenerator.h"
 #include "PlayerMngr.h"
+#include "Player.h"
+#include "Score.h"
 
 namespace QTournament
 {
@@ -39,7 +41,7 @@ namespace QTournament
 
 
 BracketSheet::BracketSheet(TournamentDB* _db, const QString& _name, const Category& _cat)
-  :AbstractReport(_db, _name), cat(_cat), rawReport(nullptr)
+  :AbstractReport(_db, _name, _cat.getId()), cat(_cat), rawReport(nullptr)
 {
   // make sure the requested category has bracket visualization data
   auto bvd = BracketVisData::getExisting(cat);
@@ -52,6 +54,27 @@ BracketSheet::BracketSheet(TournamentDB* _db, const QString& _name, const Catego
 //----------------------------------------------------------------------------
 
 upSimpleReport BracketSheet::regenerateReport()
+{
+  return regeneratePages(0, -1);
+}
+
+//----------------------------------------------------------------------------
+
+/**
+ * @brief BracketSheet::regeneratePages renders a subset of the bracket's pages
+ *
+ * All match and player pair data of the category is read in one pass
+ * before rendering. Afterwards, the pages are emitted one after the other
+ * and each page only draws its own elements plus the continuation parts
+ * of elements that started on a previous page. Thus, printing a few pages
+ * of a huge bracket doesn't require rendering the whole bracket.
+ *
+ * @param firstPage the zero-based index of the first page to render
+ * @param lastPage the zero-based index of the last page to render or -1 for the bracket's last page
+ *
+ * @return a report containing the requested pages
+ */
+upSimpleReport BracketSheet::regeneratePages(int firstPage, int lastPage)
 {
   // get the handle of the overall bracket visualization data
   auto bvd = BracketVisData::getExisting(cat);
@@ -63,9 +86,13 @@ upSimpleReport BracketSheet::regenerateReport()
     return result;
   }
 
-  // update/fill potentially missing names in the bracket
-  bvd->fillMissingPlayerNames();
+  // missing names in the bracket have already been filled on the
+  // primary connection when the matches were finished; reports are
+  // generated on read-only snapshots and must not write anything
 
+  int numPages = bvd->getNumPages();
+  if (firstPage < 0) firstPage = 0;
+  if ((lastPage < 0) || (lastPage >= numPages)) lastPage = numPages - 1;
 
   BRACKET_PAGE_ORIENTATION pgOrientation;
   BRACKET_LABEL_POS labelPos;
@@ -77,279 +104,335 @@ upSimpleReport BracketSheet::regenerateReport()
   // the report will still use the same orientation as for the first page.
   tie(pgOrientation, labelPos) = bvd->getPageInfo(0);
 
+  // read all elements, matches and names of the bracket at once
+  prefetchBracketData(numPages);
+
   // initialize the report's first page
   upSimpleReport rep = (pgOrientation == BRACKET_PAGE_ORIENTATION::LANDSCAPE) ? createEmptyReport_Landscape() : createEmptyReport_Portrait();
   rawReport = rep.get();
 
-  // determine the conversion factor between "grid units" and "paper units" (millimeter)
+  // determine the conversion factor between "grid units" and "paper units" (millimeter);
+  // this is based on the whole bracket, so a subset of pages looks exactly
+  // like the same pages in the full report
   determineGridSize();
 
   // setup the text style, including a dynamically adapted text height
   setupTextStyle();
 
-  // two helper-lambdas for drawing horizontal and vertical lines
-  // using grid units instead of millimeters
-  auto drawHorLine = [&](int gridX0, int gridY0, int gridXLen) {
-    double x0;
-    double y0;
-    tie(x0, y0) = grid2MM(gridX0, gridY0);
-    rep->drawHorLine(x0, y0, gridXLen * xFac);
-  };
-  auto drawVertLine = [&](int gridX0, int gridY0, int gridYLen) {
-    double x0;
-    double y0;
-    tie(x0, y0) = grid2MM(gridX0, gridY0);
-    rep->drawVertLine(x0, y0, gridYLen * yFac);
-  };
-
-  // create all pages in advance
-  //
-  // we need this later to continue a bracket on page 1 although we're
-  // currently painting the bracket elements for page 0, for instance
-  for (int idxPage=0; idxPage < bvd->getNumPages(); ++idxPage)
+  // emit the pages one by one
+  for (int idxPage = firstPage; idxPage <= lastPage; ++idxPage)
   {
-    if (idxPage > 0)
+    if (idxPage > firstPage)
     {
       rep->startNextPage();
     }
-  }
 
-  // loop over all pages and bracket elements and draw them one by one
-  for (int idxPage=0; idxPage < bvd->getNumPages(); ++idxPage)
-  {
-    rawReport->setActivePage(idxPage);
+    for (int idx : elementsByPage[idxPage])
+    {
+      drawElement(elements[idx]);
+    }
 
-    for (const BracketVisElement& el : bvd->getVisElements(idxPage))
+    // the remaining parts of elements that started on a previous page
+    for (int idx : continuationsByPage[idxPage])
     {
-      int x0 = el.getGridX0();
-      int y0 = el.getGridY0();
-      int spanY = el.getSpanY();
-      int yPageBreakSpan = el.getYPageBreakSpan();
-      BRACKET_ORIENTATION orientation = el.getOrientation();
-      BRACKET_TERMINATOR terminator = el.getTerminator();
-
-      int xLen = -1;
-      if (orientation == BRACKET_ORIENTATION::RIGHT)
-      {
-        xLen = 1;
-      }
+      drawElementContinuation(elements[idx]);
+    }
 
-      // if the element spans multiple pages, adjust the "span"
-      // value accordingly
-      if (yPageBreakSpan > 0)
-      {
-        spanY = yPageBreakSpan;
-      }
+    // decorate the page with a label, if necessary
+    tie(pgOrientation, labelPos) = bvd->getPageInfo(idxPage);
+    if (labelPos != BRACKET_LABEL_POS::NONE)
+    {
+      printLabelOnCurrentPage(labelPos);
+    }
+  }
 
-      // draw the "open rectangle", but draw the bottom horizontal
-      // line only if we don't have a page break
-      drawHorLine(x0, y0, xLen);
-      drawVertLine(x0 + xLen, y0, spanY);
-      if (yPageBreakSpan == 0) drawHorLine(x0, y0 + spanY, xLen);
+  // done. Reset the internal raw pointer and return the unique_ptr to the caller
+  clearPrefetchedData();
+  rawReport = nullptr;
+  return rep;
+}
 
-      // restore the original spanY value for the further steps
-      if (yPageBreakSpan != 0)
-      {
-        spanY = el.getSpanY();
-      }
+//----------------------------------------------------------------------------
 
-      // if we have a bracket element that spans multiple pages,
-      // draw the lines on the second page
-      if (yPageBreakSpan != 0)
-      {
-        // jump to the continuation page
-        rawReport->setActivePage(el.getNextPageNum());
+QStringList BracketSheet::getReportLocators() const
+{
+  QStringList result;
 
-        // draw the remaining part of the bracket element
-        int remainingYSpan = spanY - yPageBreakSpan;
-        drawVertLine(x0 + xLen, 0, remainingYSpan);
-        drawHorLine(x0, remainingYSpan, xLen);
+  QString loc = tr("Brackets::");
+  loc += cat.getName();
 
-        // return to our current page
-        rawReport->setActivePage(idxPage);
-      }
+  result.append(loc);
 
-      // draw the terminator, if any
-      int termOffset = el.getTerminatorOffset();
-      if (terminator == BRACKET_TERMINATOR::OUTWARDS)
-      {
-        drawHorLine(x0 + xLen, y0 + spanY / 2 + termOffset, xLen);
-      }
-      if (terminator == BRACKET_TERMINATOR::INWARDS)
-      {
-        drawHorLine(x0 + xLen, y0 + spanY / 2 + termOffset, -xLen);
-      }
+  return result;
+}
+
+//----------------------------------------------------------------------------
+
+/**
+ * @brief BracketSheet::prefetchBracketData reads everything that is necessary
+ * for rendering the bracket with one pass over each involved table
+ *
+ * The semantics are the same as for the former per-element lookups via
+ * BracketVisElement::getLinkedMatch() and BracketVisElement::getLinkedPlayerPair().
+ *
+ * @param numPages the number of pages of the bracket
+ */
+void BracketSheet::prefetchBracketData(int numPages)
+{
+  clearPrefetchedData();
+  elementsByPage.resize(numPages);
+  continuationsByPage.resize(numPages);
+
+  int catId = cat.getId();
+
+  // pass 1: all matches of the category
+  QString where = "%1 IN (SELECT id FROM %2 WHERE %3 = %4)";
+  where = where.arg(MA_GRP_REF).arg(TAB_MATCH_GROUP);
+  where = where.arg(MG_CAT_REF).arg(catId);
+  DbTab::CachingRowIterator it = db->getTab(TAB_MATCH)->getRowsByWhereClause(where.toUtf8().constData());
+  while (!(it.isEnd()))
+  {
+    readMatchRow(*it);
+    ++it;
+  }
+
+  // pass 2: all player pairs of the category
+  WhereClause wc;
+  wc.addIntCol(PAIRS_CAT_REF, catId);
+  it = db->getTab(TAB_PAIRS)->getRowsByWhereClause(wc);
+  while (!(it.isEnd()))
+  {
+    TabRow r = *it;
+    auto p2 = r.getInt2(PAIRS_PLAYER2_REF);
+    pairId2PlayerIds[r.getId()] = make_pair(r.getInt(PAIRS_PLAYER1_REF), p2->isNull() ? -1 : p2->get());
+    ++it;
+  }
+
+  // pass 3: the names of all players in these pairs
+  where = "id IN (SELECT %1 FROM %3 WHERE %4 = %5) OR id IN (SELECT %2 FROM %3 WHERE %4 = %5)";
+  where = where.arg(PAIRS_PLAYER1_REF).arg(PAIRS_PLAYER2_REF);
+  where = where.arg(TAB_PAIRS).arg(PAIRS_CAT_REF).arg(catId);
+  it = db->getTab(TAB_PLAYER)->getRowsByWhereClause(where.toUtf8().constData());
+  while (!(it.isEnd()))
+  {
+    TabRow r = *it;
+    playerId2Names[r.getId()] = make_pair(QString::fromUtf8(r[PL_FNAME].data()), QString::fromUtf8(r[PL_LNAME].data()));
+    ++it;
+  }
 
-      // draw the initial rank, if any
-      int iniRank = el.getInitialRank1();
-      if (iniRank > 0)
+  // pass 4: all bracket elements
+  wc.clear();
+  wc.addIntCol(BV_CAT_REF, catId);
+  it = db->getTab(TAB_BRACKET_VIS)->getRowsByWhereClause(wc);
+  while (!(it.isEnd()))
+  {
+    TabRow r = *it;
+    ++it;
+
+    ElementRenderData el;
+    el.page = r.getInt(BV_PAGE);
+    el.gridX0 = r.getInt(BV_GRID_X0);
+    el.gridY0 = r.getInt(BV_GRID_Y0);
+    el.spanY = r.getInt(BV_SPAN_Y);
+    el.yPageBreakSpan = r.getInt(BV_Y_PAGEBREAK_SPAN);
+    el.nextPageNum = r.getInt(BV_NEXT_PAGE_NUM);
+    el.orientation = static_cast<BRACKET_ORIENTATION>(r.getInt(BV_ORIENTATION));
+    el.terminator = static_cast<BRACKET_TERMINATOR>(r.getInt(BV_TERMINATOR));
+    el.terminatorOffset = r.getInt(BV_TERMINATOR_OFFSET_Y);
+    el.initialRank1 = r.getInt(BV_INITIAL_RANK1);
+    el.initialRank2 = r.getInt(BV_INITIAL_RANK2);
+    el.hasMatch = false;
+    el.matchState = STAT_MA_INCOMPLETE;
+    el.matchNum = MATCH_NUM_NOT_ASSIGNED;
+    el.winnerRank = -1;
+    el.winnerPairId = -1;
+
+    const MatchRenderData* ma = nullptr;
+    auto maRef = r.getInt2(BV_MATCH_REF);
+    if (!(maRef->isNull())) ma = getMatchData(maRef->get());
+
+    if (ma != nullptr)
+    {
+      // case 1: there is a valid match linked to this bracket element
+      el.hasMatch = true;
+      el.matchState = ma->state;
+      el.matchNum = ma->matchNum;
+      el.scoreText = ma->scoreText;
+      el.winnerRank = ma->winnerRank;
+      if (ma->winner > 0) el.winnerPairId = ma->pairId[ma->winner - 1];
+
+      for (int pos=0; pos < 2; ++pos)
       {
-        drawBracketTextItem(x0, y0, spanY, orientation,
-                            QString::number(iniRank) + ".",
-                            BRACKET_TEXT_ELEMENT::INITIAL_RANK1);
+        el.pairId[pos] = ma->pairId[pos];
+        if (el.pairId[pos] > 0) continue;
+
+        // process only losers; we don't need to print "Winner of #xxx", because that's indicated by the graph
+        int symbVal = ma->symbolicVal[pos];
+        if (symbVal >= 0) continue;
+        const MatchRenderData* srcMatch = getMatchData(-symbVal);
+        if ((srcMatch == nullptr) || (srcMatch->matchNum == MATCH_NUM_NOT_ASSIGNED)) continue;
+
+        QString txt = "(%1 #%2)";
+        txt = txt.arg(tr("Loser"));
+        txt = txt.arg(srcMatch->matchNum);
+        el.symbolicName[pos] = txt;
       }
-      iniRank = el.getInitialRank2();
-      if (iniRank > 0)
+    } else {
+      // case 2: we have fixed, static player pair references
+      // stored for this bracket element (or none at all)
+      for (int pos=0; pos < 2; ++pos)
       {
-        drawBracketTextItem(x0, y0, spanY, orientation,
-                            QString::number(iniRank) + ".",
-                            BRACKET_TEXT_ELEMENT::INITIAL_RANK2);
-      }
+        auto ppRef = r.getInt2((pos == 0) ? BV_PAIR1_REF : BV_PAIR2_REF);
+        el.pairId[pos] = ppRef->isNull() ? -1 : ppRef->get();
 
-      //
-      // print the actual or symbolic player names, if any
-      //
-      PlayerMngr pm{db};
-      QString pairName;
-      bool isSymbolic = false;
-      int ppId = determineEffectivePlayerPairId(el, 1);
-      if (ppId < 0)
-      {
-        pairName = determineSymbolicPlayerPairDisplayText(el, 1);
-        isSymbolic = true;
-      } else {
-        PlayerPair pp = pm.getPlayerPair(ppId);
-        pairName = getTruncatedPlayerName(pp, xFac - 2 * GAP_LINE_TXT__MM, rawReport->getTextStyle(BRACKET_STYLE));
+        // the branch is unused, so we label it with "--"
+        if (el.pairId[pos] < 0) el.symbolicName[pos] = "--";
       }
-      drawBracketTextItem(x0, y0, spanY, orientation, pairName, BRACKET_TEXT_ELEMENT::PAIR1,
-                          isSymbolic ? BRACKET_STYLE_ITALICS : QString());
 
-      ppId = determineEffectivePlayerPairId(el, 2);
-      isSymbolic = false;
-      if (ppId < 0)
+      // if there was no match in the last round, derive the
+      // winner rank from the NextMatchId but ONLY if we have a
+      // directly linked player pair.
+      // This case covers that a player was "warped" to the final
+      // rank because there is an insufficient number of players
+      // to actually play all matches
+      if ((el.pairId[0] > 0) || (el.pairId[1] > 0))
       {
-        pairName = determineSymbolicPlayerPairDisplayText(el, 2);
-        isSymbolic = true;
-      } else {
-        PlayerPair pp = pm.getPlayerPair(ppId);
-        pairName = getTruncatedPlayerName(pp, xFac - 2 * GAP_LINE_TXT__MM, rawReport->getTextStyle(BRACKET_STYLE));
+        int nextWinnerMatch = r.getInt(BV_NEXT_WINNER_MATCH);
+        if (nextWinnerMatch < 0) el.winnerRank = -nextWinnerMatch;
+        el.winnerPairId = (el.pairId[0] > 0) ? el.pairId[0] : el.pairId[1];
       }
-      if (yPageBreakSpan > 0)   // does the name of the second pair go on the next page?
-      {
-        // jump to the continuation page
-        rawReport->setActivePage(el.getNextPageNum());
+    }
 
-        // draw the remaining part of the bracket element
-        int remainingYSpan = spanY - yPageBreakSpan;
-        drawBracketTextItem(x0, 0, remainingYSpan, orientation, pairName, BRACKET_TEXT_ELEMENT::PAIR2,
-                            isSymbolic ? BRACKET_STYLE_ITALICS : QString());
+    // sort the element into the page buckets
+    if ((el.page < 0) || (el.page >= numPages)) continue;
+    int idx = elements.size();
+    elements.push_back(el);
+    elementsByPage[el.page].push_back(idx);
+    if ((el.yPageBreakSpan != 0) && (el.nextPageNum >= 0) && (el.nextPageNum < numPages))
+    {
+      continuationsByPage[el.nextPageNum].push_back(idx);
+    }
+  }
+}
 
-        // return to our current page
-        rawReport->setActivePage(idxPage);
-      } else {
-        drawBracketTextItem(x0, y0, spanY, orientation, pairName, BRACKET_TEXT_ELEMENT::PAIR2,
-                            isSymbolic ? BRACKET_STYLE_ITALICS : QString());
-      }
+//----------------------------------------------------------------------------
 
-      //
-      // Decorate the bracket with match data, if existing
-      //
+void BracketSheet::clearPrefetchedData()
+{
+  elements.clear();
+  elementsByPage.clear();
+  continuationsByPage.clear();
+  matchId2Data.clear();
+  pairId2PlayerIds.clear();
+  playerId2Names.clear();
+  pairId2TruncatedName.clear();
+}
 
-      // is there a match connected to this bracket element?
-      auto ma = el.getLinkedMatch();
-      if (ma != nullptr)
-      {
-        // print match number or result, if any
-        OBJ_STATE stat = ma->getState();
-        int matchNum = ma->getMatchNumber();
-        if (stat == STAT_MA_FINISHED)
-        {
-          QString scTxt;
-          if (ma->isWonByWalkover())
-          {
-            scTxt = tr("walkover");
-          } else {
-            auto score = ma->getScore();
-            scTxt = score->toString();
-            scTxt.replace(",", "  ");
-          }
-          drawBracketTextItem(x0, y0, spanY, orientation, scTxt, BRACKET_TEXT_ELEMENT::SCORE);
-        }
-        else if (matchNum > 0)
-        {
-          QString s = "#" + QString::number(matchNum);
-          drawBracketTextItem(x0, y0, spanY, orientation, s, BRACKET_TEXT_ELEMENT::MATCH_NUM);
-        }
-      }
+//----------------------------------------------------------------------------
 
-      // print final rank for winner, if any
-      int winRank = -1;
-      upPlayerPair winnerName = nullptr;
-      if (ma != nullptr)
-      {
-        // case 1: get the winner rank from the direcly linked match
-        winRank = ma->getWinnerRank();
-        winnerName = ma->getWinner();
-      } else {
-        // case 2: if there was no match in the last round,
-        // derived the winner rank from the NextMatchId but ONLY
-        // if we have a directly linked player pair.
-        // This case covers that a player was "warped" to the final
-        // rank because there is an insufficient number of players
-        // to actually play all matches
-        auto pp1 = el.getLinkedPlayerPair(1);
-        auto pp2 = el.getLinkedPlayerPair(2);
-        if ((pp1 != nullptr) || (pp2 != nullptr))
-        {
-          int nextWinnerMatch = el.getNextBracketElementForWinner();
-          if (nextWinnerMatch < 0) winRank = -nextWinnerMatch;
-          winnerName = (pp1 != nullptr) ? std::move(pp1) : std::move(pp2);
-        }
-      }
-      if ((terminator != BRACKET_TERMINATOR::NONE) && (winRank > 0))
+void BracketSheet::readMatchRow(const TabRow& r)
+{
+  MatchRenderData md;
+
+  for (int pos=0; pos < 2; ++pos)
+  {
+    auto ppRef = r.getInt2((pos == 0) ? MA_PAIR1_REF : MA_PAIR2_REF);
+    md.pairId[pos] = ppRef->isNull() ? -1 : ppRef->get();
+
+    auto symbVal = r.getInt2((pos == 0) ? MA_PAIR1_SYMBOLIC_VAL : MA_PAIR2_SYMBOLIC_VAL);
+    md.symbolicVal[pos] = symbVal->isNull() ? 0 : symbVal->get();
+  }
+
+  md.state = static_cast<OBJ_STATE>(r.getInt(GENERIC_STATE_FIELD_NAME));
+  auto maNum = r.getInt2(MA_NUM);
+  md.matchNum = maNum->isNull() ? MATCH_NUM_NOT_ASSIGNED : maNum->get();
+
+  // a finished match without a finish time
+  // has been won by a walkover
+  md.isWalkover = ((md.state == STAT_MA_FINISHED) && (r.getInt2(MA_FINISH_TIME)->isNull()));
+
+  // decode the score; like in Match::getScore() we assume
+  // that every score in the database is valid
+  md.winner = 0;
+  auto scoreEntry = r.getString2(MA_RESULT);
+  if (!(scoreEntry->isNull()))
+  {
+    auto score = MatchScore::fromStringWithoutValidation(QString::fromUtf8(scoreEntry->get().data()));
+    if (score != nullptr)
+    {
+      md.winner = score->getWinner();
+      if (md.state == STAT_MA_FINISHED)
       {
-        // add an offset to x0 in case we have inwards offsets
-        int tmpX0 = x0;
-        if (terminator == BRACKET_TERMINATOR::INWARDS)
-        {
-          if (orientation == BRACKET_ORIENTATION::LEFT)
-          {
-            ++x0;
-          } else {
-            --x0;
-          }
-        }
-
-        QString txt = QString::number(winRank) + ". " + tr("Place");
-        drawBracketTextItem(x0, y0 + termOffset, spanY, orientation, txt, BRACKET_TEXT_ELEMENT::WINNER_RANK);
-
-        // if the match is finished, print the winner's name as well
-        if (winnerName != nullptr)
-        {
-          QString txt = getTruncatedPlayerName(*winnerName, xFac - 2 * GAP_LINE_TXT__MM, rawReport->getTextStyle(BRACKET_STYLE));
-          drawBracketTextItem(x0, y0 + termOffset, spanY, orientation, txt, BRACKET_TEXT_ELEMENT::TERMINATOR_NAME);
-        }
-
-        // restore the original x0
-        x0 = tmpX0;
+        md.scoreText = score->toString();
+        md.scoreText.replace(",", "  ");
       }
     }
   }
+  if (md.isWalkover) md.scoreText = tr("walkover");
 
-  // decorate all pages with labels, if necessary
-  printHeaderAndFooterOnAllPages();
+  auto wr = r.getInt2(MA_WINNER_RANK);
+  md.winnerRank = wr->isNull() ? -1 : wr->get();
+  if (md.winnerRank < 1) md.winnerRank = -1;
 
-  // done. Reset the internal raw pointer and return the unique_ptr to the caller
-  rawReport = nullptr;
-  return rep;
+  matchId2Data[r.getId()] = md;
 }
 
 //----------------------------------------------------------------------------
 
-QStringList BracketSheet::getReportLocators() const
+const BracketSheet::MatchRenderData* BracketSheet::getMatchData(int matchId)
 {
-  QStringList result;
+  auto it = matchId2Data.find(matchId);
+  if (it == matchId2Data.end())
+  {
+    // the match doesn't belong to this category (shouldn't happen)
+    auto r = db->getTab(TAB_MATCH)->getSingleRowByColumnValue2("id", matchId);
+    if (r == nullptr) return nullptr;
 
-  QString loc = tr("Brackets::");
-  loc += cat.getName();
+    readMatchRow(*r);
+    it = matchId2Data.find(matchId);
+  }
 
-  result.append(loc);
+  return &(it->second);
+}
+
+//----------------------------------------------------------------------------
+
+pair<int, int> BracketSheet::getPlayerIdsForPair(int pairId)
+{
+  auto it = pairId2PlayerIds.find(pairId);
+  if (it != pairId2PlayerIds.end()) return it->second;
+
+  // the pair doesn't belong to this category (shouldn't happen)
+  auto r = db->getTab(TAB_PAIRS)->getSingleRowByColumnValue2("id", pairId);
+  if (r == nullptr) return make_pair(-1, -1);
+
+  auto p2 = r->getInt2(PAIRS_PLAYER2_REF);
+  pair<int, int> result = make_pair(r->getInt(PAIRS_PLAYER1_REF), p2->isNull() ? -1 : p2->get());
+  pairId2PlayerIds[pairId] = result;
 
   return result;
 }
 
 //----------------------------------------------------------------------------
 
+const pair<QString, QString>& BracketSheet::getPlayerNames(int playerId)
+{
+  auto it = playerId2Names.find(playerId);
+  if (it != playerId2Names.end()) return it->second;
+
+  // the player has not been prefetched (shouldn't happen)
+  pair<QString, QString> names;
+  auto r = db->getTab(TAB_PLAYER)->getSingleRowByColumnValue2("id", playerId);
+  if (r != nullptr)
+  {
+    names = make_pair(QString::fromUtf8((*r)[PL_FNAME].data()), QString::fromUtf8((*r)[PL_LNAME].data()));
+  }
+
+  return playerId2Names.emplace(playerId, names).first->second;
+}
+
+//----------------------------------------------------------------------------
+
 /**
  * @brief BracketSheet::determineGridSize calculates the size of one grid unit
  * in millimeters, depending on the extends of bracket
@@ -359,34 +442,29 @@ QStringList BracketSheet::getReportLocators() const
 void BracketSheet::determineGridSize()
 {
   // determine the maximum extends of the bracket for this category
-  // by searching through all bracket visualisation entries
-  // get the handle of the overall bracket visualization data
-  auto bvd = BracketVisData::getExisting(cat);
-  assert(bvd != nullptr);
+  // by searching through all prefetched bracket visualisation entries
   int maxX = -1;
   int maxY = -1;
-  for (const BracketVisElement& el : bvd->getVisElements())
+  for (const ElementRenderData& el : elements)
   {
-    int x = el.getGridX0();
-    int y = el.getGridY0();
-    int spanY = el.getSpanY();
-    BRACKET_ORIENTATION orientation = el.getOrientation();
-    BRACKET_TERMINATOR terminator = el.getTerminator();
+    int x = el.gridX0;
+    int y = el.gridY0;
+    int spanY = el.spanY;
 
-    if (orientation == BRACKET_ORIENTATION::RIGHT)
+    if (el.orientation == BRACKET_ORIENTATION::RIGHT)
     {
       ++x;  // reserve space to the right for the bracket itself
     }
 
-    if (terminator == BRACKET_TERMINATOR::OUTWARDS)
+    if (el.terminator == BRACKET_TERMINATOR::OUTWARDS)
     {
       ++x;  // reserve space for the terminator-line
     }
 
     // reduce the spanY in case the bracket element spans multiple pages
-    if (el.getYPageBreakSpan() > 0)
+    if (el.yPageBreakSpan > 0)
     {
-      spanY = el.getYPageBreakSpan();
+      spanY = el.yPageBreakSpan;
     }
 
     if (x > maxX) maxX = x;
@@ -438,6 +516,159 @@ tuple<double, double> BracketSheet::grid2MM(int gridX, int gridY) const
 
 //----------------------------------------------------------------------------
 
+void BracketSheet::drawHorLine(int gridX0, int gridY0, int gridXLen) const
+{
+  double x0;
+  double y0;
+  tie(x0, y0) = grid2MM(gridX0, gridY0);
+  rawReport->drawHorLine(x0, y0, gridXLen * xFac);
+}
+
+//----------------------------------------------------------------------------
+
+void BracketSheet::drawVertLine(int gridX0, int gridY0, int gridYLen) const
+{
+  double x0;
+  double y0;
+  tie(x0, y0) = grid2MM(gridX0, gridY0);
+  rawReport->drawVertLine(x0, y0, gridYLen * yFac);
+}
+
+//----------------------------------------------------------------------------
+
+/**
+ * @brief BracketSheet::drawElement draws all parts of a bracket element
+ * that go on the element's own page
+ *
+ * The parts on the continuation page are drawn by drawElementContinuation().
+ */
+void BracketSheet::drawElement(const ElementRenderData& el)
+{
+  int x0 = el.gridX0;
+  int y0 = el.gridY0;
+  int spanY = el.spanY;
+  int xLen = (el.orientation == BRACKET_ORIENTATION::RIGHT) ? 1 : -1;
+
+  // draw the "open rectangle", but draw the bottom horizontal
+  // line only if we don't have a page break
+  drawHorLine(x0, y0, xLen);
+  drawVertLine(x0 + xLen, y0, (el.yPageBreakSpan > 0) ? el.yPageBreakSpan : spanY);
+  if (el.yPageBreakSpan == 0) drawHorLine(x0, y0 + spanY, xLen);
+
+  // draw the terminator, if any
+  int termOffset = el.terminatorOffset;
+  if (el.terminator == BRACKET_TERMINATOR::OUTWARDS)
+  {
+    drawHorLine(x0 + xLen, y0 + spanY / 2 + termOffset, xLen);
+  }
+  if (el.terminator == BRACKET_TERMINATOR::INWARDS)
+  {
+    drawHorLine(x0 + xLen, y0 + spanY / 2 + termOffset, -xLen);
+  }
+
+  // draw the initial rank, if any
+  if (el.initialRank1 > 0)
+  {
+    drawBracketTextItem(x0, y0, spanY, el.orientation,
+                        QString::number(el.initialRank1) + ".",
+                        BRACKET_TEXT_ELEMENT::INITIAL_RANK1);
+  }
+  if (el.initialRank2 > 0)
+  {
+    drawBracketTextItem(x0, y0, spanY, el.orientation,
+                        QString::number(el.initialRank2) + ".",
+                        BRACKET_TEXT_ELEMENT::INITIAL_RANK2);
+  }
+
+  // print the actual or symbolic player names, if any;
+  // the name of the second pair might go on the next page
+  drawPairName(el, 1, y0, spanY, BRACKET_TEXT_ELEMENT::PAIR1);
+  if (el.yPageBreakSpan <= 0)
+  {
+    drawPairName(el, 2, y0, spanY, BRACKET_TEXT_ELEMENT::PAIR2);
+  }
+
+  //
+  // Decorate the bracket with match data, if existing
+  //
+
+  // print match number or result, if any
+  if (el.hasMatch)
+  {
+    if (el.matchState == STAT_MA_FINISHED)
+    {
+      drawBracketTextItem(x0, y0, spanY, el.orientation, el.scoreText, BRACKET_TEXT_ELEMENT::SCORE);
+    }
+    else if (el.matchNum > 0)
+    {
+      QString s = "#" + QString::number(el.matchNum);
+      drawBracketTextItem(x0, y0, spanY, el.orientation, s, BRACKET_TEXT_ELEMENT::MATCH_NUM);
+    }
+  }
+
+  // print final rank for winner, if any
+  if ((el.terminator != BRACKET_TERMINATOR::NONE) && (el.winnerRank > 0))
+  {
+    // add an offset to x0 in case we have inwards offsets
+    if (el.terminator == BRACKET_TERMINATOR::INWARDS)
+    {
+      if (el.orientation == BRACKET_ORIENTATION::LEFT)
+      {
+        ++x0;
+      } else {
+        --x0;
+      }
+    }
+
+    QString txt = QString::number(el.winnerRank) + ". " + tr("Place");
+    drawBracketTextItem(x0, y0 + termOffset, spanY, el.orientation, txt, BRACKET_TEXT_ELEMENT::WINNER_RANK);
+
+    // if the match is finished, print the winner's name as well
+    if (el.winnerPairId > 0)
+    {
+      txt = getTruncatedPairName(el.winnerPairId);
+      drawBracketTextItem(x0, y0 + termOffset, spanY, el.orientation, txt, BRACKET_TEXT_ELEMENT::TERMINATOR_NAME);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+
+/**
+ * @brief BracketSheet::drawElementContinuation draws the remaining part of
+ * a bracket element that spans two pages; the continuation page must be the
+ * current page of the report
+ */
+void BracketSheet::drawElementContinuation(const ElementRenderData& el)
+{
+  int xLen = (el.orientation == BRACKET_ORIENTATION::RIGHT) ? 1 : -1;
+  int remainingYSpan = el.spanY - el.yPageBreakSpan;
+
+  drawVertLine(el.gridX0 + xLen, 0, remainingYSpan);
+  drawHorLine(el.gridX0, remainingYSpan, xLen);
+
+  if (el.yPageBreakSpan > 0)
+  {
+    drawPairName(el, 2, 0, remainingYSpan, BRACKET_TEXT_ELEMENT::PAIR2);
+  }
+}
+
+//----------------------------------------------------------------------------
+
+void BracketSheet::drawPairName(const ElementRenderData& el, int pos, int bracketY0, int ySpan, BracketSheet::BRACKET_TEXT_ELEMENT item)
+{
+  int ppId = el.pairId[pos - 1];
+  if (ppId > 0)
+  {
+    drawBracketTextItem(el.gridX0, bracketY0, ySpan, el.orientation, getTruncatedPairName(ppId), item);
+  } else {
+    drawBracketTextItem(el.gridX0, bracketY0, ySpan, el.orientation, el.symbolicName[pos - 1], item, BRACKET_STYLE_ITALICS);
+  }
+}
+
+//----------------------------------------------------------------------------
+
+
 /*
  * The following code uses the following points for text elements:
  *
@@ -589,17 +820,19 @@ void BracketSheet::drawBracketTextItem(int bracketX0, int bracketY0, int ySpan,
 
 //----------------------------------------------------------------------------
 
-QString BracketSheet::getTruncatedPlayerName(const Player& p, const QString& postfix, double maxWidth, SimpleReportLib::TextStyle* style) const
+QString BracketSheet::getTruncatedPlayerName(int playerId, const QString& postfix, double maxWidth, SimpleReportLib::TextStyle* style)
 {
-  int fullLen = p.getDisplayName().length();
+  const pair<QString, QString>& names = getPlayerNames(playerId);
+  QString fullName = Player::getDisplayName(names.first, names.second);
+  int fullLen = fullName.length();
 
   // we can't have truncated names of less than six characters
-  if (fullLen < 6) return p.getDisplayName() + postfix;
+  if (fullLen < 6) return fullName + postfix;
 
   QString truncName;
   for (int len = fullLen; len > 3; --len)
   {
-    truncName = p.getDisplayName(len) + postfix;
+    truncName = Player::getDisplayName(names.first, names.second, len) + postfix;
     double width = rawReport->getTextDimensions_MM(truncName, style).width();
     if (width <= maxWidth) return truncName;
   }
@@ -609,108 +842,37 @@ QString BracketSheet::getTruncatedPlayerName(const Player& p, const QString& pos
 
 //----------------------------------------------------------------------------
 
-QString BracketSheet::getTruncatedPlayerName(const PlayerPair& pp, double maxWidth, SimpleReportLib::TextStyle* style) const
+QString BracketSheet::getTruncatedPairName(int pairId)
 {
-  if (pp.hasPlayer2())
+  // all pair names in the bracket use the same width and style,
+  // so we can re-use the result for all further appearances of the pair
+  auto it = pairId2TruncatedName.find(pairId);
+  if (it != pairId2TruncatedName.end()) return it->second;
+
+  double maxWidth = xFac - 2 * GAP_LINE_TXT__MM;
+  SimpleReportLib::TextStyle* style = rawReport->getTextStyle(BRACKET_STYLE);
+
+  QString result;
+  int p1Id;
+  int p2Id;
+  tie(p1Id, p2Id) = getPlayerIdsForPair(pairId);
+  if (p2Id > 0)
   {
-    QString p1Name = getTruncatedPlayerName(pp.getPlayer1(), " /", maxWidth, style);
-    QString p2Name = getTruncatedPlayerName(pp.getPlayer2(), QString(), maxWidth, style);
-    return p1Name + "\n" + p2Name;
+    QString p1Name = getTruncatedPlayerName(p1Id, " /", maxWidth, style);
+    QString p2Name = getTruncatedPlayerName(p2Id, QString(), maxWidth, style);
+    result = p1Name + "\n" + p2Name;
+  } else {
+    result = getTruncatedPlayerName(p1Id, QString(), maxWidth, style);
   }
 
-  return getTruncatedPlayerName(pp.getPlayer1(), QString(), maxWidth, style);
-}
-
-//----------------------------------------------------------------------------
-
-void BracketSheet::drawWinnerNameOnTerminator(const QPointF& txtBottomCenter, const PlayerPair& pp, double gridWidth, SimpleReportLib::TextStyle* style) const
-{
-  QString p1Postfix;
-  QString p2Name;
-  if (pp.hasPlayer2())
-  {
-    p1Postfix = " /";
-    p2Name = getTruncatedPlayerName(pp.getPlayer2(), QString(), gridWidth - 2 * GAP_LINE_TXT__MM, style);
-  }
-  QString p1Name = getTruncatedPlayerName(pp.getPlayer1(), p1Postfix, gridWidth - 2 * GAP_LINE_TXT__MM, style);
-
-  QString fullName = (p2Name.isEmpty()) ? p1Name : p1Name + "\n" + p2Name;
-  rawReport->drawMultilineText(txtBottomCenter, SimpleReportLib::RECT_CORNER::BOTTOM_CENTER, fullName, SimpleReportLib::CENTER,
-                               0.1 * style->getFontSize_MM(), style);
-}
-
-//----------------------------------------------------------------------------
-
-QString BracketSheet::determineSymbolicPlayerPairDisplayText(const BracketVisElement& el, int pos) const
-{
-  assert(el.getCategoryId() == cat.getId());
-  assert((pos > 0) && (pos < 3));
-
-  // is there a symbolic name?
-  auto ma = el.getLinkedMatch();
-  if (ma != nullptr)
-  {
-    int symbName = (pos == 1) ? ma->getSymbolicPlayerPair1Name() : ma->getSymbolicPlayerPair2Name();
-    if (symbName < 0)   // process only loser; we don't need to print "Winner of #xxx", because that's indicated by the graph
-    {
-      QString txt = "(%1 #%2)";
-      txt = txt.arg(tr("Loser"));
-      txt = txt.arg(-symbName);
-      return txt;
-    }
-
-    return QString();  // nothing to display for this match
-  }
-
-  // default: the branch is unused, so we label it with "--"
-  return "--";
-}
-
-//----------------------------------------------------------------------------
-
-int BracketSheet::determineEffectivePlayerPairId(const BracketVisElement& el, int pos) const
-{
-  assert(el.getCategoryId() == cat.getId());
-  assert((pos > 0) && (pos < 3));
-
-  // is there a match connected to this bracket element?
-  auto ma = el.getLinkedMatch();
-
-  // case 1: there is valid match linked to this bracket element
-  if (ma != nullptr)
-  {
-    // case 1a: the match has valid player pairs
-    // in this case, return their display name
-    bool foundPlayerPair = (pos == 1) ? ma->hasPlayerPair1() : ma->hasPlayerPair2();
-    if (foundPlayerPair)
-    {
-      PlayerPair pp = (pos == 1) ? ma->getPlayerPair1() : ma->getPlayerPair2();
-      return pp.getPairId();
-    }
-
-    return -1;  // nothing found for this match
-  }
-
-  // case 2: we have fixed, static player pair references stored for this bracket element
-  auto pp = el.getLinkedPlayerPair(pos);
-  if (pp != nullptr)
-  {
-    return pp->getPairId();
-  }
-
-  return -1;   // no player pair at all
+  pairId2TruncatedName[pairId] = result;
+  return result;
 }
 
 //----------------------------------------------------------------------------
 
-void BracketSheet::printHeaderAndFooterOnAllPages() const
+void BracketSheet::printLabelOnCurrentPage(BRACKET_LABEL_POS labelPos) const
 {
-  // get the handle of the overall bracket visualization data
-  auto bvd = BracketVisData::getExisting(cat);
-  if (bvd == nullptr) return;
-
-  assert(bvd->getNumPages() == rawReport->getPageCount());
-
   // prepare the elements of the label: headline, organizer name, date
   QString headline = cat.getName() + " -- " + tr("Bracket");
   QString org = "%1 -- %2";
@@ -727,82 +889,66 @@ void BracketSheet::printHeaderAndFooterOnAllPages() const
   auto orgStyle = rawReport->getTextStyle(SimpleReportLib::SimpleReportGenerator::DEFAULT_HEADER_STYLE_NAME);
   assert(orgStyle != nullptr);
 
-  // loop over all pages to check if and where to print a label
-  for (int pg=0; pg < rawReport->getPageCount(); ++pg)
+  // determine text alignment and base point
+  double x0 = DEFAULT_MARGIN__MM;
+  double y0 = DEFAULT_MARGIN__MM;
+  SimpleReportLib::HOR_TXT_ALIGNMENT align = SimpleReportLib::LEFT;
+  if ((labelPos == BRACKET_LABEL_POS::TOP_RIGHT) || (labelPos == BRACKET_LABEL_POS::BOTTOM_RIGHT))
   {
-    BRACKET_PAGE_ORIENTATION orientation;
-    BRACKET_LABEL_POS labelPos;
-    tie(orientation, labelPos) = bvd->getPageInfo(pg);
-
-    if (labelPos == BRACKET_LABEL_POS::NONE) continue;
-
-    rawReport->setActivePage(pg);
-
-    // determine text alignment and base point
-    double x0 = DEFAULT_MARGIN__MM;
-    double y0 = DEFAULT_MARGIN__MM;
-    SimpleReportLib::HOR_TXT_ALIGNMENT align = SimpleReportLib::LEFT;
-    if ((labelPos == BRACKET_LABEL_POS::TOP_RIGHT) || (labelPos == BRACKET_LABEL_POS::BOTTOM_RIGHT))
-    {
-      align = SimpleReportLib::RIGHT;
-      x0 = rawReport->getPageWidth() - DEFAULT_MARGIN__MM;
-    }
-    if ((labelPos == BRACKET_LABEL_POS::BOTTOM_LEFT) || (labelPos == BRACKET_LABEL_POS::BOTTOM_RIGHT))
-    {
-      y0 = rawReport->getPageHeight() - DEFAULT_MARGIN__MM;
-
-      // subtract the height for three lines of text
-      double txtHeight = headlineStyle->getFontSize_MM();  // headline height
-      txtHeight += orgStyle->getFontSize_MM();      // orga line height
-      txtHeight += rawReport->getTextStyle()->getFontSize_MM();   // date line height
-
-      // add factor for line space
-      txtHeight *= 1.1;
-
-      // shift the text's base position up by txtHeight
-      y0 -= txtHeight;
-    }
+    align = SimpleReportLib::RIGHT;
+    x0 = rawReport->getPageWidth() - DEFAULT_MARGIN__MM;
+  }
+  if ((labelPos == BRACKET_LABEL_POS::BOTTOM_LEFT) || (labelPos == BRACKET_LABEL_POS::BOTTOM_RIGHT))
+  {
+    y0 = rawReport->getPageHeight() - DEFAULT_MARGIN__MM;
 
-    //
-    // actually print the text
-    //
-    // for top-aligned text the sequence is: org, headline, date
-    // for bottom aligned text the sequence is: headline, date, org
-    //
+    // subtract the height for three lines of text
+    double txtHeight = headlineStyle->getFontSize_MM();  // headline height
+    txtHeight += orgStyle->getFontSize_MM();      // orga line height
+    txtHeight += rawReport->getTextStyle()->getFontSize_MM();   // date line height
 
-    if ((labelPos == BRACKET_LABEL_POS::TOP_LEFT) || (labelPos == BRACKET_LABEL_POS::TOP_RIGHT))
-    {
-      y0 -= orgStyle->getFontSize_MM();
+    // add factor for line space
+    txtHeight *= 1.1;
 
-      // org
-      QRectF bb = rawReport->drawText(x0, y0, org, orgStyle, align);
-      y0 += bb.height() * 2.0;
+    // shift the text's base position up by txtHeight
+    y0 -= txtHeight;
+  }
 
-      // headline
-      bb = rawReport->drawText(x0, y0, headline, headlineStyle, align);
-      y0 += bb.height() * 1.1;
+  //
+  // actually print the text
+  //
+  // for top-aligned text the sequence is: org, headline, date
+  // for bottom aligned text the sequence is: headline, date, org
+  //
 
-      // date
-      rawReport->drawText(x0, y0, dat, "", align);
-    }
+  if ((labelPos == BRACKET_LABEL_POS::TOP_LEFT) || (labelPos == BRACKET_LABEL_POS::TOP_RIGHT))
+  {
+    y0 -= orgStyle->getFontSize_MM();
 
-    if ((labelPos == BRACKET_LABEL_POS::BOTTOM_LEFT) || (labelPos == BRACKET_LABEL_POS::BOTTOM_RIGHT))
-    {
-      // headline
-      QRectF bb = rawReport->drawText(x0, y0, headline, headlineStyle, align);
-      y0 += bb.height() * 1.1;
+    // org
+    QRectF bb = rawReport->drawText(x0, y0, org, orgStyle, align);
+    y0 += bb.height() * 2.0;
 
-      // date
-      bb = rawReport->drawText(x0, y0, dat, "", align);
-      y0 += bb.height() * 1.1;
+    // headline
+    bb = rawReport->drawText(x0, y0, headline, headlineStyle, align);
+    y0 += bb.height() * 1.1;
 
-      // org
-      rawReport->drawText(x0, y0, org, orgStyle, align);
-    }
+    // date
+    rawReport->drawText(x0, y0, dat, "", align);
+  }
 
+  if ((labelPos == BRACKET_LABEL_POS::BOTTOM_LEFT) || (labelPos == BRACKET_LABEL_POS::BOTTOM_RIGHT))
+  {
+    // headline
+    QRectF bb = rawReport->drawText(x0, y0, headline, headlineStyle, align);
+    y0 += bb.height() * 1.1;
 
-    // determine text base point
+    // date
+    bb = rawReport->drawText(x0, y0, dat, "", align);
+    y0 += bb.height() * 1.1;
 
+    // org
+    rawReport->drawText(x0, y0, org, orgStyle, align);
   }
 }
 
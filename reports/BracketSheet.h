@@ -21,6 +21,8 @@
 
 #include <functional>
 #include <tuple>
+#include <vector>
+#include <unordered_map>
 
 #include <QObject>
 
@@ -60,26 +62,88 @@ namespace QTournament
     virtual upSimpleReport regenerateReport() override;
     virtual QStringList getReportLocators() const override;
 
+    // renders only the pages firstPage...lastPage (zero-based, inclusive);
+    // lastPage = -1 means "up to the last page of the bracket"
+    upSimpleReport regeneratePages(int firstPage, int lastPage);
+
     static constexpr double GAP_LINE_TXT__MM = 1.0;
 
   private:
+    // everything we need for drawing a single bracket element,
+    // read from the database in one pass before rendering
+    struct ElementRenderData
+    {
+      int page;
+      int gridX0;
+      int gridY0;
+      int spanY;
+      int yPageBreakSpan;
+      int nextPageNum;
+      BRACKET_ORIENTATION orientation;
+      BRACKET_TERMINATOR terminator;
+      int terminatorOffset;
+      int initialRank1;
+      int initialRank2;
+
+      int pairId[2];   // -1 if there is no (effective) player pair
+      QString symbolicName[2];   // only used if there is no player pair
+
+      bool hasMatch;
+      OBJ_STATE matchState;
+      int matchNum;
+      QString scoreText;   // empty if the match is not finished
+      int winnerRank;   // -1 if none
+      int winnerPairId;   // -1 if none
+    };
+
+    // the relevant columns of a match row
+    struct MatchRenderData
+    {
+      int pairId[2];
+      int symbolicVal[2];
+      OBJ_STATE state;
+      int matchNum;
+      bool isWalkover;
+      QString scoreText;
+      int winner;   // 0, 1 or 2
+      int winnerRank;
+    };
+
     Category cat;
 
     SimpleReportLib::SimpleReportGenerator* rawReport;  // raw pointer, only to be used during regenerateReport! (BAAAD style)
     double xFac;
     double yFac;
 
+    // prefetched data, only valid during regeneratePages()
+    vector<ElementRenderData> elements;
+    vector<vector<int>> elementsByPage;   // indices into "elements"
+    vector<vector<int>> continuationsByPage;   // elements from previous pages that continue on this page
+    unordered_map<int, MatchRenderData> matchId2Data;
+    unordered_map<int, pair<int, int>> pairId2PlayerIds;
+    unordered_map<int, pair<QString, QString>> playerId2Names;   // first name, last name
+    unordered_map<int, QString> pairId2TruncatedName;
+
+    void prefetchBracketData(int numPages);
+    void clearPrefetchedData();
+    void readMatchRow(const SqliteOverlay::TabRow& r);
+    const MatchRenderData* getMatchData(int matchId);
+    pair<int, int> getPlayerIdsForPair(int pairId);
+    const pair<QString, QString>& getPlayerNames(int playerId);
+
     void determineGridSize();
     void setupTextStyle();
     tuple<double, double> grid2MM(int gridX, int gridY) const;
+    void drawHorLine(int gridX0, int gridY0, int gridXLen) const;
+    void drawVertLine(int gridX0, int gridY0, int gridYLen) const;
+    void drawElement(const ElementRenderData& el);
+    void drawElementContinuation(const ElementRenderData& el);
+    void drawPairName(const ElementRenderData& el, int pos, int bracketY0, int ySpan, BRACKET_TEXT_ELEMENT item);
     void drawBracketTextItem(int bracketX0, int bracketY0, int ySpan, BRACKET_ORIENTATION orientation, QString txt, BRACKET_TEXT_ELEMENT item, const QString& styleNameOverride="") const;
-    QString getTruncatedPlayerName(const Player& p, const QString& postfix, double maxWidth, SimpleReportLib::TextStyle* style) const;
-    QString getTruncatedPlayerName(const PlayerPair& pp, double maxWidth, SimpleReportLib::TextStyle* style) const;
-    void drawWinnerNameOnTerminator(const QPointF& txtBottomCenter, const PlayerPair& pp, double gridWidth, SimpleReportLib::TextStyle* style) const;
+    QString getTruncatedPlayerName(int playerId, const QString& postfix, double maxWidth, SimpleReportLib::TextStyle* style);
+    QString getTruncatedPairName(int pairId);
 
-    QString determineSymbolicPlayerPairDisplayText(const BracketVisElement& el, int pos) const;
-    int determineEffectivePlayerPairId(const BracketVisElement& el, int pos) const;
-    void printHeaderAndFooterOnAllPages() const;
+    void printLabelOnCurrentPage(BRACKET_LABEL_POS labelPos) const;
   };
 
 }
@@ -177,8 +177,9 @@ void BracketVisData::addElement(int idx, const RawBracketVisElement& el)
 /**
  * @brief Inserts player names (as PlayerPair ref) in bracket matches that do not have a corresponding "real" match
  *
- * Fills as many gaps as currently possible. Has to be called repeatedly as the tournament progresses (e.g., every time
- * a bracket view / report is created).
+ * Fills as many gaps as currently possible. Has to be called repeatedly as the tournament progresses (every time
+ * a match is finished or its result changes). Writes to the database, so it must never be called from
+ * a report that is generated on a read-only snapshot.
  *
  */
 void BracketVisData::fillMissingPlayerNames() const
@@ -206,16 +207,16 @@ void BracketVisData::fillMissingPlayerNames() const
     where = where.arg(BV_PAIR1_REF, BV_PAIR2_REF);
     for (BracketVisElement el : getObjectsByWhereClause<BracketVisElement>(where.toUtf8().constData()))
     {
+      // only count successful modifications, otherwise
+      // we would loop forever on a failing write
       int iniRank = el.getInitialRank1();
-      if (iniRank <= seeding.size())
+      if ((iniRank <= seeding.size()) && el.linkToPlayerPair(seeding.at(iniRank - 1), 1))
       {
-        el.linkToPlayerPair(seeding.at(iniRank - 1), 1);
         hasModifications = true;
       }
       iniRank = el.getInitialRank2();
-      if (iniRank <= seeding.size())
+      if ((iniRank <= seeding.size()) && el.linkToPlayerPair(seeding.at(iniRank - 1), 2))
       {
-        el.linkToPlayerPair(seeding.at(iniRank - 1), 2);
         hasModifications = true;
       }
     }
@@ -236,9 +237,8 @@ void BracketVisData::fillMissingPlayerNames() const
       // is there any match pointing to this bracket element
       // as winner or loser?
       auto parentElem = getParentPlayerPairForElement(el, 1);
-      if(parentElem != nullptr)
+      if ((parentElem != nullptr) && el.linkToPlayerPair(*parentElem, 1))
       {
-        el.linkToPlayerPair(*parentElem, 1);
         hasModifications = true;
       }
 
@@ -246,9 +246,8 @@ void BracketVisData::fillMissingPlayerNames() const
       // is there any match pointing to this bracket element
       // as winner or loser?
       parentElem = getParentPlayerPairForElement(el, 2);
-      if(parentElem != nullptr)
+      if ((parentElem != nullptr) && el.linkToPlayerPair(*parentElem, 2))
       {
-        el.linkToPlayerPair(*parentElem, 2);
         hasModifications = true;
       }
     }
@@ -475,14 +474,10 @@ bool BracketVisElement::linkToPlayerPair(const PlayerPair& pp, int pos) const
   int pairId = pp.getPairId();
   if (pairId <= 0) return false;
 
-  if (pos == 1)
-  {
-    row.update(BV_PAIR1_REF, pairId);
-  } else {
-    row.update(BV_PAIR2_REF, pairId);
-  }
+  int dbErr;
+  row.update((pos == 1) ? BV_PAIR1_REF : BV_PAIR2_REF, pairId, &dbErr);
 
-  return true;
+  return (dbErr == SQLITE_DONE);
 }
 
 //----------------------------------------------------------------------------
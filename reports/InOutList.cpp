@@ -35,7 +35,7 @@ namespace QTournament
 
 
 InOutList::InOutList(TournamentDB* _db, const QString& _name, const Category& _cat, int _round)
-  :AbstractReport(_db, _name), cat(_cat), round(_round)
+  :AbstractReport(_db, _name, _cat.getId()), cat(_cat), round(_round)
 {
   if (!isValidCatRoundCombination(_cat, _round))
   {
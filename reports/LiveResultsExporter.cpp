@@ -0,0 +1,589 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include <QDir>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QJsonDocument>
+#include <QCryptographicHash>
+
+#include "LiveResultsExporter.h"
+#include "CentralSignalEmitter.h"
+#include "CatMngr.h"
+#include "MatchMngr.h"
+#include "MatchGroup.h"
+#include "RankingMngr.h"
+#include "CatRoundStatus.h"
+#include "PlayerPair.h"
+
+using namespace SqliteOverlay;
+
+namespace QTournament
+{
+  // allocate static variables
+  constexpr int LiveResultsExporter::FLUSH_DELAY__MS;
+  constexpr int LiveResultsExporter::HTML_REFRESH_INTERVAL__SECS;
+  constexpr int LiveResultsExporter::MAX_MATCH_LOG_ENTRIES;
+  constexpr int LiveResultsExporter::MAX_NEXT_MATCH_ENTRIES;
+
+  LiveResultsExporter::LiveResultsExporter(QObject* parent)
+    :QObject(parent), db(nullptr), needsFullRebuild(true), isMatchLogDirty(false), isNextMatchesDirty(false)
+  {
+    flushTimer.setSingleShot(true);
+    connect(&flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+
+    CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
+    connect(cse, SIGNAL(matchResultUpdated(int,int)), this, SLOT(onMatchResultUpdated(int,int)));
+    connect(cse, SIGNAL(roundCompleted(int,int)), this, SLOT(onRoundCompleted(int,int)));
+    connect(cse, SIGNAL(matchStatusChanged(int,int,OBJ_STATE,OBJ_STATE)), this, SLOT(onMatchStatusChanged(int,int,OBJ_STATE,OBJ_STATE)));
+    connect(cse, SIGNAL(rowChangesCommitted(RowChangeSet)), this, SLOT(onRowChangesCommitted(RowChangeSet)));
+
+    // structural changes trigger a complete rebuild
+    connect(cse, SIGNAL(categoryStatusChanged(Category,OBJ_STATE,OBJ_STATE)), this, SLOT(onStructureChanged()));
+    connect(cse, SIGNAL(endDeleteCategory()), this, SLOT(onStructureChanged()));
+    connect(cse, SIGNAL(endResetAllModels()), this, SLOT(onStructureChanged()));
+    connect(cse, SIGNAL(playerRenamed(Player)), this, SLOT(onStructureChanged()));
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::setDatabase(TournamentDB* _db)
+  {
+    if (_db == db) return;
+
+    stop();
+    db = _db;
+  }
+
+  //----------------------------------------------------------------------------
+
+  ERR LiveResultsExporter::start(const QString& _outDir)
+  {
+    if (db == nullptr) return DATABASE_ERROR;
+
+    QDir dir;
+    if (!(dir.mkpath(_outDir))) return FILE_NOT_EXISTING;
+
+    outDir = _outDir;
+    lastPageHashes.clear();
+    needsFullRebuild = true;
+
+    // write all pages immediately
+    flush();
+
+    return OK;
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::stop()
+  {
+    flushTimer.stop();
+    outDir.clear();
+
+    needsFullRebuild = true;
+    isMatchLogDirty = false;
+    isNextMatchesDirty = false;
+    dirtyMatchIds.clear();
+    dirtyStandingsCatIds.clear();
+    lastPageHashes.clear();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::onMatchResultUpdated(int matchId, int matchSeqNum)
+  {
+    if (!(isActive())) return;
+
+    dirtyMatchIds.insert(matchId);
+    isMatchLogDirty = true;
+    scheduleFlush();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::onRoundCompleted(int catId, int round)
+  {
+    if (!(isActive())) return;
+
+    dirtyStandingsCatIds.insert(catId);
+    scheduleFlush();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::onMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState)
+  {
+    if (!(isActive())) return;
+
+    // (faked) status changes also cover new match numbers,
+    // court assignments, symbolic names that have been
+    // resolved to real player names, ...
+    dirtyMatchIds.insert(matchId);
+    isNextMatchesDirty = true;
+    if ((fromState == STAT_MA_FINISHED) || (toState == STAT_MA_FINISHED)) isMatchLogDirty = true;
+    scheduleFlush();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::onRowChangesCommitted(const RowChangeSet& changes)
+  {
+    if (!(isActive())) return;
+
+    if (!(changes.isComplete))
+    {
+      onStructureChanged();
+      return;
+    }
+
+    // the match display table is maintained by triggers, so we
+    // also catch modifications that don't come along with a
+    // status change (e.g., renamed teams or categories)
+    bool hasMatchChanges = false;
+    for (const RowChange& rc : changes.changes)
+    {
+      if ((rc.type == RowChangeType::Delete) || (rc.tabName != TAB_MATCH_DISPLAY)) continue;
+
+      dirtyMatchIds.insert(rc.rowId);
+      hasMatchChanges = true;
+    }
+    if (!hasMatchChanges) return;
+
+    isNextMatchesDirty = true;
+    scheduleFlush();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::onStructureChanged()
+  {
+    if (!(isActive())) return;
+
+    needsFullRebuild = true;
+    scheduleFlush();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::scheduleFlush()
+  {
+    // collect all changes within the delay
+    // and write the pages only once
+    if (!(flushTimer.isActive())) flushTimer.start(FLUSH_DELAY__MS);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::flush()
+  {
+    if (!(isActive()) || (db == nullptr)) return;
+
+    CatMngr cm{db};
+
+    if (needsFullRebuild)
+    {
+      writeIndexPage();
+      writeMatchLogPage();
+      writeNextMatchesPage();
+      for (const Category& cat : cm.getAllCategories())
+      {
+        OBJ_STATE catState = cat.getState();
+        if ((catState == STAT_CAT_CONFIG) || (catState == STAT_CAT_FROZEN)) continue;
+
+        writeStandingsPage(cat);
+        writeMatchesPage(cat);
+      }
+    } else {
+      // determine the categories of all modified matches
+      MatchMngr mm{db};
+      unordered_set<int> dirtyMatchesCatIds;
+      for (int maId : dirtyMatchIds)
+      {
+        auto ma = mm.getMatch(maId);
+        if (ma != nullptr) dirtyMatchesCatIds.insert(ma->getCategory().getId());
+      }
+
+      for (int catId : dirtyMatchesCatIds)
+      {
+        auto cat = cm.getCategory(catId);
+        if (cat != nullptr) writeMatchesPage(*cat);
+      }
+      for (int catId : dirtyStandingsCatIds)
+      {
+        auto cat = cm.getCategory(catId);
+        if (cat != nullptr) writeStandingsPage(*cat);
+      }
+      if (isMatchLogDirty) writeMatchLogPage();
+      if (isNextMatchesDirty) writeNextMatchesPage();
+    }
+
+    needsFullRebuild = false;
+    isMatchLogDirty = false;
+    isNextMatchesDirty = false;
+    dirtyMatchIds.clear();
+    dirtyStandingsCatIds.clear();
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::writeIndexPage()
+  {
+    QJsonArray links;
+    links.append(QJsonArray{tr("Next matches"), "next.html"});
+    links.append(QJsonArray{tr("Latest results"), "matchlog.html"});
+
+    CatMngr cm{db};
+    for (const Category& cat : cm.getAllCategories())
+    {
+      OBJ_STATE catState = cat.getState();
+      if ((catState == STAT_CAT_CONFIG) || (catState == STAT_CAT_FROZEN)) continue;
+
+      links.append(QJsonArray{cat.getName() + ": " + tr("Standings"), getStandingsPageName(cat.getId()) + ".html"});
+      links.append(QJsonArray{cat.getName() + ": " + tr("Matches"), getMatchesPageName(cat.getId()) + ".html"});
+    }
+
+    writePage("index", tr("Live results"), QJsonArray(), links);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::writeMatchLogPage()
+  {
+    // the most recently finished matches, directly
+    // from the database. Walkovers have no finish time
+    // and are therefore not included in the log.
+    QString where = "%1 = %2 AND %3 IS NOT NULL ORDER BY %3 DESC LIMIT %4";
+    where = where.arg(GENERIC_STATE_FIELD_NAME).arg(static_cast<int>(STAT_MA_FINISHED));
+    where = where.arg(MA_FINISH_TIME).arg(MAX_MATCH_LOG_ENTRIES);
+
+    MatchMngr mm{db};
+    QJsonArray rows;
+    DbTab* matchTab = db->getTab(TAB_MATCH);
+    auto it = matchTab->getRowsByWhereClause(where.toUtf8().constData());
+    while (!(it.isEnd()))
+    {
+      auto ma = mm.getMatch((*it).getId());
+      if (ma != nullptr)
+      {
+        QJsonArray row = createMatchRow(*ma);
+        row.append(ma->getFinishTime().toString("HH:mm"));
+        row.prepend(ma->getCategory().getName());
+        rows.append(row);
+      }
+      ++it;
+    }
+
+    QStringList cols{tr("Category"), tr("Match"), tr("Player 1"), tr("Player 2"), tr("Result"), tr("Finished")};
+    writePage("matchlog", tr("Latest results"), QJsonArray{createTable(QString(), cols, rows)});
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::writeNextMatchesPage()
+  {
+    MatchMngr mm{db};
+
+    // running matches, sorted by match number
+    MatchList running = mm.getCurrentlyRunningMatches();
+    std::sort(running.begin(), running.end(), [](const Match& ma1, const Match& ma2) {
+      return (ma1.getMatchNumber() < ma2.getMatchNumber());
+    });
+    QJsonArray runningRows;
+    for (const Match& ma : running)
+    {
+      QJsonArray row = createMatchRow(ma, true);
+      row.prepend(ma.getCategory().getName());
+      runningRows.append(row);
+    }
+
+    // the next scheduled matches
+    QString where = "%1 IN (%2, %3, %4) AND %5 > 0 ORDER BY %5 ASC LIMIT %6";
+    where = where.arg(GENERIC_STATE_FIELD_NAME);
+    where = where.arg(static_cast<int>(STAT_MA_READY)).arg(static_cast<int>(STAT_MA_BUSY)).arg(static_cast<int>(STAT_MA_WAITING));
+    where = where.arg(MA_NUM).arg(MAX_NEXT_MATCH_ENTRIES);
+
+    QJsonArray nextRows;
+    DbTab* matchTab = db->getTab(TAB_MATCH);
+    auto it = matchTab->getRowsByWhereClause(where.toUtf8().constData());
+    while (!(it.isEnd()))
+    {
+      auto ma = mm.getMatch((*it).getId());
+      if (ma != nullptr)
+      {
+        QJsonArray row = createMatchRow(*ma);
+        row.removeLast();   // no result yet
+        row.prepend(ma->getCategory().getName());
+        nextRows.append(row);
+      }
+      ++it;
+    }
+
+    QJsonArray tables;
+    tables.append(createTable(tr("Running matches"), {tr("Category"), tr("Match"), tr("Player 1"), tr("Player 2"), tr("Result"), tr("Court")}, runningRows));
+    tables.append(createTable(tr("Next matches"), {tr("Category"), tr("Match"), tr("Player 1"), tr("Player 2")}, nextRows));
+    writePage("next", tr("Next matches"), tables);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::writeStandingsPage(const Category& cat)
+  {
+    QString title = cat.getName() + ": " + tr("Standings");
+    QJsonArray tables;
+
+    CatRoundStatus crs = cat.getRoundStatus();
+    int round = crs.getFinishedRoundsCount();
+    if (round > 0)
+    {
+      RankingMngr rm{db};
+      StandingsSnapshot snap = rm.getStandingsSnapshot(cat, round);
+      bool isRoundRobin = (snap.getGroupCount() > 1);
+      for (int idxGroup = 0; idxGroup < snap.getGroupCount(); ++idxGroup)
+      {
+        QJsonArray rows;
+        for (int idx = snap.groupStart[idxGroup]; idx < snap.groupStart[idxGroup + 1]; ++idx)
+        {
+          int rank = snap.rank[idx];
+          int ppId = snap.pairId[idx];
+
+          QJsonArray row;
+          row.append((rank == RankingEntry::NO_RANK_ASSIGNED) ? QString() : QString::number(rank));
+          row.append((ppId > 0) ? PlayerPair{db, ppId}.getDisplayName() : QString());
+          row.append(QString("%1 / %2 / %3").arg(snap.matchesWon[idx]).arg(snap.matchesDraw[idx]).arg(snap.matchesLost[idx]));
+          row.append(QString("%1 : %2").arg(snap.gamesWon[idx]).arg(snap.gamesLost[idx]));
+          row.append(QString("%1 : %2").arg(snap.pointsWon[idx]).arg(snap.pointsLost[idx]));
+          rows.append(row);
+        }
+
+        QString caption = tr("After round %1").arg(round);
+        if (isRoundRobin) caption += ", " + tr("Group %1").arg(snap.grpNum[snap.groupStart[idxGroup]]);
+        tables.append(createTable(caption, {tr("Rank"), tr("Name"), tr("Matches (W / D / L)"), tr("Games"), tr("Points")}, rows));
+      }
+    }
+
+    writePage(getStandingsPageName(cat.getId()), title, tables);
+  }
+
+  //----------------------------------------------------------------------------
+
+  void LiveResultsExporter::writeMatchesPage(const Category& cat)
+  {
+    QString title = cat.getName() + ": " + tr("Matches");
+    QJsonArray tables;
+
+    // one table per round; this is also the
+    // textual representation of a bracket
+    MatchMngr mm{db};
+    int nRounds = cat.getRoundStatus().getTotalRoundsCount();
+    for (int round = 1; round <= nRounds; ++round)
+    {
+      MatchList allMatches;
+      for (const MatchGroup& mg : mm.getMatchGroupsForCat(cat, round))
+      {
+        for (const Match& ma : mg.getMatches()) allMatches.push_back(ma);
+      }
+      if (allMatches.empty()) continue;
+
+      std::sort(allMatches.begin(), allMatches.end(), [](const Match& ma1, const Match& ma2) {
+        return (ma1.getMatchNumber() < ma2.getMatchNumber());
+      });
+
+      QJsonArray rows;
+      for (const Match& ma : allMatches)
+      {
+        rows.append(createMatchRow(ma));
+      }
+
+      tables.append(createTable(tr("Round %1").arg(round), {tr("Match"), tr("Player 1"), tr("Player 2"), tr("Result")}, rows));
+    }
+
+    writePage(getMatchesPageName(cat.getId()), title, tables);
+  }
+
+  //----------------------------------------------------------------------------
+
+  QString LiveResultsExporter::getStandingsPageName(int catId)
+  {
+    return QString("cat%1_standings").arg(catId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  QString LiveResultsExporter::getMatchesPageName(int catId)
+  {
+    return QString("cat%1_matches").arg(catId);
+  }
+
+  //----------------------------------------------------------------------------
+
+  QJsonObject LiveResultsExporter::createTable(const QString& caption, const QStringList& columns, const QJsonArray& rows)
+  {
+    QJsonObject result;
+    result["caption"] = caption;
+    result["columns"] = QJsonArray::fromStringList(columns);
+    result["rows"] = rows;
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  QJsonArray LiveResultsExporter::createMatchRow(const Match& ma, bool withCourt)
+  {
+    QJsonArray result;
+
+    int maNum = ma.getMatchNumber();
+    result.append((maNum == MATCH_NUM_NOT_ASSIGNED) ? QString() : QString::number(maNum));
+    result.append(ma.hasPlayerPair1() ? ma.getPlayerPair1().getDisplayName() : QString("?"));
+    result.append(ma.hasPlayerPair2() ? ma.getPlayerPair2().getDisplayName() : QString("?"));
+
+    QString score;
+    if (ma.getState() == STAT_MA_FINISHED)
+    {
+      auto sc = ma.getScore();
+      if (sc != nullptr) score = sc->toString();
+      if (ma.isWonByWalkover()) score += " (" + tr("walkover") + ")";
+    }
+    result.append(score);
+
+    if (withCourt)
+    {
+      auto co = ma.getCourt();
+      result.append((co != nullptr) ? QString::number(co->getNumber()) : QString());
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool LiveResultsExporter::writePage(const QString& pageName, const QString& title, const QJsonArray& tables, const QJsonArray& links)
+  {
+    QJsonObject page;
+    page["title"] = title;
+    page["tables"] = tables;
+    page["links"] = links;
+    page["isIndex"] = (pageName == "index");
+
+    // skip the page if nothing has changed since it
+    // has been written the last time; the time stamp
+    // is not part of this comparison
+    QByteArray hash = QCryptographicHash::hash(QJsonDocument(page).toJson(QJsonDocument::Compact), QCryptographicHash::Md5);
+    auto it = lastPageHashes.find(pageName);
+    if ((it != lastPageHashes.end()) && (it.value() == hash)) return true;
+
+    page["generated"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+
+    QDir dir{outDir};
+    bool isOk = writeFileAtomically(dir.absoluteFilePath(pageName + ".json"), QJsonDocument(page).toJson(QJsonDocument::Indented));
+    isOk = isOk && writeFileAtomically(dir.absoluteFilePath(pageName + ".html"), renderHtml(page));
+
+    // if something went wrong, we'll try again next time
+    if (isOk)
+    {
+      lastPageHashes[pageName] = hash;
+    } else {
+      lastPageHashes.remove(pageName);
+    }
+
+    return isOk;
+  }
+
+  //----------------------------------------------------------------------------
+
+  bool LiveResultsExporter::writeFileAtomically(const QString& fileName, const QByteArray& content) const
+  {
+    // QSaveFile writes to a temporary file in the same
+    // directory and renames it on commit()
+    QSaveFile f{fileName};
+    if (!(f.open(QIODevice::WriteOnly))) return false;
+
+    if (f.write(content) != content.size())
+    {
+      f.cancelWriting();
+      f.commit();
+      return false;
+    }
+
+    return f.commit();
+  }
+
+  //----------------------------------------------------------------------------
+
+  QByteArray LiveResultsExporter::renderHtml(const QJsonObject& page)
+  {
+    QString title = page["title"].toString().toHtmlEscaped();
+
+    QString html = "<!DOCTYPE html>\n<html>\n<head>\n<meta charset=\"utf-8\">\n";
+    html += QString("<meta http-equiv=\"refresh\" content=\"%1\">\n").arg(HTML_REFRESH_INTERVAL__SECS);
+    html += "<title>" + title + "</title>\n";
+    html += "<style>table { border-collapse: collapse; margin-bottom: 1em; } th, td { border: 1px solid #999; padding: 2px 6px; }</style>\n";
+    html += "</head>\n<body>\n";
+    html += "<h1>" + title + "</h1>\n";
+    if (!(page["isIndex"].toBool())) html += "<p><a href=\"index.html\">" + tr("Overview").toHtmlEscaped() + "</a></p>\n";
+
+    QJsonArray links = page["links"].toArray();
+    if (!(links.isEmpty()))
+    {
+      html += "<ul>\n";
+      for (const QJsonValue& v : links)
+      {
+        QJsonArray lnk = v.toArray();
+        html += QString("<li><a href=\"%1\">%2</a></li>\n").arg(lnk.at(1).toString().toHtmlEscaped()).arg(lnk.at(0).toString().toHtmlEscaped());
+      }
+      html += "</ul>\n";
+    }
+
+    for (const QJsonValue& v : page["tables"].toArray())
+    {
+      QJsonObject tab = v.toObject();
+
+      QString caption = tab["caption"].toString();
+      if (!(caption.isEmpty())) html += "<h2>" + caption.toHtmlEscaped() + "</h2>\n";
+
+      html += "<table>\n<tr>";
+      for (const QJsonValue& col : tab["columns"].toArray())
+      {
+        html += "<th>" + col.toString().toHtmlEscaped() + "</th>";
+      }
+      html += "</tr>\n";
+
+      for (const QJsonValue& row : tab["rows"].toArray())
+      {
+        html += "<tr>";
+        for (const QJsonValue& cell : row.toArray())
+        {
+          html += "<td>" + cell.toString().toHtmlEscaped() + "</td>";
+        }
+        html += "</tr>\n";
+      }
+      html += "</table>\n";
+    }
+
+    html += "<p><small>" + page["generated"].toString().toHtmlEscaped() + "</small></p>\n";
+    html += "</body>\n</html>\n";
+
+    return html.toUtf8();
+  }
+
+  //----------------------------------------------------------------------------
+
+}
@@ -0,0 +1,126 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIVERESULTSEXPORTER_H
+#define LIVERESULTSEXPORTER_H
+
+#include <unordered_set>
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QByteArray>
+#include <QTimer>
+#include <QJsonObject>
+#include <QJsonArray>
+
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+#include "TournamentErrorCodes.h"
+#include "Category.h"
+#include "Match.h"
+
+using namespace std;
+
+namespace QTournament
+{
+  /*
+   * Writes static HTML and JSON pages with live results into a
+   * directory, e.g., for hall screens or a local web server:
+   *
+   *   - index: links to all other pages
+   *   - matchlog: the most recently finished matches
+   *   - next: running matches and the next scheduled matches
+   *   - cat<ID>_standings: the standings after the last finished round
+   *   - cat<ID>_matches: all matches of a category, round by round
+   *
+   * Each page is written as <page>.html and <page>.json. The JSON file
+   * contains the raw table data that is also used for the HTML page.
+   *
+   * The pages are not rebuilt after every change. Instead, the
+   * signals of the CentralSignalEmitter mark only the affected pages
+   * as dirty and the dirty pages are written after a short delay.
+   * Pages whose contents haven't changed are not written at all.
+   * All files are written atomically (temporary file + rename), so
+   * a web server never delivers half-written pages.
+   */
+  class LiveResultsExporter : public QObject
+  {
+    Q_OBJECT
+
+  public:
+    static constexpr int FLUSH_DELAY__MS = 1000;
+    static constexpr int HTML_REFRESH_INTERVAL__SECS = 30;
+    static constexpr int MAX_MATCH_LOG_ENTRIES = 100;
+    static constexpr int MAX_NEXT_MATCH_ENTRIES = 50;
+
+    LiveResultsExporter(QObject* parent = nullptr);
+
+    // setting a new database stops the export
+    void setDatabase(TournamentDB* _db);
+
+    ERR start(const QString& _outDir);
+    void stop();
+    bool isActive() const { return (!(outDir.isEmpty())); }
+    QString getOutputDirectory() const { return outDir; }
+
+  public slots:
+    void onMatchResultUpdated(int matchId, int matchSeqNum);
+    void onRoundCompleted(int catId, int round);
+    void onMatchStatusChanged(int matchId, int matchSeqNum, OBJ_STATE fromState, OBJ_STATE toState);
+    void onRowChangesCommitted(const RowChangeSet& changes);
+    void onStructureChanged();
+    void flush();
+
+  private:
+    TournamentDB* db;
+    QString outDir;
+    QTimer flushTimer;
+
+    // dirty flags
+    bool needsFullRebuild;
+    bool isMatchLogDirty;
+    bool isNextMatchesDirty;
+    unordered_set<int> dirtyMatchIds;   // the category pages of these matches are dirty
+    unordered_set<int> dirtyStandingsCatIds;
+
+    // key: page name, value: hash of the last written content
+    QHash<QString, QByteArray> lastPageHashes;
+
+    void scheduleFlush();
+
+    // page generation
+    void writeIndexPage();
+    void writeMatchLogPage();
+    void writeNextMatchesPage();
+    void writeStandingsPage(const Category& cat);
+    void writeMatchesPage(const Category& cat);
+
+    // helpers
+    static QString getStandingsPageName(int catId);
+    static QString getMatchesPageName(int catId);
+    static QJsonObject createTable(const QString& caption, const QStringList& columns, const QJsonArray& rows);
+    static QJsonArray createMatchRow(const Match& ma, bool withCourt = false);
+    bool writePage(const QString& pageName, const QString& title, const QJsonArray& tables, const QJsonArray& links = QJsonArray());
+    bool writeFileAtomically(const QString& fileName, const QByteArray& content) const;
+    static QByteArray renderHtml(const QJsonObject& page);
+  };
+
+}
+
+#endif // LIVERESULTSEXPORTER_H
@@ -35,7 +35,7 @@ namespace QTournament
 
 
 MatchResultList_ByGroup::MatchResultList_ByGroup(TournamentDB* _db, const QString& _name, const Category& _cat, int _grpNum)
-  :AbstractReport(_db, _name), cat(_cat), grpNum(_grpNum)
+  :AbstractReport(_db, _name, _cat.getId()), cat(_cat), grpNum(_grpNum)
 {
   // make sure that the requested group is a round-robin group
   // and the group is actually existing
@@ -38,7 +38,7 @@ namespace QTournament
 
 
 MartixAndStandings::MartixAndStandings(TournamentDB* _db, const QString& _name, const Category& _cat, int _round)
-  :AbstractReport(_db, _name), cat(_cat), round(_round)
+  :AbstractReport(_db, _name, _cat.getId()), cat(_cat), round(_round)
 {
   MATCH_SYSTEM msys = cat.getMatchSystem();
   CatRoundStatus crs = cat.getRoundStatus();
@@ -85,9 +85,9 @@ upSimpleReport MartixAndStandings::regenerateReport()
 {
   // retrieve the ranking(s) for this round
   RankingMngr rm{db};
-  RankingEntryListList rll;
-  if (round > 0) rll = rm.getSortedRanking(cat, round);
-  if (round < 0) rll = rm.getSortedRanking(cat, -round - 1);   // see below for the bad hack about negative round numbers
+  StandingsSnapshot snap;
+  if (round > 0) snap = rm.getStandingsSnapshot(cat, round);
+  if (round < 0) snap = rm.getStandingsSnapshot(cat, -round - 1);   // see below for the bad hack about negative round numbers
 
   // if we are in round robins with multiple iterations,
   // create a subhead indicating the current iteration number
@@ -153,21 +153,18 @@ upSimpleReport MartixAndStandings::regenerateReport()
     // plot the standings, if available
     if (round != 0)
     {
-      if (rll.empty() || ((rll.size() == 1) && (rll.at(0).size() == 0)))
+      if (snap.size() == 0)
       {
         result->writeLine(tr("There are no standings for this round yet."));
       } else {
         // the ranking for this group and print it
-        for (const RankingEntryList& rl : rll)
+        for (int idxGroup = 0; idxGroup < snap.getGroupCount(); ++idxGroup)
         {
-          // skip empty entries (there shouldn't be any, but anyway...)
-          if (rl.empty()) continue;
-
           // skip entries belong to the wrong group
-          if ((msys == GROUPS_WITH_KO) && (rl.at(0).getGroupNumber() != grpNum)) continue;
+          if ((msys == GROUPS_WITH_KO) && (snap.grpNum[snap.groupStart[idxGroup]] != grpNum)) continue;
 
           // okay, we found the right entry
-          plotStandings elem{result.get(), rl, tableName};
+          plotStandings elem{result.get(), db, snap, idxGroup, tableName};
           elem.plot();
         }
       }
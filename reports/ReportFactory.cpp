@@ -44,6 +44,9 @@ namespace QTournament
   constexpr char ReportFactory::REP__RESULTS_AND_NEXT_MATCHES[];
   constexpr char ReportFactory::REP__BRACKET[];
   constexpr char ReportFactory::REP__MATRIX_AND_STANDINGS[];
+  constexpr int ReportFactory::MAX_CACHED_REPORTS;
+  std::map<QString, ReportFactory::CachedReport> ReportFactory::reportCache;
+  unsigned long ReportFactory::cacheAccessCounter = 0;
 
   ReportFactory::ReportFactory(TournamentDB* _db)
     : db(_db)
@@ -320,6 +323,53 @@ namespace QTournament
     return result;
   }
 
+//----------------------------------------------------------------------------
+
+  spSimpleReport ReportFactory::getCachedReport(const QString& repName, const DataVersion& dataVersion)
+  {
+    auto it = reportCache.find(repName);
+    if (it == reportCache.end()) return nullptr;
+
+    // data versions are unique across all databases, so
+    // an old entry can never be mistaken as valid
+    CachedReport& cr = it->second;
+    if (cr.dataVersion != dataVersion)
+    {
+      reportCache.erase(it);
+      return nullptr;
+    }
+
+    cr.lastAccess = ++cacheAccessCounter;
+    return cr.report;
+  }
+
+//----------------------------------------------------------------------------
+
+  void ReportFactory::storeReportInCache(const QString& repName, const DataVersion& dataVersion, const spSimpleReport& rep)
+  {
+    if (rep == nullptr) return;
+
+    reportCache[repName] = CachedReport{dataVersion, rep, ++cacheAccessCounter};
+
+    // drop the least recently used report if the cache is full
+    if (static_cast<int>(reportCache.size()) > MAX_CACHED_REPORTS)
+    {
+      auto oldest = reportCache.begin();
+      for (auto it = reportCache.begin(); it != reportCache.end(); ++it)
+      {
+        if (it->second.lastAccess < oldest->second.lastAccess) oldest = it;
+      }
+      reportCache.erase(oldest);
+    }
+  }
+
+//----------------------------------------------------------------------------
+
+  void ReportFactory::clearReportCache()
+  {
+    reportCache.clear();
+  }
+
 //----------------------------------------------------------------------------
 
   QString ReportFactory::genRepName(QString repBaseName, const Category& cat, int intParam) const
@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <vector>
+#include <map>
 
 #include <QList>
 
@@ -54,7 +55,24 @@ namespace QTournament
     static constexpr char REP__BRACKET[] = "Bracket";
     static constexpr char REP__MATRIX_AND_STANDINGS[] = "MatrixAndStandings";
 
+    // a cache for generated reports that is keyed by the report name
+    // and the report's data version; may only be used from the GUI thread
+    static constexpr int MAX_CACHED_REPORTS = 20;
+    static spSimpleReport getCachedReport(const QString& repName, const DataVersion& dataVersion);
+    static void storeReportInCache(const QString& repName, const DataVersion& dataVersion, const spSimpleReport& rep);
+    static void clearReportCache();
+
   private:
+    struct CachedReport
+    {
+      DataVersion dataVersion;
+      spSimpleReport report;
+      unsigned long lastAccess;
+    };
+
+    static std::map<QString, CachedReport> reportCache;
+    static unsigned long cacheAccessCounter;
+
     TournamentDB* db;
     QString genRepName(QString repBaseName, const Category& cat, int intParam) const;
     QString genRepName(QString repBaseName, int intParam1, int intParam2) const;
@@ -65,27 +65,30 @@ upSimpleReport ResultSheets::regenerateReport()
   }
 
   // collect the matches to be printed
+  //
+  // we fetch the matches in chunks of match number ranges. Usually,
+  // the first chunk is sufficient; we only need more chunks if
+  // the range contains unprintable matches
   MatchMngr mm{db};
   QList<Match> matchList;
   int lastMatch = mm.getMaxMatchNum();
-  int i = firstMatchNum;
-  while (matchList.size() < numMatches)
+  int chunkStart = firstMatchNum;
+  while ((matchList.size() < numMatches) && (chunkStart <= lastMatch))
   {
-    auto ma = mm.getMatchByMatchNum(i);
-    if (ma != nullptr)
+    int chunkEnd = chunkStart + numMatches - matchList.size() - 1;
+    for (const Match& ma : mm.getMatchesByMatchNumRange(chunkStart, chunkEnd))
     {
       // we can only print result sheet for unfinished
       // matches. For now, let's also acceppt FUZZY and POSTPONED matches...
-      OBJ_STATE stat = ma->getState();
+      OBJ_STATE stat = ma.getState();
       if ((stat == STAT_MA_BUSY) || (stat == STAT_MA_FUZZY) || (stat == STAT_MA_READY) ||
           (stat == STAT_MA_WAITING) || (stat == STAT_MA_POSTPONED))
       {
-        matchList.append(*ma);
+        matchList.append(ma);
       }
     }
 
-    ++i;
-    if (i > lastMatch) break;
+    chunkStart = chunkEnd + 1;
   }
 
   // return an empty report if we have no matches
@@ -17,6 +17,7 @@
  */
 
 #include <tuple>
+#include <algorithm>
 
 #include <QList>
 
@@ -36,7 +37,7 @@ namespace QTournament
 
 
 ResultsAndNextMatches::ResultsAndNextMatches(TournamentDB* _db, const QString& _name, const Category& _cat, int _round)
-  :AbstractReport(_db, _name), cat(_cat), round(_round)
+  :AbstractReport(_db, _name, _cat.getId()), cat(_cat), round(_round)
 {
   // if "round" is zero, we only print the first matches
   // if round is greater than zero, we print a normal report
@@ -129,13 +130,7 @@ void ResultsAndNextMatches::printResultPart(upSimpleReport& rep) const
   // collect all matches in this round
   MatchMngr mm{db};
   MatchGroupList mgl = mm.getMatchGroupsForCat(cat, round);
-  MatchList allMatches;
-  for (MatchGroup mg : mgl)
-  {
-    for (Match& m : mg.getMatches()) allMatches.push_back(m);
-  }
-
-  std::sort(allMatches.begin(), allMatches.end(), getSortFunction_MatchByGroupAndNumber());
+  MatchList allMatches = getMatchesSortedByGroupAndNumber(mgl);
 
   printIntermediateHeader(rep, tr("Results of Round ") + QString::number(round));
   printMatchList(rep, allMatches, PlayerPairList(), tr("Results of Round ") + QString::number(round) + tr(" (cont.)"), true, true);
@@ -161,7 +156,6 @@ void ResultsAndNextMatches::printNextMatchPart(upSimpleReport& rep) const
   // collect all matches for the next round
   MatchMngr mm{db};
   MatchGroupList mgl = mm.getMatchGroupsForCat(cat, round+1);
-  MatchList allMatches;
   bool isAllScheduled = true;
   for (MatchGroup mg : mgl)
   {
@@ -171,8 +165,9 @@ void ResultsAndNextMatches::printNextMatchPart(upSimpleReport& rep) const
       isAllScheduled = false;
       break;
     }
-    for (Match& m : mg.getMatches()) allMatches.push_back(m);
   }
+  MatchList allMatches;
+  if (isAllScheduled) allMatches = getMatchesSortedByGroupAndNumber(mgl);
 
   // if there are unscheduled match groups, print nothing at all
   if ((!isAllScheduled) || (allMatches.empty()))
@@ -194,9 +189,6 @@ void ResultsAndNextMatches::printNextMatchPart(upSimpleReport& rep) const
     }
   }
 
-  // sort matches by group and number
-  std::sort(allMatches.begin(), allMatches.end(), getSortFunction_MatchByGroupAndNumber());
-
   // determine a list of all players having a bye
   PlayerPairList byeList;
   PlayerPairList playingList;
@@ -222,23 +214,43 @@ void ResultsAndNextMatches::printNextMatchPart(upSimpleReport& rep) const
 
 //----------------------------------------------------------------------------
 
-std::function<bool (Match& ma1, Match& ma2)> ResultsAndNextMatches::getSortFunction_MatchByGroupAndNumber() const
+MatchList ResultsAndNextMatches::getMatchesSortedByGroupAndNumber(const MatchGroupList& mgl) const
 {
-  return [](Match& ma1, Match& ma2){
-    int mg1Num = ma1.getMatchGroup().getGroupNumber();
-    int mg2Num = ma2.getMatchGroup().getGroupNumber();
-    if (mg1Num < mg2Num)
-    {
-      return true;
-    }
-    if (mg1Num > mg2Num)
+  // we determine the sort keys only once per match instead of
+  // querying the match group and the match number in each
+  // comparison of the sort algorithm
+  struct SortItem
+  {
+    int grpNum;
+    int maNum;
+    Match ma;
+  };
+
+  vector<SortItem> items;
+  for (const MatchGroup& mg : mgl)
+  {
+    int grpNum = mg.getGroupNumber();
+    for (const Match& ma : mg.getMatches())
     {
-      return false;
+      items.push_back(SortItem{grpNum, ma.getMatchNumber(), ma});
     }
+  }
+
+  std::sort(items.begin(), items.end(), [](const SortItem& i1, const SortItem& i2) {
+    if (i1.grpNum != i2.grpNum) return (i1.grpNum < i2.grpNum);
 
     // group numbers are equal. so we sort by match numbers
-    return (ma1.getMatchNumber() < ma2.getMatchNumber());
-  };
+    return (i1.maNum < i2.maNum);
+  });
+
+  MatchList result;
+  result.reserve(items.size());
+  for (const SortItem& si : items)
+  {
+    result.push_back(si.ma);
+  }
+
+  return result;
 }
 
 //----------------------------------------------------------------------------
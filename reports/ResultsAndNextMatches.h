@@ -19,13 +19,12 @@
 #ifndef RESULTSANDNEXTMATCHES_H
 #define RESULTSANDNEXTMATCHES_H
 
-#include <functional>
-
 #include <QObject>
 
 #include "reports/AbstractReport.h"
 #include "TournamentDB.h"
 #include "TournamentDataDefs.h"
+#include "MatchGroup.h"
 
 using namespace SqliteOverlay;
 
@@ -48,7 +47,7 @@ namespace QTournament
     void printResultPart(upSimpleReport& rep) const;
     void printNextMatchPart(upSimpleReport& rep) const;
 
-    std::function<bool (Match& ma1, Match& ma2)> getSortFunction_MatchByGroupAndNumber() const;
+    MatchList getMatchesSortedByGroupAndNumber(const MatchGroupList& mgl) const;
   };
 
 }
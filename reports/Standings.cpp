@@ -37,7 +37,7 @@ namespace QTournament
 
 
 Standings::Standings(TournamentDB* _db, const QString& _name, const Category& _cat, int _round)
-  :AbstractReport(_db, _name), cat(_cat), round(_round)
+  :AbstractReport(_db, _name, _cat.getId()), cat(_cat), round(_round)
 {
   // make sure that the requested round is already finished
   CatRoundStatus crs = cat.getRoundStatus();
@@ -52,13 +52,13 @@ upSimpleReport Standings::regenerateReport()
 {
   // retrieve the ranking(s) for this round
   RankingMngr rm{db};
-  RankingEntryListList rll = rm.getSortedRanking(cat, round);
+  StandingsSnapshot snap = rm.getStandingsSnapshot(cat, round);
 
   QString repName = cat.getName() + " -- " + tr("Standings after round ") + QString::number(round);
   upSimpleReport result = createEmptyReport_Portrait();
 
   // return an empty report if we have no standings yet
-  if (rll.empty() || ((rll.size() == 1) && (rll.at(0).size() == 0)))
+  if (snap.size() == 0)
   {
     setHeaderAndHeadline(result.get(), repName);
     result->writeLine(tr("There are no standings for this round yet."));
@@ -66,7 +66,7 @@ upSimpleReport Standings::regenerateReport()
   }
 
   // an internal marker if we are in round-robin matches or not
-  bool isRoundRobin = (rll.size() > 1);
+  bool isRoundRobin = (snap.getGroupCount() > 1);
 
   // if we are in a "special round" like semi-finals, etc.
   // create a suitable sub-headline
@@ -86,22 +86,22 @@ upSimpleReport Standings::regenerateReport()
   setHeaderAndHeadline(result.get(), repName, subHeader);
 
   // dump all rankings to the report
-  for (RankingEntryList rl : rll)
+  for (int idxGroup = 0; idxGroup < snap.getGroupCount(); ++idxGroup)
   {
     QString tableName = tr("Standings in category ") + cat.getName() + tr(" after round ") + QString::number(round);
     if (isRoundRobin)
     {
       // determine the group number
       // and print an intermediate header
-      RankingEntry re = rl.at(0);
-      QString hdr = tr("Group ") + QString::number(re.getGroupNumber());
+      int grpNum = snap.grpNum[snap.groupStart[idxGroup]];
+      QString hdr = tr("Group ") + QString::number(grpNum);
       printIntermediateHeader(result, hdr);
 
-      tableName += ", " + tr("Group ") + QString::number(re.getGroupNumber());
+      tableName += ", " + tr("Group ") + QString::number(grpNum);
     }
 
     // plot the actual standings table
-    plotStandings table{result.get(), rl, tableName};
+    plotStandings table{result.get(), db, snap, idxGroup, tableName};
     table.plot();
 
     result->skip(3.0);
@@ -24,6 +24,9 @@
 #include "TournamentDB.h"
 #include "reports/AbstractReport.h"
 #include "PureRoundRobinCategory.h"
+#include "Score.h"
+
+using namespace SqliteOverlay;
 
 MatchMatrix::MatchMatrix(SimpleReportGenerator* _rep, const QString& tabName, const Category& _cat, int _round, int _grpNum)
   :AbstractReportElement(_rep), tableName(tabName), cat(_cat), round(_round), grpNum(_grpNum), showMatchNumbersOnly(round <= 0)
@@ -125,6 +128,11 @@ QRectF MatchMatrix::plot(const QPointF& topLeft)
     }
   }
 
+  // fetch all relevant matches at once so that
+  // we don't need any further database access while
+  // plotting the cells
+  buildMatchMap(minRoundNum, maxRoundNum);
+
   // get the textstyle for the table contents
   TextStyle* baseStyle = rep->getTextStyle();
   assert(baseStyle != nullptr);
@@ -159,7 +167,7 @@ QRectF MatchMatrix::plot(const QPointF& topLeft)
       // get the cell's content
       QString txt;
       CELL_CONTENT_TYPE cct;
-      tie(cct, txt) = getCellContent(ppList, r, c, minRoundNum, maxRoundNum);
+      tie(cct, txt) = getCellContent(ppList, r, c);
 
       // special case: content == tableName
       if (cct == CELL_CONTENT_TYPE::TITLE)
@@ -243,68 +251,125 @@ QRectF MatchMatrix::plot(const QPointF& topLeft)
 
 //----------------------------------------------------------------------------
 
-upMatch MatchMatrix::getMatchForCell(const PlayerPairList& ppList, int row, int col, int minRound, int maxRound) const
+qint64 MatchMatrix::getPairKey(int pairId1, int pairId2)
 {
-  if ((row < 1) || (col < 1) || (row > ppList.size()) || (col > ppList.size()))
+  if (pairId1 > pairId2)
   {
-    return nullptr;
+    int tmp = pairId1;
+    pairId1 = pairId2;
+    pairId2 = tmp;
   }
 
-  PlayerPair ppRow = ppList.at(row - 1);
-  PlayerPair ppCol = ppList.at(col - 1);
+  return (static_cast<qint64>(pairId1) << 32) | static_cast<qint64>(pairId2);
+}
+
+//----------------------------------------------------------------------------
+
+void MatchMatrix::buildMatchMap(int minRound, int maxRound)
+{
+  pairs2Match.clear();
 
-  // create a direct, low-level database query for the
-  // applicable matches
   TournamentDB* db = cat.getDatabaseHandle();
-  MatchMngr mm{db};
-  QString where = "(%1 = %2 AND %3 = %4) OR (%1 = %4 AND %3 = %2)";
-  where = where.arg(MA_PAIR1_REF).arg(ppRow.getPairId());
-  where = where.arg(MA_PAIR2_REF).arg(ppCol.getPairId());
+
+  // the round numbers of all match groups in the
+  // requested range; this map is also used for
+  // filtering the matches below
+  unordered_map<int, int> grpId2Round;
+  WhereClause wc;
+  wc.addIntCol(MG_CAT_REF, cat.getId());
+  wc.addIntCol(MG_ROUND, ">=", minRound);
+  wc.addIntCol(MG_ROUND, "<=", maxRound);
+  DbTab* grpTab = db->getTab(TAB_MATCH_GROUP);
+  DbTab::CachingRowIterator it = grpTab->getRowsByWhereClause(wc);
+  while (!(it.isEnd()))
+  {
+    TabRow r = *it;
+    grpId2Round[r.getId()] = r.getInt(MG_ROUND);
+    ++it;
+  }
+  if (grpId2Round.empty()) return;
+
+  // a single query for all matches of these groups
+  QString where = "%1 IN (SELECT id FROM %2 WHERE %3 = %4 AND %5 >= %6 AND %5 <= %7) AND %8 IS NOT NULL AND %9 IS NOT NULL ORDER BY id";
+  where = where.arg(MA_GRP_REF).arg(TAB_MATCH_GROUP);
+  where = where.arg(MG_CAT_REF).arg(cat.getId());
+  where = where.arg(MG_ROUND).arg(minRound).arg(maxRound);
+  where = where.arg(MA_PAIR1_REF).arg(MA_PAIR2_REF);
   DbTab* matchTab = db->getTab(TAB_MATCH);
-  DbTab::CachingRowIterator it = matchTab->getRowsByWhereClause(where.toUtf8().constData());
+  it = matchTab->getRowsByWhereClause(where.toUtf8().constData());
   while (!(it.isEnd()))
   {
-    auto ma = mm.getMatch((*it).getId());
-    assert(ma != nullptr);
+    TabRow r = *it;
+    ++it;
+
+    auto grpIt = grpId2Round.find(r.getInt(MA_GRP_REF));
+    if (grpIt == grpId2Round.end()) continue;   // shouldn't happen
+
+    MatrixMatchInfo mi;
+    mi.pair1Id = r.getInt(MA_PAIR1_REF);
+    mi.round = grpIt->second;
+    mi.state = static_cast<OBJ_STATE>(r.getInt(GENERIC_STATE_FIELD_NAME));
+    auto maNum = r.getInt2(MA_NUM);
+    mi.matchNum = maNum->isNull() ? MATCH_NUM_NOT_ASSIGNED : maNum->get();
 
-    // check for right category and the right round number
-    int r = ma->getMatchGroup().getRound();
-    if ((ma->getCategory() == cat) && (r >= minRound) && (r <= maxRound))
+    // a finished match without a finish time
+    // has been won by a walkover
+    mi.isWalkover = ((mi.state == STAT_MA_FINISHED) && (r.getInt2(MA_FINISH_TIME)->isNull()));
+
+    // decode the score; like in Match::getScore() we assume
+    // that every score in the database is valid
+    auto scoreEntry = r.getString2(MA_RESULT);
+    if (!(scoreEntry->isNull()))
     {
-      return ma;
+      auto score = MatchScore::fromStringWithoutValidation(QString::fromUtf8(scoreEntry->get().data()));
+      if (score != nullptr)
+      {
+        for (int g=0; g < score->getNumGames(); ++g)
+        {
+          auto gameScore = score->getGame(g);
+          assert(gameScore != nullptr);
+          mi.gameScores.push_back(gameScore->getScore());
+        }
+      }
     }
 
-    ++it;
+    // if there are multiple matches between the same
+    // pairs, the first one wins (same as in the old
+    // cell-by-cell lookup)
+    pairs2Match.emplace(getPairKey(mi.pair1Id, r.getInt(MA_PAIR2_REF)), std::move(mi));
   }
-
-  return nullptr;
 }
 
 //----------------------------------------------------------------------------
 
-QStringList MatchMatrix::getSortedMatchScoreStrings(const Match& ma, const PlayerPair& ppRow, const PlayerPair& ppCol) const
+const MatchMatrix::MatrixMatchInfo* MatchMatrix::getMatchForCell(const PlayerPairList& ppList, int row, int col) const
 {
-  PlayerPair pp1 = ma.getPlayerPair1();
-  PlayerPair pp2 = ma.getPlayerPair2();
-  if (!(  ((pp1 == ppRow) && (pp2 == ppCol)) || ((pp2 == ppRow) && (pp1 == ppCol))  ) )
+  if ((row < 1) || (col < 1) || (row > ppList.size()) || (col > ppList.size()))
   {
-    return QStringList();
+    return nullptr;
   }
 
-  bool mustSwapScore = (ppRow == pp2);
+  int ppRowId = ppList.at(row - 1).getPairId();
+  int ppColId = ppList.at(col - 1).getPairId();
+
+  auto it = pairs2Match.find(getPairKey(ppRowId, ppColId));
+  if (it == pairs2Match.end()) return nullptr;
+
+  return &(it->second);
+}
+
+//----------------------------------------------------------------------------
 
-  auto score = ma.getScore();
-  if (score == nullptr) return QStringList();
+QStringList MatchMatrix::getSortedMatchScoreStrings(const MatrixMatchInfo& mi, const PlayerPair& ppRow) const
+{
+  bool mustSwapScore = (ppRow.getPairId() != mi.pair1Id);
 
   QStringList result;
-  for (int g=0; g < score->getNumGames(); ++g)
+  for (const tuple<int, int>& gameScore : mi.gameScores)
   {
-    auto gameScore = score->getGame(g);
-    assert(gameScore != nullptr);
-
     int sc1;
     int sc2;
-    tie(sc1, sc2) = gameScore->getScore();
+    tie(sc1, sc2) = gameScore;
 
     if (mustSwapScore)
     {
@@ -323,7 +388,7 @@ QStringList MatchMatrix::getSortedMatchScoreStrings(const Match& ma, const Playe
 
 //----------------------------------------------------------------------------
 
-tuple<MatchMatrix::CELL_CONTENT_TYPE, QString> MatchMatrix::getCellContent(const PlayerPairList& ppList, int row, int col, int minRound, int maxRound) const
+tuple<MatchMatrix::CELL_CONTENT_TYPE, QString> MatchMatrix::getCellContent(const PlayerPairList& ppList, int row, int col) const
 {
   // the table name goes in the top-left corner
   if ((row == 0) && (col == 0))
@@ -342,22 +407,22 @@ tuple<MatchMatrix::CELL_CONTENT_TYPE, QString> MatchMatrix::getCellContent(const
   // or the match number, if applicable
   if ((row > 0) && (col > row))
   {
-    auto ma = getMatchForCell(ppList, row, col, minRound, maxRound);
+    const MatrixMatchInfo* ma = getMatchForCell(ppList, row, col);
 
     if (ma == nullptr)
     {
       return make_tuple(CELL_CONTENT_TYPE::EMPTY, QString());
     }
 
-    int maRound = ma->getMatchGroup().getRound();
-    OBJ_STATE maStat = ma->getState();
+    int maRound = ma->round;
+    OBJ_STATE maStat = ma->state;
 
     // if the match is later than "round", print only
     // the match number. The same applies if the match
     // is not yet finished
     if ((maRound > round) || (maStat != STAT_MA_FINISHED) || (showMatchNumbersOnly))
     {
-      int maNum = ma->getMatchNumber();
+      int maNum = ma->matchNum;
       if (maNum < 0)
       {
         // no score, no match number. nothing more to do.
@@ -374,8 +439,7 @@ tuple<MatchMatrix::CELL_CONTENT_TYPE, QString> MatchMatrix::getCellContent(const
       // the match is in the correct round range and is finished,
       // so we print the score
       PlayerPair ppRow = ppList.at(row - 1);
-      PlayerPair ppCol = ppList.at(col - 1);
-      QStringList scList = getSortedMatchScoreStrings(*ma, ppRow, ppCol);
+      QStringList scList = getSortedMatchScoreStrings(*ma, ppRow);
 
       QString txt;
       for (const QString& l : scList)
@@ -385,7 +449,7 @@ tuple<MatchMatrix::CELL_CONTENT_TYPE, QString> MatchMatrix::getCellContent(const
       txt.chop(1);
 
       // add a line "walkover", if necessary
-      if (ma->isWonByWalkover())
+      if (ma->isWalkover)
       {
         txt += "\n" + tr("walkover");
       }
@@ -21,6 +21,8 @@
 
 #include <memory>
 #include <tuple>
+#include <unordered_map>
+#include <vector>
 
 #include <QObject>
 
@@ -66,6 +68,19 @@ public:
 
   static constexpr double GAP_TEXT_TO_GRID__MM = 1.0;
 
+  // everything we need to know about a match for
+  // filling a cell; the scores are stored from the
+  // perspective of pair 1
+  struct MatrixMatchInfo
+  {
+    int pair1Id;
+    int round;
+    OBJ_STATE state;
+    int matchNum;
+    vector<tuple<int, int>> gameScores;
+    bool isWalkover;
+  };
+
   MatchMatrix(SimpleReportGenerator* _rep, const QString& tabName, const Category& _cat, int _round, int _grpNum = -1);
   virtual QRectF plot(const QPointF& topLeft = QPointF(-1, -1));
   virtual ~MatchMatrix(){}
@@ -77,9 +92,14 @@ protected:
   int grpNum;
   bool showMatchNumbersOnly;
 
-  upMatch getMatchForCell(const PlayerPairList& ppList, int row, int col, int minRound, int maxRound) const;
-  QStringList getSortedMatchScoreStrings(const Match& ma, const PlayerPair& ppRow, const PlayerPair& ppCol) const;
-  tuple<CELL_CONTENT_TYPE, QString> getCellContent(const PlayerPairList& ppList, int row, int col, int minRound, int maxRound) const;
+  // key: the two pair IDs of a match, smaller ID first
+  unordered_map<qint64, MatrixMatchInfo> pairs2Match;
+
+  static qint64 getPairKey(int pairId1, int pairId2);
+  void buildMatchMap(int minRound, int maxRound);
+  const MatrixMatchInfo* getMatchForCell(const PlayerPairList& ppList, int row, int col) const;
+  QStringList getSortedMatchScoreStrings(const MatrixMatchInfo& mi, const PlayerPair& ppRow) const;
+  tuple<CELL_CONTENT_TYPE, QString> getCellContent(const PlayerPairList& ppList, int row, int col) const;
   QString getTruncatedPlayerNames(const PlayerPair& pp, const TextStyle* style, double maxWidth) const;
 };
 
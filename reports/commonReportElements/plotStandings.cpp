@@ -21,8 +21,8 @@
 #include "plotStandings.h"
 
 
-plotStandings::plotStandings(SimpleReportGenerator* _rep, const RankingEntryList& _rel, const QString& tabName)
-  :AbstractReportElement(_rep), rel(_rel), tableName(tabName)
+plotStandings::plotStandings(SimpleReportGenerator* _rep, TournamentDB* _db, const StandingsSnapshot& _snap, int _idxGroup, const QString& tabName)
+  :AbstractReportElement(_rep), db(_db), snap(_snap), idxGroup(_idxGroup), tableName(tabName)
 {
 
 }
@@ -53,39 +53,41 @@ QRectF plotStandings::plot(const QPointF& topLeft)
   tw.setHeader(11, tr("Points"));
 
   bool hasAtLeastOneEntry = false;
-  for (RankingEntry re : rel)
+  int idxFirst = snap.groupStart.at(idxGroup);
+  int idxLast = snap.groupStart.at(idxGroup + 1);
+  for (int idx = idxFirst; idx < idxLast; ++idx)
   {
     QStringList rowContent;
     rowContent << "";   // first column is unused
 
     // skip entries without a valid rank
-    int curRank = re.getRank();
+    int curRank = snap.rank[idx];
     if (curRank == RankingEntry::NO_RANK_ASSIGNED) continue;
     hasAtLeastOneEntry = true;
 
     rowContent << QString::number(curRank);
 
-    auto pp = re.getPlayerPair();
-    rowContent << ((pp != nullptr) ? (*pp).getDisplayName(53) : "??");
-    rowContent << ((pp != nullptr) ? (*pp).getDisplayName_Team(53) : "??");
-
-    if (pp != nullptr)
+    int ppId = snap.pairId[idx];
+    if (ppId > 0)
     {
+      PlayerPair pp{db, ppId};
+      rowContent << pp.getDisplayName(53);
+      rowContent << pp.getDisplayName_Team(53);
+
       // TODO: this doesn't work if draw matches are allowed!
-      auto matchStats = re.getMatchStats();
-      rowContent << QString::number(get<0>(matchStats));
+      rowContent << QString::number(snap.matchesWon[idx]);
       rowContent << ":";
-      rowContent << QString::number(get<2>(matchStats));
+      rowContent << QString::number(snap.matchesLost[idx]);
 
-      auto gameStats = re.getGameStats();
-      rowContent << QString::number(get<0>(gameStats));
+      rowContent << QString::number(snap.gamesWon[idx]);
       rowContent << ":";
-      rowContent << QString::number(get<1>(gameStats));
+      rowContent << QString::number(snap.gamesLost[idx]);
 
-      auto pointStats = re.getPointStats();
-      rowContent << QString::number(get<0>(pointStats));
+      rowContent << QString::number(snap.pointsWon[idx]);
       rowContent << ":";
-      rowContent << QString::number(get<1>(pointStats));
+      rowContent << QString::number(snap.pointsLost[idx]);
+    } else {
+      rowContent << "??" << "??";
     }
 
     tw.appendRow(rowContent);
@@ -32,12 +32,14 @@ class plotStandings : public QObject, AbstractReportElement
   Q_OBJECT
 
 public:
-  plotStandings(SimpleReportGenerator* _rep, const RankingEntryList& _rel, const QString& tabName);
+  plotStandings(SimpleReportGenerator* _rep, TournamentDB* _db, const StandingsSnapshot& _snap, int _idxGroup, const QString& tabName);
   virtual QRectF plot(const QPointF& topLeft = QPointF(-1, -1));
   virtual ~plotStandings() {}
 
 protected:
-  RankingEntryList rel;
+  TournamentDB* db;
+  const StandingsSnapshot& snap;
+  int idxGroup;
   QString tableName;
 };
 
@@ -0,0 +1,128 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QString>
+
+#include <gtest/gtest.h>
+
+#include "ChangeJournal.h"
+
+#include "BasicTestClass.h"
+
+using namespace QTournament;
+
+namespace
+{
+  sqlite3* openTestDb()
+  {
+    sqlite3* dbPtr = nullptr;
+    EXPECT_EQ(SQLITE_OK, sqlite3_open(":memory:", &dbPtr));
+    EXPECT_EQ(SQLITE_OK, sqlite3_exec(dbPtr, "CREATE TABLE t (id INTEGER PRIMARY KEY, v INTEGER)", nullptr, nullptr, nullptr));
+    return dbPtr;
+  }
+
+  //----------------------------------------------------------------------------
+
+  int getRowCount(sqlite3* dbPtr, const char* whereClause = "1")
+  {
+    string sql = "SELECT COUNT(*) FROM t WHERE ";
+    sql += whereClause;
+
+    sqlite3_stmt* stmt = nullptr;
+    EXPECT_EQ(SQLITE_OK, sqlite3_prepare_v2(dbPtr, sql.c_str(), -1, &stmt, nullptr));
+    EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+    int result = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+
+    return result;
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_F(BasicTestFixture, ChangeJournal_TornRecord)
+{
+  QString fName = QString::fromUtf8(genTestFilePath("ChangeJournalTest.journal").c_str());
+  QFile::remove(fName);
+
+  // two records
+  sqlite3* srcPtr = openTestDb();
+  qint64 validSize;
+  {
+    ChangeJournal cj{srcPtr, fName};
+    ASSERT_TRUE(cj.isValid());
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(srcPtr, "INSERT INTO t (id, v) VALUES (1, 10), (2, 20)", nullptr, nullptr, nullptr));
+    ASSERT_EQ(OK, cj.flush());
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(srcPtr, "UPDATE t SET v = 11 WHERE id = 1", nullptr, nullptr, nullptr));
+    ASSERT_EQ(OK, cj.flush());
+    ASSERT_EQ(2, cj.getRecordCount());
+    validSize = cj.getFileSize();
+  }
+  sqlite3_close(srcPtr);
+
+  // simulate a power loss while writing a third record: the
+  // header announces 100 bytes but only a few have been written
+  {
+    QFile f{fName};
+    ASSERT_TRUE(f.open(QIODevice::WriteOnly | QIODevice::Append));
+    const char tornRecord[] = {100, 0, 0, 0, 1, 2, 3, 4, 5, 6, 7};
+    ASSERT_EQ(static_cast<qint64>(sizeof(tornRecord)), f.write(tornRecord, sizeof(tornRecord)));
+  }
+  ASSERT_EQ(validSize + 11, QFile{fName}.size());
+
+  // the replay applies the two valid records and ignores the torn one
+  sqlite3* dstPtr = openTestDb();
+  int nRecords = -1;
+  ASSERT_EQ(OK, ChangeJournal::replay(dstPtr, fName, &nRecords));
+  ASSERT_EQ(2, nRecords);
+  ASSERT_EQ(2, getRowCount(dstPtr));
+  ASSERT_EQ(1, getRowCount(dstPtr, "id = 1 AND v = 11"));
+  sqlite3_close(dstPtr);
+
+  // re-opening the journal truncates the torn record
+  sqlite3* reopenPtr = openTestDb();
+  {
+    ChangeJournal cj{reopenPtr, fName};
+    ASSERT_TRUE(cj.isValid());
+    ASSERT_EQ(2, cj.getRecordCount());
+    ASSERT_EQ(validSize, cj.getFileSize());
+  }
+  ASSERT_EQ(validSize, QFile{fName}.size());
+  sqlite3_close(reopenPtr);
+
+  // a journal that doesn't match the base (here: an update of
+  // a missing row) fails and leaves the database untouched
+  sqlite3* wrongBasePtr = openTestDb();
+  ASSERT_EQ(SQLITE_OK, sqlite3_exec(wrongBasePtr, "INSERT INTO t (id, v) VALUES (2, 20)", nullptr, nullptr, nullptr));
+  {
+    ChangeJournal cj{wrongBasePtr, fName};
+    cj.clear();
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(wrongBasePtr, "UPDATE t SET v = 21 WHERE id = 2", nullptr, nullptr, nullptr));
+    ASSERT_EQ(OK, cj.flush());
+  }
+  sqlite3_close(wrongBasePtr);
+  dstPtr = openTestDb();
+  ASSERT_EQ(SQLITE_OK, sqlite3_exec(dstPtr, "INSERT INTO t (id, v) VALUES (1, 10)", nullptr, nullptr, nullptr));
+  ASSERT_EQ(DATABASE_ERROR, ChangeJournal::replay(dstPtr, fName, &nRecords));
+  ASSERT_EQ(1, getRowCount(dstPtr));
+  ASSERT_EQ(1, getRowCount(dstPtr, "id = 1 AND v = 10"));
+  sqlite3_close(dstPtr);
+
+  QFile::remove(fName);
+}
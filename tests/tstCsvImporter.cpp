@@ -142,3 +142,98 @@ TEST_F(BasicTestFixture, CSVAnalysis)
                  }
                );
 }
+
+//----------------------------------------------------------------------------
+
+TEST_F(BasicTestFixture, CSVImportContext)
+{
+  unique_ptr<QTournament::TournamentDB> _db;
+  getScenario03(_db);
+  TournamentDB* db = _db.get();
+
+  CSVImportContext ctx{db};
+
+  // existing and unknown players
+  auto pi = ctx.findPlayer("a", "m1");
+  ASSERT_TRUE(pi != nullptr);
+  ASSERT_EQ(M, pi->sex);
+  ASSERT_EQ("T1", pi->teamName);
+  ASSERT_TRUE(isInVector<QString>(pi->openCatNames, "MS"));
+  ASSERT_TRUE(ctx.findPlayer("m1", "a") == nullptr);
+  ASSERT_TRUE(ctx.findPlayer("f", "l") == nullptr);
+
+  // existing and unknown categories
+  auto ci = ctx.findCategory("LD");
+  ASSERT_TRUE(ci != nullptr);
+  ASSERT_TRUE(ci->canAddPlayers);
+  ASSERT_EQ(WRONG_SEX, ci->addState[M]);
+  ASSERT_EQ(CAN_JOIN, ci->addState[F]);
+  ci = ctx.findCategory("RR");
+  ASSERT_TRUE(ci != nullptr);
+  ASSERT_FALSE(ci->canAddPlayers);
+  ASSERT_TRUE(ctx.findCategory("xxx") == nullptr);
+
+  // local duplicates refer to all earlier rows with the same name
+  auto records = convertCSVfromPlainText(db, splitCSV("l,f,m,t\nx,y,f,t\nl,f,m,t\nl,f,m,t"));
+  auto errList = analyseCSV(ctx, records);
+  ASSERT_EQ(6, errList.size());
+  vector<pair<int, QString>> expected{{2, "1"}, {2, "1"}, {3, "1"}, {3, "1"}, {3, "3"}, {3, "3"}};
+  for (size_t idx = 0; idx < errList.size(); ++idx)
+  {
+    ASSERT_EQ(CSVErrCode::NameRedundant, errList[idx].err);
+    ASSERT_EQ(expected[idx].first, errList[idx].row);
+    ASSERT_EQ(expected[idx].second, errList[idx].para);
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_F(BasicTestFixture, CSVValidator)
+{
+  unique_ptr<QTournament::TournamentDB> _db;
+  getScenario03(_db);
+  TournamentDB* db = _db.get();
+
+  auto records = convertCSVfromPlainText(db, splitCSV("l,f,m,t\nx,y,f,t\nl,f,m,t\nl,f,m,t,LD"));
+  CSVValidator v{db};
+  v.reset(records);
+  ASSERT_EQ(6, v.getFatalCount());
+  ASSERT_EQ(1, v.getWarningCount());
+
+  // compare an incremental update with a full analysis
+  auto checkAgainstFullAnalysis = [&]() {
+    auto expected = analyseCSV(db, records);
+    auto actual = v.getAllErrors();
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t idx = 0; idx < expected.size(); ++idx)
+    {
+      ASSERT_EQ(expected[idx].row, actual[idx].row);
+      ASSERT_EQ(expected[idx].column, actual[idx].column);
+      ASSERT_EQ(expected[idx].err, actual[idx].err);
+      ASSERT_EQ(expected[idx].para, actual[idx].para);
+    }
+  };
+
+  // renaming the first row affects all later rows with
+  // the old name and with the new name
+  records[0].updateFirstName("y");
+  records[0].updateLastName("x");
+  vector<int> affected = v.updateRow(records, 0);
+  ASSERT_EQ((vector<int>{0, 1, 2, 3}), affected);
+  checkAgainstFullAnalysis();
+  ASSERT_EQ(4, v.getFatalCount());
+
+  // a category change only affects the row itself
+  records[3].updateCategories({"MS"});
+  affected = v.updateRow(records, 3);
+  ASSERT_EQ((vector<int>{3}), affected);
+  checkAgainstFullAnalysis();
+  ASSERT_EQ(0, v.getWarningCount());
+
+  // resolving the last conflict
+  records[3].updateFirstName("g");
+  affected = v.updateRow(records, 3);
+  ASSERT_EQ((vector<int>{3}), affected);
+  checkAgainstFullAnalysis();
+  ASSERT_EQ(2, v.getFatalCount());
+}
@@ -0,0 +1,118 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QString>
+
+#include <gtest/gtest.h>
+
+#include <SqliteOverlay/KeyValueTab.h>
+
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+
+#include "BasicTestClass.h"
+
+using namespace QTournament;
+
+namespace
+{
+  int countSchemaObjects(TournamentDB* db, const char* schema, const char* type, const char* name)
+  {
+    QString sql = "SELECT COUNT(*) FROM %1.sqlite_master WHERE type = '%2' AND name = '%3'";
+    sql = sql.arg(schema).arg(type).arg(name);
+
+    int result = -1;
+    int dbErr;
+    EXPECT_TRUE(db->execScalarQueryInt(sql.toUtf8().constData(), &result, &dbErr));
+    return result;
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_F(BasicTestFixture, DatabaseConversion_2_3)
+{
+  QString fName = QString::fromUtf8(genTestFilePath("ConversionTest.tdb").c_str());
+  QFile::remove(fName);
+
+  const char* compositeIndices[] = {IDX_MATCH_STATE_NUM, IDX_RANKING_CAT_ROUND_GRP, IDX_MATCH_GROUP_CAT_ROUND_GRP};
+
+  // turn a new file into a file of version 2.3
+  // which didn't have the composite indices yet
+  {
+    TournamentSettings cfg;
+    cfg.organizingClub = "SV Whatever";
+    cfg.tournamentName = "World Championship";
+    cfg.useTeams = true;
+    cfg.refereeMode = REFEREE_MODE::NONE;
+    auto db = TournamentDB::createNew(fName, cfg);
+    ASSERT_TRUE(db != nullptr);
+
+    for (const char* idxName : compositeIndices)
+    {
+      QString sql = "DROP INDEX %1";
+      int dbErr;
+      ASSERT_TRUE(db->execNonQuery(sql.arg(idxName).toUtf8().constData(), &dbErr));
+    }
+
+    auto cfgTab = SqliteOverlay::KeyValueTab::getTab(db.get(), TAB_CFG);
+    cfgTab->set(CFG_KEY_DB_VERSION, string{"2.3"});
+  }
+
+  // open and convert the file
+  {
+    ERR e;
+    auto db = TournamentDB::openExisting(fName, &e);
+    ASSERT_EQ(OK, e);
+    ASSERT_TRUE(db->isCompatibleDatabaseVersion());
+    ASSERT_TRUE(db->needsConversion());
+    for (const char* idxName : compositeIndices)
+    {
+      ASSERT_EQ(0, countSchemaObjects(db.get(), "main", "index", idxName));
+    }
+
+    ASSERT_TRUE(db->convertToLatestDatabaseVersion());
+    ASSERT_FALSE(db->needsConversion());
+
+    // the conversion also creates the derived
+    // match display table, but not in the file
+    ASSERT_EQ(1, countSchemaObjects(db.get(), "temp", "table", TAB_MATCH_DISPLAY));
+    ASSERT_EQ(0, countSchemaObjects(db.get(), "main", "table", TAB_MATCH_DISPLAY));
+  }
+
+  // the converted file has the latest version and all indices
+  ERR e;
+  auto db = TournamentDB::openExisting(fName, &e);
+  ASSERT_EQ(OK, e);
+
+  int major;
+  int minor;
+  tie(major, minor) = db->getVersion();
+  ASSERT_EQ(DB_VERSION_MAJOR, major);
+  ASSERT_EQ(DB_VERSION_MINOR, minor);
+  ASSERT_FALSE(db->needsConversion());
+
+  for (const char* idxName : compositeIndices)
+  {
+    ASSERT_EQ(1, countSchemaObjects(db.get(), "main", "index", idxName));
+  }
+
+  db.reset();
+  QFile::remove(fName);
+}
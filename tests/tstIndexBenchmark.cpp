@@ -0,0 +1,190 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <QString>
+
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+#include "CatMngr.h"
+
+#include "BasicTestClass.h"
+
+using namespace QTournament;
+
+namespace
+{
+  constexpr int N_CATS = 10;
+  constexpr int N_ROUNDS = 5;
+  constexpr int N_GROUPS = 8;
+  constexpr int N_MATCHES_PER_GROUP = 5;   // 10 * 5 * 8 * 5 = 2000 matches
+  constexpr int N_RANKS_PER_GROUP = 4;
+  constexpr int N_REPETITIONS = 20;
+
+  void execSql(TournamentDB* db, const QString& sql)
+  {
+    int dbErr;
+    ASSERT_TRUE(db->execNonQuery(sql.toUtf8().constData(), &dbErr));
+  }
+
+  //----------------------------------------------------------------------------
+
+  void generateTournament(TournamentDB* db, vector<int>& catIds)
+  {
+    CatMngr cm{db};
+    for (int c=0; c < N_CATS; ++c)
+    {
+      QString catName = "C%1";
+      catName = catName.arg(c);
+      ASSERT_EQ(OK, cm.createNewCategory(catName));
+      catIds.push_back(cm.getCategory(catName).getId());
+    }
+
+    execSql(db, "BEGIN");
+    int grpId = 0;
+    int maSeqNum = 0;
+    for (int catId : catIds)
+    {
+      for (int round=1; round <= N_ROUNDS; ++round)
+      {
+        for (int grpNum=1; grpNum <= N_GROUPS; ++grpNum)
+        {
+          ++grpId;
+          QString sql = "INSERT INTO %1 (id, %2, %3, %4, %5, %6, %7) VALUES (%8, %9, 0, %8, %10, %11, %8)";
+          sql = sql.arg(TAB_MATCH_GROUP).arg(MG_CAT_REF).arg(GENERIC_STATE_FIELD_NAME).arg(GENERIC_SEQNUM_FIELD_NAME);
+          sql = sql.arg(MG_ROUND).arg(MG_GRP_NUM).arg(MG_STAGE_SEQ_NUM);
+          sql = sql.arg(grpId).arg(catId).arg(round).arg(grpNum);
+          execSql(db, sql);
+
+          // the matches of the earlier rounds are finished, the
+          // current round is ready and the later ones are waiting
+          for (int m=0; m < N_MATCHES_PER_GROUP; ++m)
+          {
+            ++maSeqNum;
+            int stat = (round < 3) ? STAT_MA_FINISHED : ((round == 3) ? STAT_MA_READY : STAT_MA_WAITING);
+            sql = "INSERT INTO %1 (%2, %3, %4, %5) VALUES (%6, %7, %8, %9)";
+            sql = sql.arg(TAB_MATCH).arg(GENERIC_STATE_FIELD_NAME).arg(GENERIC_SEQNUM_FIELD_NAME).arg(MA_GRP_REF).arg(MA_NUM);
+            sql = sql.arg(static_cast<int>(stat)).arg(maSeqNum).arg(grpId).arg(maSeqNum);
+            execSql(db, sql);
+          }
+
+          for (int rank=1; rank <= N_RANKS_PER_GROUP; ++rank)
+          {
+            sql = "INSERT INTO %1 (%2, %3, %4, %5) VALUES (%6, %7, %8, %9)";
+            sql = sql.arg(TAB_RANKING).arg(RA_CAT_REF).arg(RA_ROUND).arg(RA_GRP_NUM).arg(RA_RANK);
+            sql = sql.arg(catId).arg(round).arg(grpNum).arg(N_RANKS_PER_GROUP - rank + 1);
+            execSql(db, sql);
+          }
+        }
+      }
+    }
+    execSql(db, "COMMIT");
+  }
+
+  //----------------------------------------------------------------------------
+
+  // runs the hot queries and returns the total
+  // duration in microseconds and a checksum of the results
+  pair<long, long> runHotQueries(TournamentDB* db, const vector<int>& catIds)
+  {
+    long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int rep=0; rep < N_REPETITIONS; ++rep)
+    {
+      // the next match that can be called
+      QString sql = "SELECT id FROM %1 WHERE %2 = %3 AND %4 > 0 ORDER BY %4 ASC LIMIT 1";
+      sql = sql.arg(TAB_MATCH).arg(GENERIC_STATE_FIELD_NAME).arg(static_cast<int>(STAT_MA_READY)).arg(MA_NUM);
+      int result = -1;
+      int dbErr;
+      db->execScalarQueryInt(sql.toUtf8().constData(), &result, &dbErr);
+      checksum += result;
+
+      for (int catId : catIds)
+      {
+        for (int round=1; round <= N_ROUNDS; ++round)
+        {
+          for (int grpNum=1; grpNum <= N_GROUPS; ++grpNum)
+          {
+            // MatchMngr::getMatchGroup()
+            sql = "SELECT id FROM %1 WHERE %2 = %3 AND %4 = %5 AND %6 = %7";
+            sql = sql.arg(TAB_MATCH_GROUP).arg(MG_CAT_REF).arg(catId).arg(MG_ROUND).arg(round).arg(MG_GRP_NUM).arg(grpNum);
+            db->execScalarQueryInt(sql.toUtf8().constData(), &result, &dbErr);
+            checksum += result;
+
+            // the first entry of a sorted ranking
+            sql = "SELECT id FROM %1 WHERE %2 = %3 AND %4 = %5 AND %6 = %7 ORDER BY %6 ASC, %8 ASC LIMIT 1";
+            sql = sql.arg(TAB_RANKING).arg(RA_CAT_REF).arg(catId).arg(RA_ROUND).arg(round).arg(RA_GRP_NUM).arg(grpNum).arg(RA_RANK);
+            db->execScalarQueryInt(sql.toUtf8().constData(), &result, &dbErr);
+            checksum += result;
+          }
+        }
+      }
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return make_pair(static_cast<long>(duration.count()), checksum);
+  }
+}
+
+//----------------------------------------------------------------------------
+
+// a timing benchmark rather than a unit test, so it's disabled by
+// default; run it with --gtest_also_run_disabled_tests
+TEST_F(BasicTestFixture, DISABLED_CompositeIndexBenchmark)
+{
+  unique_ptr<TournamentDB> _db;
+  getScenario01(_db);
+  TournamentDB* db = _db.get();
+
+  vector<int> catIds;
+  generateTournament(db, catIds);
+
+  int nMatches = -1;
+  int dbErr;
+  QString sql = "SELECT COUNT(*) FROM %1";
+  ASSERT_TRUE(db->execScalarQueryInt(sql.arg(TAB_MATCH).toUtf8().constData(), &nMatches, &dbErr));
+  ASSERT_EQ(N_CATS * N_ROUNDS * N_GROUPS * N_MATCHES_PER_GROUP, nMatches);
+
+  // after: a new database has all composite indices
+  auto after = runHotQueries(db, catIds);
+
+  // before: the indices of file format version 2.3
+  for (const char* idxName : {IDX_MATCH_STATE_NUM, IDX_RANKING_CAT_ROUND_GRP, IDX_MATCH_GROUP_CAT_ROUND_GRP})
+  {
+    execSql(db, QString{"DROP INDEX %1"}.arg(idxName));
+  }
+  auto before = runHotQueries(db, catIds);
+
+  // the indices must not change any results
+  ASSERT_EQ(before.second, after.second);
+
+  // the conversion re-creates the indices
+  ASSERT_TRUE(db->createCompositeIndices());
+  auto afterConversion = runHotQueries(db, catIds);
+  ASSERT_EQ(after.second, afterConversion.second);
+
+  cout << "Hot queries on " << nMatches << " matches, " << N_REPETITIONS << " repetitions:" << endl;
+  cout << "  without composite indices: " << before.first << " us" << endl;
+  cout << "  with composite indices:    " << after.first << " us" << endl;
+}
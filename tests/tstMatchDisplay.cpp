@@ -0,0 +1,106 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QString>
+
+#include <gtest/gtest.h>
+
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+#include "CatMngr.h"
+
+#include "BasicTestClass.h"
+
+using namespace QTournament;
+
+namespace
+{
+  int getRowCount(TournamentDB* db, const QString& tabName)
+  {
+    QString sql = "SELECT COUNT(*) FROM %1";
+    int result = -1;
+    int dbErr;
+    EXPECT_TRUE(db->execScalarQueryInt(sql.arg(tabName).toUtf8().constData(), &result, &dbErr));
+    return result;
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_F(BasicTestFixture, MatchDisplay_LoadIntoMemory)
+{
+  QString fName = QString::fromUtf8(genTestFilePath("MatchDisplayTest.tdb").c_str());
+  QFile::remove(fName);
+
+  constexpr int N_GROUPS = 4;
+  constexpr int N_MATCHES_PER_GROUP = 3;
+
+  // a file with a few matches
+  {
+    TournamentSettings cfg;
+    cfg.organizingClub = "SV Whatever";
+    cfg.tournamentName = "World Championship";
+    cfg.useTeams = true;
+    cfg.refereeMode = REFEREE_MODE::NONE;
+    auto db = TournamentDB::createNew(fName, cfg);
+    ASSERT_TRUE(db != nullptr);
+
+    CatMngr cm{db.get()};
+    ASSERT_EQ(OK, cm.createNewCategory("MS"));
+    int catId = cm.getCategory("MS").getId();
+
+    int maSeqNum = 0;
+    for (int grpNum=1; grpNum <= N_GROUPS; ++grpNum)
+    {
+      QString sql = "INSERT INTO %1 (id, %2, %3, %4, %5, %6, %7) VALUES (%8, %9, 0, %8, 1, %8, 1)";
+      sql = sql.arg(TAB_MATCH_GROUP).arg(MG_CAT_REF).arg(GENERIC_STATE_FIELD_NAME).arg(GENERIC_SEQNUM_FIELD_NAME);
+      sql = sql.arg(MG_ROUND).arg(MG_GRP_NUM).arg(MG_STAGE_SEQ_NUM);
+      sql = sql.arg(grpNum).arg(catId);
+      int dbErr;
+      ASSERT_TRUE(db->execNonQuery(sql.toUtf8().constData(), &dbErr));
+
+      for (int m=0; m < N_MATCHES_PER_GROUP; ++m)
+      {
+        ++maSeqNum;
+        sql = "INSERT INTO %1 (%2, %3, %4, %5) VALUES (%6, %7, %8, %7)";
+        sql = sql.arg(TAB_MATCH).arg(GENERIC_STATE_FIELD_NAME).arg(GENERIC_SEQNUM_FIELD_NAME).arg(MA_GRP_REF).arg(MA_NUM);
+        sql = sql.arg(static_cast<int>(STAT_MA_WAITING)).arg(maSeqNum).arg(grpNum);
+        ASSERT_TRUE(db->execNonQuery(sql.toUtf8().constData(), &dbErr));
+      }
+    }
+  }
+
+  // the in-memory copy of the file lists all matches
+  int dbErr;
+  auto db = TournamentDB::loadIntoMemory(fName, &dbErr);
+  ASSERT_EQ(SQLITE_OK, dbErr);
+  ASSERT_TRUE(db != nullptr);
+
+  ASSERT_EQ(N_GROUPS * N_MATCHES_PER_GROUP, getRowCount(db.get(), TAB_MATCH));
+  ASSERT_EQ(N_GROUPS * N_MATCHES_PER_GROUP, getRowCount(db.get(), QString("temp.%1").arg(TAB_MATCH_DISPLAY)));
+
+  // and it keeps following modifications
+  QString sql = "DELETE FROM %1 WHERE %2 = 1";
+  sql = sql.arg(TAB_MATCH).arg(GENERIC_SEQNUM_FIELD_NAME);
+  ASSERT_TRUE(db->execNonQuery(sql.toUtf8().constData(), &dbErr));
+  ASSERT_EQ(getRowCount(db.get(), TAB_MATCH), getRowCount(db.get(), QString("temp.%1").arg(TAB_MATCH_DISPLAY)));
+
+  db.reset();
+  QFile::remove(fName);
+}
@@ -0,0 +1,142 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+#include <QString>
+
+#include "TournamentDB.h"
+#include "TournamentDataDefs.h"
+#include "PlayerMngr.h"
+#include "RefereeCandidateIndex.h"
+
+#include "BasicTestClass.h"
+
+using namespace QTournament;
+
+namespace
+{
+  void finishMatch(TournamentDB* db, int matchId, const QString& result, const QString& finishTime)
+  {
+    QString sql = "UPDATE %1 SET %2 = %3, %4 = '%5', %6 = %7 WHERE id = %8";
+    sql = sql.arg(TAB_MATCH).arg(GENERIC_STATE_FIELD_NAME).arg(static_cast<int>(STAT_MA_FINISHED));
+    sql = sql.arg(MA_RESULT).arg(result).arg(MA_FINISH_TIME).arg(finishTime).arg(matchId);
+    int dbErr;
+    ASSERT_TRUE(db->execNonQuery(sql.toUtf8().constData(), &dbErr));
+  }
+
+  //----------------------------------------------------------------------------
+
+  // the player IDs in the order of the former referee dialog:
+  // each player only once per list, players acting as umpires skipped
+  vector<int> pairsToPlayerIds(const PlayerPairList& ppList)
+  {
+    vector<int> result;
+    auto addPlayer = [&result](const Player& p) {
+      if (p.getState() == STAT_PL_REFEREE) return;
+      if (find(result.begin(), result.end(), p.getId()) == result.end()) result.push_back(p.getId());
+    };
+
+    for (const PlayerPair& pp : ppList)
+    {
+      addPlayer(pp.getPlayer1());
+      if (pp.hasPlayer2()) addPlayer(pp.getPlayer2());
+    }
+
+    return result;
+  }
+
+  //----------------------------------------------------------------------------
+
+  vector<int> getPlayerIdsForRole(const TaggedRefereeCandidateList& tcl, RECENT_FINISHER_ROLE role)
+  {
+    vector<int> result;
+    for (const TaggedRefereeCandidate& tc : tcl)
+    {
+      if (tc.second == role) result.push_back(tc.first.playerId);
+    }
+    return result;
+  }
+}
+
+//----------------------------------------------------------------------------
+
+TEST_F(BasicTestFixture, RefereeCandidateIndex_RecentFinishersIncludeWalkovers)
+{
+  unique_ptr<TournamentDB> _db;
+  getScenario03(_db);
+  TournamentDB* db = _db.get();
+
+  // the round robin category has six matches; we
+  // finish one regularly and two by walkover
+  vector<int> matchIds;
+  auto it = db->getTab(TAB_MATCH)->getRowsByWhereClause("id > 0");
+  while (!(it.isEnd()))
+  {
+    matchIds.push_back((*it).getId());
+    ++it;
+  }
+  ASSERT_EQ(6u, matchIds.size());
+
+  finishMatch(db, matchIds[0], "21:15,21:19", "1000");
+  finishMatch(db, matchIds[1], "0:21,0:21", "NULL");
+  finishMatch(db, matchIds[2], "21:0,21:0", "NULL");
+
+  // the index lists the same players as
+  // PlayerMngr::getRecentFinishers(), which has been
+  // used by the referee selection dialog before
+  PlayerMngr pm{db};
+  PlayerPairList winners;
+  PlayerPairList losers;
+  PlayerPairList draws;
+  pm.getRecentFinishers(RefereeCandidateIndex::MAX_RECENT_MATCHES, winners, losers, draws);
+  ASSERT_EQ(3u, winners.size());
+  ASSERT_EQ(3u, losers.size());
+
+  RefereeCandidateIndex* rci = db->getRefereeCandidateIndex();
+  TaggedRefereeCandidateList recent = rci->getRecentFinishers(false);
+
+  // the regular match comes first; the order of the walkovers is undefined
+  vector<int> expectedWinners = pairsToPlayerIds(winners);
+  vector<int> actualWinners = getPlayerIdsForRole(recent, RECENT_FINISHER_ROLE::WINNER);
+  ASSERT_FALSE(actualWinners.empty());
+  ASSERT_EQ(expectedWinners.front(), actualWinners.front());
+  sort(expectedWinners.begin(), expectedWinners.end());
+  sort(actualWinners.begin(), actualWinners.end());
+  ASSERT_EQ(expectedWinners, actualWinners);
+
+  vector<int> expectedLosers = pairsToPlayerIds(losers);
+  vector<int> actualLosers = getPlayerIdsForRole(recent, RECENT_FINISHER_ROLE::LOSER);
+  ASSERT_FALSE(actualLosers.empty());
+  ASSERT_EQ(expectedLosers.front(), actualLosers.front());
+  sort(expectedLosers.begin(), expectedLosers.end());
+  sort(actualLosers.begin(), actualLosers.end());
+  ASSERT_EQ(expectedLosers, actualLosers);
+
+  ASSERT_TRUE(getPlayerIdsForRole(recent, RECENT_FINISHER_ROLE::DRAW).empty());
+
+  // walkovers don't count as the last finished match of a player
+  for (const RefereeCandidate& c : rci->getAllCandidates(false))
+  {
+    bool hasPlayedFirstMatch = (c.lastFinishTime__UTC == 1000);
+    ASSERT_TRUE(hasPlayedFirstMatch || (c.lastFinishTime__UTC == 0));
+  }
+}
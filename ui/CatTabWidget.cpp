@@ -78,6 +78,7 @@ CatTabWidget::CatTabWidget()
   connect(cse, SIGNAL(categoryStatusChanged(Category,OBJ_STATE,OBJ_STATE)), this, SLOT(onCatStateChanged(Category,OBJ_STATE,OBJ_STATE)));
   connect(cse, SIGNAL(playerRenamed(Player)), this, SLOT(onPlayerRenamed(Player)));
   connect(cse, SIGNAL(playerStatusChanged(int,int,OBJ_STATE,OBJ_STATE)), this, SLOT(onPlayerStateChanged(int,int,OBJ_STATE,OBJ_STATE)));
+  connect(cse, SIGNAL(statusChangeBatchDelivered(StatusChangeSet)), this, SLOT(onStatusChangeBatchDelivered(StatusChangeSet)));
   connect(cse, SIGNAL(categoryRemovedFromTournament(int,int)), this, SLOT(onCategoryRemoved()));
 
   // tell the list widgets to emit signals if a context menu is requested
@@ -846,31 +847,58 @@ void CatTabWidget::onCatStateChanged(const Category &c, const OBJ_STATE fromStat
 
 void CatTabWidget::onPlayerStateChanged(int playerId, int seqNum, const OBJ_STATE fromState, const OBJ_STATE toState)
 {
-  // is a category selected?
-  if (!(ui.catTableView->hasCategorySelected())) return;
+  // the changes of a committed transaction are handled in one go
+  if (CentralSignalEmitter::getInstance()->isDeliveringBatch()) return;
 
-  // is the affected player in the currently selected category?
-  // if not, there is nothing to do for us
-  auto selectedCat = ui.catTableView->getSelectedCategory();
-  PlayerMngr pm{db};
-  Player pl = pm.getPlayer(playerId);
-  if (!(selectedCat.hasPlayer(pl))) return;
+  if (isRegistrationChange(fromState, toState) && isPlayerInSelectedCategory(playerId))
+  {
+    updatePairs();
+  }
+}
 
-  // okay, the changed player is obviously part of the currently selected,
-  // displayed category
+//----------------------------------------------------------------------------
 
-  // if a player changes from/to WAIT_FOR_REGISTRATION, we brute-force rebuild the list widgets
-  // because we need to change the item label of the affected players for
-  // adding or removing the paranthesis around the player names
-  if (((fromState == STAT_PL_IDLE) && (toState == STAT_PL_WAIT_FOR_REGISTRATION)) ||
-      ((fromState == STAT_PL_WAIT_FOR_REGISTRATION) && (toState == STAT_PL_IDLE)))
+void CatTabWidget::onStatusChangeBatchDelivered(const StatusChangeSet& changes)
+{
+  for (const StatusChange& sc : changes.players)
   {
-    updatePairs();
+    // one rebuild covers all affected players
+    if (isRegistrationChange(sc.fromState, sc.toState) && isPlayerInSelectedCategory(sc.id))
+    {
+      updatePairs();
+      return;
+    }
   }
 }
 
 //----------------------------------------------------------------------------
 
+bool CatTabWidget::isRegistrationChange(const OBJ_STATE fromState, const OBJ_STATE toState) const
+{
+  // if a player changes from/to WAIT_FOR_REGISTRATION, we brute-force rebuild the list widgets
+  // because we need to change the item label of the affected players for
+  // adding or removing the paranthesis around the player names.
+  //
+  // This check is cheap, so we do it before any database access
+  return (((fromState == STAT_PL_IDLE) && (toState == STAT_PL_WAIT_FOR_REGISTRATION)) ||
+          ((fromState == STAT_PL_WAIT_FOR_REGISTRATION) && (toState == STAT_PL_IDLE)));
+}
+
+//----------------------------------------------------------------------------
+
+bool CatTabWidget::isPlayerInSelectedCategory(int playerId)
+{
+  // is a category selected?
+  if (!(ui.catTableView->hasCategorySelected())) return false;
+
+  auto selectedCat = ui.catTableView->getSelectedCategory();
+  PlayerMngr pm{db};
+  Player pl = pm.getPlayer(playerId);
+  return selectedCat.hasPlayer(pl);
+}
+
+//----------------------------------------------------------------------------
+
 void CatTabWidget::onRemovePlayerFromCat()
 {
   auto selPlayer = lwUnpaired_getSelectedPlayer();
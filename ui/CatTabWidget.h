@@ -24,6 +24,7 @@
 
 #include "ui_CatTabWidget.h"
 #include "TournamentDB.h"
+#include "CentralSignalEmitter.h"
 #include "ui/delegates/CatTabPlayerItemDelegate.h"
 
 class CatTabWidget : public QDialog
@@ -39,6 +40,8 @@ private:
   Ui::CatTabWidget ui;
   void updateControls();
   void updatePairs();
+  bool isRegistrationChange(const OBJ_STATE fromState, const OBJ_STATE toState) const;
+  bool isPlayerInSelectedCategory(int playerId);
   int unpairedPlayerId1;
   int unpairedPlayerId2;
 
@@ -86,6 +89,7 @@ public slots:
   void onPlayerRenamed(const Player& p);
   void onCatStateChanged(const Category& c, const OBJ_STATE fromState, const OBJ_STATE toState);
   void onPlayerStateChanged(int playerId, int seqNum, const OBJ_STATE fromState, const OBJ_STATE toState);
+  void onStatusChangeBatchDelivered(const StatusChangeSet& changes);
   void onRemovePlayerFromCat();
   void onBulkRemovePlayersFromCat();
   void onAddPlayerToCat();
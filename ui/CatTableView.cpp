@@ -36,6 +36,7 @@
 #include "ui/commonCommands/cmdImportSinglePlayerFromExternalDatabase.h"
 
 #include "CatMngr.h"
+#include "ui/DlgCatInitProgress.h"
 
 CategoryTableView::CategoryTableView(QWidget* parent)
   :GuiHelpers::AutoSizingTableView_WithDatabase<CategoryTableModel>{
@@ -446,15 +447,8 @@ void CategoryTableView::onRunCategory()
    * If we made it to this point, it is safe to apply the settings and write to
    * the database.
    */
-  QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-  e = cm.startCategory(*selectedCat, ppListList, initialRanking);
-  QApplication::restoreOverrideCursor();
-  if (e != OK)  // should never happen
-  {
-    throw std::runtime_error("Unexpected error when starting the category");
-  }
-
-  QMessageBox::information(this, tr("Start category"), tr("Category successfully started!"));
+  auto worker = make_unique<CatInitWorker>(db, *selectedCat, ppListList, initialRanking);
+  runInitWorker(std::move(worker), tr("Start category"), tr("Category successfully started!"));
 }
 
 //----------------------------------------------------------------------------
@@ -574,15 +568,44 @@ void CategoryTableView::handleIntermediateSeedingForSelectedCat()
   /*
    * If we made it to this point, we can generate matches for the next round(s)
    */
-  QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
-  CatMngr cm{db};
-  ERR e = cm.continueWithIntermediateSeeding(*selectedCat, seeding);
-  QApplication::restoreOverrideCursor();
-  if (e != OK)  // should never happen
+  auto worker = make_unique<CatInitWorker>(db, *selectedCat, seeding);
+  runInitWorker(std::move(worker), tr("Continue category"), tr("Matches successfully generated!"));
+}
+
+//----------------------------------------------------------------------------
+
+/*
+ * Generates the matches in a background thread while a
+ * non-modal dialog shows the progress. The GUI stays responsive
+ * but the main window is locked until the worker has finished.
+ */
+void CategoryTableView::runInitWorker(unique_ptr<CatInitWorker> worker, const QString& title, const QString& successMsg)
+{
+  ERR e = worker->start();
+  if (e != OK)
   {
-    throw std::runtime_error("Unexpected error when applying intermediate seeding");
+    QMessageBox::critical(this, title, tr("Could not start the match generation. No matches have been generated."));
+    onCatInitAborted(worker->getCategoryId());
+    return;
   }
-  QMessageBox::information(this, tr("Continue category"), tr("Matches successfully generated!"));
+
+  // the progress dialog has to be a child of the main window
+  // and not of this view; otherwise it would be disabled
+  // together with the main window's content
+  DlgCatInitProgress* dlg = new DlgCatInitProgress(window(), std::move(worker), title, successMsg);
+  connect(dlg, SIGNAL(initAborted(int)), this, SLOT(onCatInitAborted(int)));
+  dlg->show();
+}
+
+//----------------------------------------------------------------------------
+
+void CategoryTableView::onCatInitAborted(int catId)
+{
+  // only freshly frozen categories need a clean-up;
+  // categories waiting for intermediate seeding simply
+  // stay in their current state
+  CatMngr cm{db};
+  unfreezeAndCleanup(cm.getCategory(catId));
 }
 
 //----------------------------------------------------------------------------
@@ -29,6 +29,7 @@
 #include "models/CatTableModel.h"
 #include "delegates/CatItemDelegate.h"
 #include "AutoSizingTable.h"
+#include "CatInitWorker.h"
 
 using namespace QTournament;
 
@@ -58,6 +59,7 @@ public slots:
   
 private slots:
   void onContextMenuRequested(const QPoint& pos);
+  void onCatInitAborted(int catId);
 
 signals:
   void catModelChanged();
@@ -78,6 +80,7 @@ private:
   void initContextMenu();
 
   void handleIntermediateSeedingForSelectedCat();
+  void runInitWorker(unique_ptr<CatInitWorker> worker, const QString& title, const QString& successMsg);
   bool unfreezeAndCleanup(unique_ptr<Category> selectedCat);
 
 };
@@ -0,0 +1,88 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QMessageBox>
+
+#include "DlgBatchReportExport.h"
+
+// allocate static variables
+constexpr int DlgBatchReportExport::POLL_INTERVAL__MS;
+
+DlgBatchReportExport::DlgBatchReportExport(QWidget* parent, unique_ptr<BatchReportExporter> _exporter, const QString& _outDir)
+  :QProgressDialog(parent), exporter(std::move(_exporter)), outDir(_outDir)
+{
+  setWindowTitle(tr("Export all reports"));
+  setLabelText(tr("Exporting reports..."));
+  setRange(0, exporter->getReportCount());
+  setValue(0);
+  setWindowModality(Qt::NonModal);
+  setMinimumDuration(0);
+  setAutoClose(false);
+  setAutoReset(false);
+  setAttribute(Qt::WA_DeleteOnClose);
+
+  // don't hide the dialog immediately if "cancel" is clicked;
+  // we have to wait for the reports that are currently being generated
+  disconnect(this, SIGNAL(canceled()), this, SLOT(cancel()));
+  connect(this, SIGNAL(canceled()), this, SLOT(onCancelRequested()));
+
+  connect(&pollTimer, SIGNAL(timeout()), this, SLOT(onPollTimerElapsed()));
+  pollTimer.start(POLL_INTERVAL__MS);
+}
+
+//----------------------------------------------------------------------------
+
+DlgBatchReportExport::~DlgBatchReportExport()
+{
+  // the exporter's dtor waits for the workers
+  pollTimer.stop();
+  exporter.reset();
+}
+
+//----------------------------------------------------------------------------
+
+void DlgBatchReportExport::onPollTimerElapsed()
+{
+  setValue(exporter->getFinishedCount());
+
+  if (!(exporter->isFinished())) return;
+
+  pollTimer.stop();
+  hide();
+
+  if (!(exporter->isCancellationRequested()))
+  {
+    QString msg = tr("The reports have been exported to\n\n%1\n\nSee the details for the timing of each report.");
+    QMessageBox mb{QMessageBox::Information, windowTitle(), msg.arg(outDir), QMessageBox::Ok, parentWidget()};
+    mb.setDetailedText(exporter->getTimingSummary());
+    mb.exec();
+  }
+
+  close();
+}
+
+//----------------------------------------------------------------------------
+
+void DlgBatchReportExport::onCancelRequested()
+{
+  exporter->requestCancellation();
+  setLabelText(tr("Cancelling..."));
+  setCancelButtonText(QString());   // hides the button
+}
+
+//----------------------------------------------------------------------------
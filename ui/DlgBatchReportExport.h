@@ -0,0 +1,61 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DLGBATCHREPORTEXPORT_H
+#define DLGBATCHREPORTEXPORT_H
+
+#include <memory>
+
+#include <QProgressDialog>
+#include <QTimer>
+
+#include "reports/BatchReportExporter.h"
+
+using namespace QTournament;
+
+/*
+ * A non-modal progress view for a BatchReportExporter.
+ *
+ * The exporter operates on snapshots of the tournament database,
+ * so the main window remains usable during the export. A summary
+ * including the timing of each report is shown when the export
+ * has finished.
+ *
+ * The dialog deletes itself after it has been closed.
+ */
+class DlgBatchReportExport : public QProgressDialog
+{
+  Q_OBJECT
+
+public:
+  static constexpr int POLL_INTERVAL__MS = 100;
+
+  DlgBatchReportExport(QWidget* parent, unique_ptr<BatchReportExporter> _exporter, const QString& _outDir);
+  ~DlgBatchReportExport();
+
+private slots:
+  void onPollTimerElapsed();
+  void onCancelRequested();
+
+private:
+  unique_ptr<BatchReportExporter> exporter;
+  QString outDir;
+  QTimer pollTimer;
+};
+
+#endif // DLGBATCHREPORTEXPORT_H
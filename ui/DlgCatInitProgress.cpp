@@ -0,0 +1,147 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QMainWindow>
+#include <QMenuBar>
+#include <QMessageBox>
+
+#include "DlgCatInitProgress.h"
+
+// allocate static variables
+constexpr int DlgCatInitProgress::POLL_INTERVAL__MS;
+
+DlgCatInitProgress::DlgCatInitProgress(QWidget* parent, unique_ptr<CatInitWorker> _worker, const QString& _title, const QString& _successMsg)
+  :QProgressDialog(parent), worker(std::move(_worker)), title(_title), successMsg(_successMsg)
+{
+  setWindowTitle(title);
+  setLabelText(tr("Generating matches..."));
+  setRange(0, 100);
+  setValue(0);
+  setWindowModality(Qt::NonModal);
+  setMinimumDuration(0);
+  setAutoClose(false);
+  setAutoReset(false);
+  setAttribute(Qt::WA_DeleteOnClose);
+
+  // don't hide the dialog immediately if "cancel" is clicked;
+  // we have to wait for the worker to acknowledge the cancellation
+  disconnect(this, SIGNAL(canceled()), this, SLOT(cancel()));
+  connect(this, SIGNAL(canceled()), this, SLOT(onCancelRequested()));
+
+  setMainWindowLocked(true);
+
+  connect(&pollTimer, SIGNAL(timeout()), this, SLOT(onPollTimerElapsed()));
+  pollTimer.start(POLL_INTERVAL__MS);
+}
+
+//----------------------------------------------------------------------------
+
+DlgCatInitProgress::~DlgCatInitProgress()
+{
+  // make sure that we never leave the main window disabled,
+  // even if we're destroyed while the worker is running (the
+  // worker's dtor discards any results in this case)
+  pollTimer.stop();
+  worker.reset();
+  setMainWindowLocked(false);
+}
+
+//----------------------------------------------------------------------------
+
+void DlgCatInitProgress::onPollTimerElapsed()
+{
+  // forward the latest progress value to the progress bar
+  ProgressQueue* pq = worker->getProgressQueue();
+  while (true)
+  {
+    auto val = pq->nonblockingPop();
+    if (val == nullptr) break;
+    if (*val >= 0) setValue(*val);
+  }
+
+  if (!(worker->isFinished())) return;
+
+  pollTimer.stop();
+
+  QString errMsg;
+  ERR e = worker->applyResult(&errMsg);
+  int catId = worker->getCategoryId();
+  setMainWindowLocked(false);
+  hide();
+
+  if (e == OK)
+  {
+    QMessageBox::information(parentWidget(), title, successMsg);
+  }
+  else if (e != OPERATION_CANCELLED)
+  {
+    QString msg = tr("An unexpected error occured. No matches have been generated.");
+    if (!(errMsg.isEmpty()))
+    {
+      msg += "\n\n" + tr("Internal hint: ") + errMsg;
+    }
+    QMessageBox::critical(parentWidget(), title, msg);
+  }
+
+  if (e != OK) emit initAborted(catId);
+
+  close();
+}
+
+//----------------------------------------------------------------------------
+
+void DlgCatInitProgress::onCancelRequested()
+{
+  worker->requestCancellation();
+  setLabelText(tr("Cancelling..."));
+  setCancelButtonText(QString());   // hides the button
+}
+
+//----------------------------------------------------------------------------
+
+void DlgCatInitProgress::setMainWindowLocked(bool isLocked)
+{
+  QMainWindow* mw = qobject_cast<QMainWindow*>(parentWidget());
+  if (mw == nullptr) return;
+
+  // the tournament database is write locked while the worker
+  // is running; we disable everything that could try to modify it
+  if (mw->centralWidget() != nullptr) mw->centralWidget()->setEnabled(!isLocked);
+  if (mw->menuBar() != nullptr) mw->menuBar()->setEnabled(!isLocked);
+
+  // the actions have to be disabled separately because their
+  // shortcuts are still active in a disabled menu bar; we only
+  // re-enable the actions that have been enabled before
+  if (isLocked)
+  {
+    for (QAction* a : mw->findChildren<QAction*>())
+    {
+      if (!(a->isEnabled())) continue;
+      a->setEnabled(false);
+      lockedActions.push_back(a);
+    }
+  } else {
+    for (const QPointer<QAction>& a : lockedActions)
+    {
+      if (a != nullptr) a->setEnabled(true);
+    }
+    lockedActions.clear();
+  }
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,74 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DLGCATINITPROGRESS_H
+#define DLGCATINITPROGRESS_H
+
+#include <memory>
+
+#include <QProgressDialog>
+#include <QTimer>
+#include <QPointer>
+#include <QList>
+#include <QAction>
+
+#include "CatInitWorker.h"
+
+using namespace QTournament;
+
+/*
+ * A non-modal progress view for a CatInitWorker.
+ *
+ * The dialog polls the worker's progress queue and applies the
+ * worker's result when the worker has finished. While the
+ * worker is running, the central widget, the menu bar and all
+ * actions of the main window are disabled.
+ *
+ * The dialog deletes itself after it has been closed.
+ */
+class DlgCatInitProgress : public QProgressDialog
+{
+  Q_OBJECT
+
+public:
+  static constexpr int POLL_INTERVAL__MS = 50;
+
+  // the parent should be the main window
+  DlgCatInitProgress(QWidget* parent, unique_ptr<CatInitWorker> _worker, const QString& _title, const QString& _successMsg);
+  ~DlgCatInitProgress();
+
+signals:
+  // the worker has been cancelled or has failed;
+  // the tournament database is unchanged
+  void initAborted(int catId);
+
+private slots:
+  void onPollTimerElapsed();
+  void onCancelRequested();
+
+private:
+  unique_ptr<CatInitWorker> worker;
+  QString title;
+  QString successMsg;
+  QTimer pollTimer;
+  QList<QPointer<QAction>> lockedActions;
+
+  void setMainWindowLocked(bool isLocked);
+};
+
+#endif // DLGCATINITPROGRESS_H
@@ -127,6 +127,8 @@ void CSVDataTableWidget::setData(QTournament::TournamentDB* _db, const vector<CS
     availCatNames.push_back(string{cat.getName().toUtf8().constData()});
   }
 
+  validator = make_unique<CSVValidator>(db);
+
   rebuildContents();
   updateWarnings();
 }
@@ -151,28 +153,48 @@ void CSVDataTableWidget::rebuildContents()
 
 void CSVDataTableWidget::updateWarnings()
 {
-  errList = analyseCSV(db, records);
-  int cntFatal = 0;
+  validator->reset(records);
 
-  // reset all warnings and errors
   for (int row = 0; row < rowCount(); ++row)
   {
-    for (int col = 0; col < 5; ++col)
-    {
-      QTableWidgetItem* i = item(row, col);
-      if (i == nullptr) continue;
-      i->setData(Qt::UserRole, 0);
-      i->setData(Qt::UserRole + 1, false);
-      i->setBackgroundColor(Qt::white);
-      i->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-    }
+    applyWarningsToRow(row);
   }
 
-  // apply the new colors and warning
-  for (const CSVError& err : errList)
+  emit warnCountChanged(validator->getFatalCount(), validator->getWarningCount(), records.size());
+}
+
+//----------------------------------------------------------------------------
+
+void CSVDataTableWidget::updateWarnings(const vector<int>& modifiedRows)
+{
+  // only touch the rows that have been
+  // re-checked by the validator
+  for (int row : modifiedRows)
   {
-    if (err.isFatal) ++cntFatal;
+    applyWarningsToRow(row);
+  }
 
+  emit warnCountChanged(validator->getFatalCount(), validator->getWarningCount(), records.size());
+}
+
+//----------------------------------------------------------------------------
+
+void CSVDataTableWidget::applyWarningsToRow(int row)
+{
+  // reset all warnings and errors
+  for (int col = 0; col < 5; ++col)
+  {
+    QTableWidgetItem* i = item(row, col);
+    if (i == nullptr) continue;
+    i->setData(Qt::UserRole, 0);
+    i->setData(Qt::UserRole + 1, false);
+    i->setBackgroundColor(Qt::white);
+    i->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+  }
+
+  // apply the new colors and warning
+  for (const CSVError& err : validator->getErrorsForRow(row))
+  {
     QTableWidgetItem* i = item(err.row, err.column);
     if (i == nullptr) continue;
 
@@ -195,8 +217,6 @@ void CSVDataTableWidget::updateWarnings()
       i->setFlags(0);
     }
   }
-
-  emit warnCountChanged(cntFatal, errList.size() - cntFatal, records.size());
 }
 
 //----------------------------------------------------------------------------
@@ -263,10 +283,11 @@ QString CSVDataTableWidget::getErrMsg(int row, int col)
 {
   // check if there are error messages or warnings for the
   // currently selected cell
+  if (validator == nullptr) return "--";
   QString msg;
-  for (const CSVError& err : errList)
+  for (const CSVError& err : validator->getErrorsForRow(row))
   {
-    if ((err.row != row) || (err.column != col)) continue;
+    if (err.column != col) continue;
 
     QString m;
     switch (err.err)
@@ -418,7 +439,9 @@ void CSVDataTableWidget::onCellDoubleClicked(int row, int col)
     // make sure that everything is in sync
     if (col <= CSVFieldsIndex::Sex) createOrUpdateCellItem(row, CSVFieldsIndex::Sex);
 
-    updateWarnings();
+    // re-check only the modified row and the rows
+    // that are affected by a name change
+    updateWarnings(validator->updateRow(records, row));
   }
 }
 
@@ -442,7 +465,7 @@ void CSVDataTableWidget::onBtnAddRowClicked()
 {
   string l{tr("New").toUtf8().constData()};
   string f{tr("Player").toUtf8().constData()};
-  CSVImportRecord newRec{db, {l, f, "", "", ""}};
+  CSVImportRecord newRec{validator->getContext(), {l, f, "", "", ""}};
 
   if (records.size() == 0)
   {
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 
 #include <QDialog>
 #include <QString>
@@ -41,6 +42,8 @@ protected slots:
 protected:
   void rebuildContents();
   void updateWarnings();
+  void updateWarnings(const vector<int>& modifiedRows);
+  void applyWarningsToRow(int row);
   void createOrUpdateCellItem(int row, int col, const QString& txt);
   void createOrUpdateCellItem(int row, int col);
   void createOrUpdateCellItem(int row);
@@ -48,7 +51,7 @@ protected:
 private:
   QTournament::TournamentDB* db;
   vector<QTournament::CSVImportRecord> records;
-  vector<QTournament::CSVError> errList;
+  unique_ptr<QTournament::CSVValidator> validator;
   vector<QTournament::Category> availCategories;
   vector<string> availCatNames;
 };
@@ -31,6 +31,7 @@
 #include "Team.h"
 #include "TeamMngr.h"
 #include "PlayerMngr.h"
+#include "PlayerScheduleIndex.h"
 #include "HelperFunc.h"
 #include "delegates/DelegateItemLED.h"
 #include "DlgPlayerProfile.h"
@@ -273,42 +274,33 @@ void DlgSelectReferee::rebuildPlayerList()
   // stop here
   if ((curFilterMode == REFEREE_MODE::SPECIAL_TEAM) && (curTeamId < 1))
   {
-    ui->tabPlayers->rebuildPlayerList(TaggedPlayerList(), ma.getMatchNumber(), curFilterMode);
+    ui->tabPlayers->rebuildPlayerList(db, TaggedPlayerList(), ma.getMatchNumber(), curFilterMode);
     return;
   }
 
-  // determine the list of players for display
-  PlayerMngr pm{db};
-  TeamMngr tm{db};
+  // if we currently calling the match or swapping the umpire, only players in state IDLE
+  // may be selected
+  bool idleOnly = (refAction != REFEREE_ACTION::PRE_ASSIGN);
+
+  // determine the list of players for display. The candidate index
+  // provides everything we need for the table, so we don't have
+  // to touch the database for each individual player
+  RefereeCandidateIndex* rci = db->getRefereeCandidateIndex();
   TaggedPlayerList pList;
-  if (curFilterMode == REFEREE_MODE::ALL_PLAYERS)
+  if ((curFilterMode == REFEREE_MODE::ALL_PLAYERS) || (curFilterMode == REFEREE_MODE::SPECIAL_TEAM))
   {
-    PlayerList purePlayerList = pm.getAllPlayers();
+    RefereeCandidateList candList = (curFilterMode == REFEREE_MODE::ALL_PLAYERS) ?
+          rci->getAllCandidates(idleOnly) : rci->getCandidatesForTeam(curTeamId, idleOnly);
 
     // sort players alphabetically
-    std::sort(purePlayerList.begin(), purePlayerList.end(), [](const Player& p1, const Player& p2) {
-      return p1.getDisplayName() < p2.getDisplayName();
+    std::sort(candList.begin(), candList.end(), [](const RefereeCandidate& c1, const RefereeCandidate& c2) {
+      return c1.displayName < c2.displayName;
     });
 
     // convert to a tagged player list with all tags set to NEUTRAL
-    for (const Player& p : purePlayerList)
+    for (const RefereeCandidate& c : candList)
     {
-      pList.push_back(make_pair(p, RefereeSelectionDelegate::NeutralTag));
-    }
-  }
-  if (curFilterMode == REFEREE_MODE::SPECIAL_TEAM)
-  {
-    Team selTeam = tm.getTeamById(curTeamId);
-    PlayerList purePlayerList = tm.getPlayersForTeam(selTeam);
-
-    std::sort(purePlayerList.begin(), purePlayerList.end(), [](const Player& p1, const Player& p2) {
-      return p1.getDisplayName() < p2.getDisplayName();
-    });
-
-    // convert to a tagged player list with all tags set to NEUTRAL
-    for (const Player& p : purePlayerList)
-    {
-      pList.push_back(make_pair(p, RefereeSelectionDelegate::NeutralTag));
+      pList.push_back(make_pair(c, RefereeSelectionDelegate::NeutralTag));
     }
   }
   if (curFilterMode == REFEREE_MODE::RECENT_FINISHERS)
@@ -316,80 +308,27 @@ void DlgSelectReferee::rebuildPlayerList()
     pList = getPlayerList_recentFinishers();
   }
 
-  // if we currently calling the match or swapping the umpire, only players in state IDLE
-  // may be selected
-  if (refAction != REFEREE_ACTION::PRE_ASSIGN)
-  {
-    auto it = pList.begin();
-    while (it != pList.end())
-    {
-      const TaggedPlayer& tp = *it;
-      const Player& p = tp.first;
-      if (p.getState() != STAT_PL_IDLE)
-      {
-        it = pList.erase(it);
-      } else {
-        ++it;
-      }
-    }
-  }
-
   // add the players to the table
-  ui->tabPlayers->rebuildPlayerList(pList, ma.getMatchNumber(), curFilterMode);
+  ui->tabPlayers->rebuildPlayerList(db, pList, ma.getMatchNumber(), curFilterMode);
 }
 
 //----------------------------------------------------------------------------
 
 TaggedPlayerList DlgSelectReferee::getPlayerList_recentFinishers()
 {
-  PlayerMngr pm{db};
-  PlayerPairList winners;
-  PlayerPairList losers;
-  PlayerPairList draws;
-  pm.getRecentFinishers(MAX_NUM_LOSERS, winners, losers, draws);
-
-  // process winners, losers and draws
-  vector<pair<PlayerPairList&, int>> allLists = {
-    {winners, RefereeSelectionDelegate::WinnerTag},
-    {losers, RefereeSelectionDelegate::LoserTag},
-    {draws, RefereeSelectionDelegate::NeutralTag},
-  };
+  bool idleOnly = (refAction != REFEREE_ACTION::PRE_ASSIGN);
+  RefereeCandidateIndex* rci = db->getRefereeCandidateIndex();
+
+  // the index has already removed duplicates and players
+  // that are currently acting as umpires
   TaggedPlayerList result;
-  for (pair<PlayerPairList&, int> listDef : allLists)
+  for (const TaggedRefereeCandidate& tc : rci->getRecentFinishers(idleOnly))
   {
-    PlayerList purePlayerList;
-    for (const PlayerPair& pp : listDef.first)
-    {
-      Player p = pp.getPlayer1();
-
-      // if this player is already a referee, skip this player
-      if (p.getState() == STAT_PL_REFEREE) continue;
+    int tag = RefereeSelectionDelegate::NeutralTag;
+    if (tc.second == RECENT_FINISHER_ROLE::WINNER) tag = RefereeSelectionDelegate::WinnerTag;
+    if (tc.second == RECENT_FINISHER_ROLE::LOSER) tag = RefereeSelectionDelegate::LoserTag;
 
-      // Before we add this player to the result list,
-      // make sure that the player is not already in it
-      if (std::find(purePlayerList.begin(), purePlayerList.end(), p) == purePlayerList.end())
-      {
-        purePlayerList.push_back(p);
-      }
-
-      // if this is a doubles pair, check the second player as well
-      if (pp.hasPlayer2())
-      {
-        p = pp.getPlayer2();
-        if (p.getState() == STAT_PL_REFEREE) continue;
-        if (std::find(purePlayerList.begin(), purePlayerList.end(), p) == purePlayerList.end())
-        {
-          purePlayerList.push_back(p);
-        }
-      }
-    }
-
-    // convert the winner into a tagged player list
-    // with the tag set to the appropriate value
-    for (const Player& p : purePlayerList)
-    {
-      result.push_back(make_pair(p, listDef.second));
-    }
+    result.push_back(make_pair(tc.first, tag));
   }
 
   return result;
@@ -416,7 +355,7 @@ RefereeTableWidget::RefereeTableWidget(QWidget* parent)
 
 //----------------------------------------------------------------------------
 
-void RefereeTableWidget::rebuildPlayerList(const TaggedPlayerList& pList, int selectedMatchNumer, REFEREE_MODE _refMode)
+void RefereeTableWidget::rebuildPlayerList(TournamentDB* _db, const TaggedPlayerList& pList, int selectedMatchNumer, REFEREE_MODE _refMode)
 {
   // store the current referee mode. We need this to properly
   // initiate the filtering column
@@ -426,73 +365,69 @@ void RefereeTableWidget::rebuildPlayerList(const TaggedPlayerList& pList, int se
   clearContents();
   setRowCount(0);
 
-  // grab the current database handle from the first entry
-  // in the player list
   if (pList.empty())
   {
     setDatabase(nullptr);
     return;
   } else {
-    setDatabase(pList.at(0).first.getDatabaseHandle());
+    setDatabase(_db);
   }
 
   // disable sorting while we're modifying the table
   setSortingEnabled(false);
 
+  // the next match of all players in one go instead
+  // of one schedule lookup per table row
+  unordered_map<int, int> nextMatchNums = db->getPlayerScheduleIndex()->getNextMatchNumbers();
+
   // populate the table rows
-  PlayerMngr pm{db};
   setRowCount(pList.size());
   int idxRow = 0;
   for (const TaggedPlayer& tp : pList)
   {
-    const Player& p = tp.first;
+    const RefereeCandidate& c = tp.first;
+
+    // a helper for creating a new cell item that carries the
+    // player ID and the player state as user data. The state
+    // is used by the delegate for coloring the first column.
+    auto createItem = [&c](const QString& txt) {
+      QTableWidgetItem* newItem = new QTableWidgetItem(txt);
+      newItem->setData(Qt::UserRole, c.playerId);
+      newItem->setData(Qt::UserRole + 2, static_cast<int>(c.state));
+      newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+      return newItem;
+    };
 
     // add the player's name
-    QTableWidgetItem* newItem = new QTableWidgetItem(p.getDisplayName());
-    newItem->setData(Qt::UserRole, p.getId());
+    QTableWidgetItem* newItem = createItem(c.displayName);
     newItem->setData(Qt::UserRole + 1, tp.second);  // set the tag
-    newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
     setItem(idxRow, NAME_COL_ID, newItem);
 
     // add the player's team
-    newItem = new QTableWidgetItem(p.getTeam().getName());
-    newItem->setData(Qt::UserRole, p.getId());
-    newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-    setItem(idxRow, TEAM_COL_ID, newItem);
+    setItem(idxRow, TEAM_COL_ID, createItem(c.teamName));
 
     // add the player's referee count
-    int refereeCount = p.getRefereeCount();
-    newItem = new QTableWidgetItem(QString::number(refereeCount));
-    newItem->setData(Qt::UserRole, p.getId());
-    newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-    setItem(idxRow, REFEREE_COUNT_COL_ID, newItem);
+    setItem(idxRow, REFEREE_COUNT_COL_ID, createItem(QString::number(c.refereeCount)));
 
     // add the time of the last finished match
-    auto ma = pm.getLastFinishedMatchForPlayer(p);
     QString txt = "--";
-    if (ma != nullptr)
+    if (c.lastFinishTime__UTC > 0)
     {
-      QDateTime finishTime = ma->getFinishTime();
+      QDateTime finishTime = QDateTime::fromTime_t(c.lastFinishTime__UTC);
       txt = finishTime.toString("HH:mm");
     }
-    newItem = new QTableWidgetItem(txt);
-    newItem->setData(Qt::UserRole, p.getId());
-    newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-    setItem(idxRow, LAST_FINISH_TIME_COL_ID, newItem);
+    setItem(idxRow, LAST_FINISH_TIME_COL_ID, createItem(txt));
 
     // add the player's status as a color indication in
     // the first column
-    newItem = new QTableWidgetItem("");
-    newItem->setData(Qt::UserRole, p.getId());
-    newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-    setItem(idxRow, STAT_COL_ID, newItem);
+    setItem(idxRow, STAT_COL_ID, createItem(""));
 
     // add the offset to the next match for the player
-    ma = pm.getNextMatchForPlayer(p);
+    auto itNext = nextMatchNums.find(c.playerId);
     txt = "--";
-    if (ma != nullptr)
+    if (itNext != nextMatchNums.end())
     {
-      int matchNumOffset = ma->getMatchNumber() - selectedMatchNumer;
+      int matchNumOffset = itNext->second - selectedMatchNumer;
 
       if (matchNumOffset > 0) txt = "+ %1";
       if (matchNumOffset < 0)
@@ -502,10 +437,7 @@ void RefereeTableWidget::rebuildPlayerList(const TaggedPlayerList& pList, int se
       }
       txt = txt.arg(matchNumOffset);
     }
-    newItem = new QTableWidgetItem(txt);
-    newItem->setData(Qt::UserRole, p.getId());
-    newItem->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
-    setItem(idxRow, NEXT_MATCH_DIST_COL_ID, newItem);
+    setItem(idxRow, NEXT_MATCH_DIST_COL_ID, createItem(txt));
 
     idxRow++;
   }
@@ -26,6 +26,7 @@
 
 #include "TournamentDB.h"
 #include "Match.h"
+#include "RefereeCandidateIndex.h"
 #include "delegates/RefereeSelectionDelegate.h"
 #include "AutoSizingTable.h"
 
@@ -35,7 +36,7 @@ namespace Ui {
 
 using namespace QTournament;
 
-using TaggedPlayer = pair<Player, int>;
+using TaggedPlayer = pair<RefereeCandidate, int>;
 using TaggedPlayerList = QList<TaggedPlayer>;
 
 class DlgSelectReferee : public QDialog
@@ -43,7 +44,7 @@ class DlgSelectReferee : public QDialog
   Q_OBJECT
 
 public:
-  static constexpr int MAX_NUM_LOSERS = 30;
+  static constexpr int MAX_NUM_LOSERS = RefereeCandidateIndex::MAX_RECENT_MATCHES;
   explicit DlgSelectReferee(TournamentDB* _db, const Match& _ma, REFEREE_ACTION _refAction, QWidget *parent = 0);
   ~DlgSelectReferee();
   upPlayer getFinalPlayerSelection();
@@ -88,7 +89,7 @@ public:
   RefereeTableWidget(QWidget* parent=0);
   virtual ~RefereeTableWidget() {}
 
-  void rebuildPlayerList(const TaggedPlayerList& pList, int selectedMatchNumer, REFEREE_MODE _refMode);
+  void rebuildPlayerList(TournamentDB* _db, const TaggedPlayerList& pList, int selectedMatchNumer, REFEREE_MODE _refMode);
   upPlayer getSelectedPlayer();
   bool hasPlayerSelected();
 
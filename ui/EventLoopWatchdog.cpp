@@ -0,0 +1,252 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDateTime>
+#include <QEvent>
+#include <QThread>
+
+#include "EventLoopWatchdog.h"
+#include "TournamentDB.h"
+
+using namespace QTournament;
+
+// allocate static variables
+constexpr int EventLoopWatchdog::HEARTBEAT_INTERVAL__MS;
+constexpr int EventLoopWatchdog::DEFAULT_STALL_THRESHOLD__MS;
+constexpr qint64 EventLoopWatchdog::MAX_LOG_FILE_SIZE__BYTES;
+EventLoopWatchdog* EventLoopWatchdog::instance = nullptr;
+
+void EventLoopWatchdog::initFromEnvironment()
+{
+  if (instance != nullptr) return;
+
+  QString logFileName = qgetenv("QTOURNAMENT_STALL_LOG");
+  if (logFileName.isEmpty()) return;
+
+  int threshold = DEFAULT_STALL_THRESHOLD__MS;
+  bool isOk;
+  int tmp = qgetenv("QTOURNAMENT_STALL_THRESHOLD_MS").toInt(&isOk);
+  if (isOk && (tmp > 0)) threshold = tmp;
+
+  // count the SQL statements of all databases that will be opened
+  TournamentDB::setStatementCountingEnabled(true);
+
+  instance = new EventLoopWatchdog(logFileName, threshold);
+}
+
+//----------------------------------------------------------------------------
+
+EventLoopWatchdog* EventLoopWatchdog::getInstance()
+{
+  return instance;
+}
+
+//----------------------------------------------------------------------------
+
+bool EventLoopWatchdog::isActiveInCurrentThread()
+{
+  // we only watch the GUI thread
+  return ((instance != nullptr) && (QThread::currentThread() == instance->thread()));
+}
+
+//----------------------------------------------------------------------------
+
+void EventLoopWatchdog::cleanUp()
+{
+  if (instance != nullptr)
+  {
+    delete instance;
+    instance = nullptr;
+  }
+}
+
+//----------------------------------------------------------------------------
+
+EventLoopWatchdog::EventLoopWatchdog(const QString& _logFileName, int _threshold__ms)
+  :QObject(), logFileName(_logFileName), threshold__ms(_threshold__ms), lastHeartbeat__ms(0),
+    sqlCountAtLastHeartbeat(0)
+{
+  clock.start();
+
+  heartbeatTimer = make_unique<QTimer>();
+  connect(heartbeatTimer.get(), SIGNAL(timeout()), this, SLOT(onHeartbeat()));
+  heartbeatTimer->start(HEARTBEAT_INTERVAL__MS);
+}
+
+//----------------------------------------------------------------------------
+
+void EventLoopWatchdog::beginHandler(const QString& label)
+{
+  handlerStack.push_back(RunningHandler{label, clock.elapsed(), TournamentDB::getStatementCount()});
+}
+
+//----------------------------------------------------------------------------
+
+void EventLoopWatchdog::endHandler()
+{
+  if (handlerStack.empty()) return;
+
+  const RunningHandler& rh = handlerStack.back();
+  qint64 duration = clock.elapsed() - rh.start__ms;
+  if (duration >= threshold__ms)
+  {
+    int depth = handlerStack.size() - 1;
+    unsigned long sqlCount = TournamentDB::getStatementCount() - rh.sqlCountAtStart;
+    slowHandlers.push_back(SlowHandler{rh.label, depth, duration, sqlCount});
+  }
+
+  handlerStack.pop_back();
+}
+
+//----------------------------------------------------------------------------
+
+void EventLoopWatchdog::onHeartbeat()
+{
+  qint64 now = clock.elapsed();
+  unsigned long sqlCount = TournamentDB::getStatementCount();
+
+  // the time the event loop was blocked
+  // beyond the normal timer interval
+  qint64 stall = now - lastHeartbeat__ms - HEARTBEAT_INTERVAL__MS;
+  if ((lastHeartbeat__ms > 0) && (stall >= threshold__ms))
+  {
+    writeStallToLog(stall, sqlCount - sqlCountAtLastHeartbeat);
+  }
+
+  // slow handlers that didn't cause a stall have been
+  // executed in a nested event loop (e.g., a modal dialog);
+  // we're not interested in them
+  slowHandlers.clear();
+
+  lastHeartbeat__ms = now;
+  sqlCountAtLastHeartbeat = sqlCount;
+}
+
+//----------------------------------------------------------------------------
+
+void EventLoopWatchdog::writeStallToLog(qint64 stall__ms, unsigned long sqlCount)
+{
+  // rotate the log if it has become too big
+  QFileInfo fi{logFileName};
+  if (fi.exists() && (fi.size() > MAX_LOG_FILE_SIZE__BYTES))
+  {
+    QString oldLogFileName = logFileName + ".1";
+    QFile::remove(oldLogFileName);
+    QFile::rename(logFileName, oldLogFileName);
+  }
+
+  QFile f{logFileName};
+  if (!(f.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))) return;
+  QTextStream out{&f};
+
+  QString hdr = "%1  stall of %2 ms, %3 SQL statements";
+  hdr = hdr.arg(QDateTime::currentDateTime().toString(Qt::ISODate));
+  hdr = hdr.arg(stall__ms);
+  hdr = hdr.arg(sqlCount);
+  out << hdr << "\n";
+
+  if (slowHandlers.empty())
+  {
+    out << "    (no traced handler above the threshold)\n";
+  }
+
+  // the handlers are stored in the order of completion,
+  // so the innermost handlers come first. We print them
+  // in the order of invocation.
+  for (auto it = slowHandlers.rbegin(); it != slowHandlers.rend(); ++it)
+  {
+    QString line = "    %1%2: %3 ms, %4 SQL statements";
+    line = line.arg(QString(2 * it->depth, ' '));
+    line = line.arg(it->label);
+    line = line.arg(it->duration__ms);
+    line = line.arg(it->sqlCount);
+    out << line << "\n";
+  }
+}
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+HandlerTrace::HandlerTrace(const char* label)
+  :isTracing(EventLoopWatchdog::isActiveInCurrentThread())
+{
+  if (isTracing) EventLoopWatchdog::getInstance()->beginHandler(QString::fromUtf8(label));
+}
+
+//----------------------------------------------------------------------------
+
+HandlerTrace::HandlerTrace(const QString& label)
+  :isTracing(EventLoopWatchdog::isActiveInCurrentThread())
+{
+  if (isTracing) EventLoopWatchdog::getInstance()->beginHandler(label);
+}
+
+//----------------------------------------------------------------------------
+
+HandlerTrace::~HandlerTrace()
+{
+  if (isTracing && EventLoopWatchdog::isActive()) EventLoopWatchdog::getInstance()->endHandler();
+}
+
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+
+InstrumentedApplication::InstrumentedApplication(int& argc, char** argv)
+  :QApplication(argc, argv)
+{
+}
+
+//----------------------------------------------------------------------------
+
+bool InstrumentedApplication::notify(QObject* receiver, QEvent* ev)
+{
+  if (!(EventLoopWatchdog::isActiveInCurrentThread())) return QApplication::notify(receiver, ev);
+
+  // only trace the top-level dispatch of each event loop (including
+  // nested loops of modal dialogs); everything below is covered by
+  // the traces in AbstractCommand::exec()
+  int loopLevel = QThread::currentThread()->loopLevel();
+  if ((!(tracedLoopLevels.empty())) && (loopLevel <= tracedLoopLevels.back()))
+  {
+    return QApplication::notify(receiver, ev);
+  }
+
+  // determine the label before the event is dispatched because
+  // the receiver might be deleted while processing the event
+  QString label = "%1 '%2', event type %3";
+  label = label.arg(receiver->metaObject()->className());
+  label = label.arg(receiver->objectName());
+  label = label.arg(static_cast<int>(ev->type()));
+
+  tracedLoopLevels.push_back(loopLevel);
+  bool result;
+  {
+    HandlerTrace ht{label};
+    result = QApplication::notify(receiver, ev);
+  }
+  tracedLoopLevels.pop_back();
+
+  return result;
+}
+
+//----------------------------------------------------------------------------
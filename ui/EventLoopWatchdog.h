@@ -0,0 +1,141 @@
+/*
+ *    This is QTournament, a badminton tournament management program.
+ *    Copyright (C) 2014 - 2017  Volker Knollmann
+ *
+ *    This program is free software: you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation, either version 3 of the License, or
+ *    any later version.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EVENTLOOPWATCHDOG_H
+#define EVENTLOOPWATCHDOG_H
+
+#include <memory>
+#include <vector>
+
+#include <QObject>
+#include <QApplication>
+#include <QString>
+#include <QTimer>
+#include <QElapsedTimer>
+
+using namespace std;
+
+/*
+ * Opt-in instrumentation for finding out what blocks the event loop.
+ *
+ * The watchdog is only active if the environment variable
+ * QTOURNAMENT_STALL_LOG contains the name of a log file. The optional
+ * variable QTOURNAMENT_STALL_THRESHOLD_MS overrides the default
+ * threshold for reporting a stall.
+ *
+ * A heartbeat timer detects stalls: if the timer fires significantly
+ * later than expected, the event loop was blocked. All handlers (see
+ * HandlerTrace) that have been slower than the threshold in the meantime
+ * are written to the log together with the stall duration and the
+ * number of SQL statements that have been executed.
+ */
+class EventLoopWatchdog : public QObject
+{
+  Q_OBJECT
+
+public:
+  static constexpr int HEARTBEAT_INTERVAL__MS = 50;
+  static constexpr int DEFAULT_STALL_THRESHOLD__MS = 250;
+  static constexpr qint64 MAX_LOG_FILE_SIZE__BYTES = 2 * 1024 * 1024;   // rotate the log after 2 MB
+
+  static void initFromEnvironment();
+  static EventLoopWatchdog* getInstance();   // nullptr if not active
+  static bool isActive() { return (instance != nullptr); }
+  static bool isActiveInCurrentThread();
+  static void cleanUp();
+
+  // for HandlerTrace only
+  void beginHandler(const QString& label);
+  void endHandler();
+
+public slots:
+  void onHeartbeat();
+
+private:
+  struct RunningHandler
+  {
+    QString label;
+    qint64 start__ms;
+    unsigned long sqlCountAtStart;
+  };
+
+  struct SlowHandler
+  {
+    QString label;
+    int depth;
+    qint64 duration__ms;
+    unsigned long sqlCount;
+  };
+
+  EventLoopWatchdog(const QString& _logFileName, int _threshold__ms);
+  static EventLoopWatchdog* instance;
+
+  QString logFileName;
+  int threshold__ms;
+  QElapsedTimer clock;
+  unique_ptr<QTimer> heartbeatTimer;
+  qint64 lastHeartbeat__ms;
+  unsigned long sqlCountAtLastHeartbeat;
+  vector<RunningHandler> handlerStack;
+  vector<SlowHandler> slowHandlers;
+
+  void writeStallToLog(qint64 stall__ms, unsigned long sqlCount);
+};
+
+//----------------------------------------------------------------------------
+
+/*
+ * RAII helper that marks the execution of a handler:
+ *
+ *   HandlerTrace ht{"cmdCallMatch::exec"};
+ *
+ * There's no need to add traces to individual slots: the top-level
+ * dispatch of each event is traced by InstrumentedApplication and
+ * all commands are traced by AbstractCommand::exec().
+ *
+ * Does nothing if the watchdog is not active.
+ */
+class HandlerTrace
+{
+public:
+  HandlerTrace(const char* label);
+  HandlerTrace(const QString& label);
+  ~HandlerTrace();
+
+private:
+  bool isTracing;
+};
+
+//----------------------------------------------------------------------------
+
+/*
+ * A QApplication that wraps each top-level event dispatch in a
+ * HandlerTrace so that we see the receiver of the event
+ * that blocked the event loop
+ */
+class InstrumentedApplication : public QApplication
+{
+public:
+  InstrumentedApplication(int& argc, char** argv);
+  bool notify(QObject* receiver, QEvent* ev) override;
+
+private:
+  vector<int> tracedLoopLevels;
+};
+
+#endif // EVENTLOOPWATCHDOG_H
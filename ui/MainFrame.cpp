@@ -17,11 +17,14 @@
  */
 
 #include <stdexcept>
+#include <algorithm>
 
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QFile>
 #include <QTime>
+#include <QDateTime>
+#include <QDebug>
 
 #include "MainFrame.h"
 #include "MatchMngr.h"
@@ -29,19 +32,34 @@
 #include "PlayerMngr.h"
 #include "TeamMngr.h"
 #include "CatMngr.h"
+#include "reports/BracketVisData.h"
 #include "ui/DlgTournamentSettings.h"
 #include "CourtMngr.h"
+#include "CatInitWorker.h"
+#include "ui/DlgBatchReportExport.h"
+#include "ChangeJournal.h"
+#include "SnapshotStore.h"
+#include "CentralSignalEmitter.h"
 
 using namespace QTournament;
 
 //----------------------------------------------------------------------------
 
 MainFrame::MainFrame()
-  :currentDb(nullptr), lastAutosaveDirtyCounterValue(0), lastDirtyState(false)
+  :currentDb(nullptr), pendingSave(PendingSave::None), lastAutosaveDirtyCounterValue(0), lastDirtyState(false)
 {
   ui.setupUi(this);
   showMaximized();
 
+  // the live results export is inactive until the user starts it
+  liveResultsExporter = make_unique<LiveResultsExporter>();
+
+  // a timer for initializing the tabs in idle time
+  // after a tournament has been opened
+  lazyTabInitTimer = make_unique<QTimer>(this);
+  lazyTabInitTimer->setObjectName("lazyTabInitTimer");   // shows up in the event loop watchdog's log
+  connect(lazyTabInitTimer.get(), SIGNAL(timeout()), this, SLOT(onLazyTabInitTimerElapsed()));
+
   // disable all widgets by setting their database instance to nullptr
   distributeCurrentDatabasePointerToWidgets();
   enableControls(false);
@@ -58,12 +76,13 @@ MainFrame::MainFrame()
   isTestMenuVisible = true;
   onToggleTestMenuVisibility();
 
-  // initialize timers for polling the database's dirty flag
-  // and for triggering the autosave function
-  dirtyFlagPollTimer = make_unique<QTimer>(this);
-  connect(dirtyFlagPollTimer.get(), SIGNAL(timeout()), this, SLOT(onDirtyFlagPollTimerElapsed()));
-  dirtyFlagPollTimer->start(DIRTY_FLAG_POLL_INTERVALL__MS);
+  // the database's dirty flag can only change after a commit,
+  // so we don't need to poll it
+  connect(CentralSignalEmitter::getInstance(), SIGNAL(rowChangesCommitted(RowChangeSet)), this, SLOT(onRowChangesCommitted(RowChangeSet)));
+
+  // initialize a timer for triggering the autosave function
   autosaveTimer = make_unique<QTimer>(this);
+  autosaveTimer->setObjectName("autosaveTimer");
   connect(autosaveTimer.get(), SIGNAL(timeout()), this, SLOT(onAutosaveTimerElapsed()));
   autosaveTimer->start(AUTOSAVE_INTERVALL__MS);
 
@@ -71,6 +90,14 @@ MainFrame::MainFrame()
   lastAutosaveTimeStatusLabel = new QLabel(statusBar());
   lastAutosaveTimeStatusLabel->clear();
   statusBar()->addPermanentWidget(lastAutosaveTimeStatusLabel);
+
+  // prepare a status bar progress indicator for background saves
+  saveProgressBar = new QProgressBar(statusBar());
+  saveProgressBar->setRange(0, 100);
+  saveProgressBar->setFormat(tr("Saving... %p%"));
+  saveProgressBar->setMaximumWidth(200);
+  saveProgressBar->hide();
+  statusBar()->addPermanentWidget(saveProgressBar);
 }
 
 //----------------------------------------------------------------------------
@@ -158,6 +185,7 @@ void MainFrame::openTournament()
 
   // get the filename
   QString filename = fDlg.selectedFiles().at(0);
+  startupClock.start();
 
   // try to open the tournament file DIRECTLY
   //
@@ -225,10 +253,10 @@ void MainFrame::openTournament()
     QMessageBox::warning(this, tr("Open failed"), msg);
     return;
   }
+  logStartupStage("file checked");
   int dbErr;
-  newDb = SqliteDatabase::get<TournamentDB>(":memory:", true);
-  newDb->restoreFromFile(filename.toUtf8().constData(), &dbErr);
-  newDb->setLogLevel(Sloppy::Logger::SeverityLevel::error);
+  newDb = TournamentDB::loadIntoMemory(filename, &dbErr);
+  logStartupStage("database restored into memory");
 
   // handle erros
   QString msg;
@@ -250,14 +278,48 @@ void MainFrame::openTournament()
     return;
   }
 
-  // opening was successfull ==> distribute the database handle to all widgets
+  // if the tournament hasn't been closed properly, the change
+  // journal contains all modifications after the last save
+  QString journalFileName = ChangeJournal::getJournalFileName(filename);
+  int nReplayed = 0;
+  if (QFile::exists(journalFileName))
+  {
+    ERR err = newDb->replayChangeJournal(journalFileName, &nReplayed);
+    if (err != OK)
+    {
+      // keep the journal for a manual analysis
+      QFile::remove(journalFileName + ".failed");
+      QFile::rename(journalFileName, journalFileName + ".failed");
+
+      msg = tr("The unsaved changes of the previous session could not be restored.\n\n");
+      msg += tr("The tournament has been opened in the state of the last save.");
+      QMessageBox::warning(this, tr("Restore unsaved changes"), msg);
+      nReplayed = 0;
+    }
+    logStartupStage(QString("%1 journal records replayed").arg(nReplayed));
+  }
+
+  // older versions filled the gaps in the brackets only when a
+  // bracket report was shown; reports are now strictly read-only
+  // and rely on the gaps being filled when a match is finished
+  CatMngr cm{newDb.get()};
+  for (const Category& cat : cm.getAllCategories())
+  {
+    auto bvd = BracketVisData::getExisting(cat);
+    if (bvd != nullptr) bvd->fillMissingPlayerNames();
+  }
+
+  // opening was successfull ==> distribute the database handle to all widgets;
+  // only the visible tab is initialized now, all others follow lazily
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
   currentDb = std::move(newDb);
   distributeCurrentDatabasePointerToWidgets();
   enableControls(true);
   QApplication::restoreOverrideCursor();
+  logStartupStage("visible tab ready");
   currentDatabaseFileName = filename;
   ui.actionCreate_baseline->setEnabled(true);
+  startChangeJournal(false);
   lastDirtyState = false;
   lastAutosaveDirtyCounterValue = 0;
   onAutosaveTimerElapsed();
@@ -265,6 +327,13 @@ void MainFrame::openTournament()
   // show the tournament name in the main window's title
   updateWindowTitle();
 
+  if (nReplayed > 0)
+  {
+    msg = tr("The tournament has not been closed properly.\n\n");
+    msg += tr("All unsaved changes of the previous session have been restored.");
+    QMessageBox::information(this, tr("Restore unsaved changes"), msg);
+  }
+
   // open the external player database file, if configured
   PlayerMngr pm(currentDb.get());
   if (pm.hasExternalPlayerDatabaseConfigured())
@@ -319,12 +388,7 @@ void MainFrame::onSaveCopy()
   QString dstFileName = askForTournamentFileName(tr("Save a copy"));
   if (dstFileName.isEmpty()) return;
 
-  bool isOkay = saveCurrentDatabaseToFile(dstFileName);
-  if (isOkay)
-  {
-    lastAutosaveDirtyCounterValue = currentDb->getDirtyCounter();
-    onAutosaveTimerElapsed();
-  }
+  saveCurrentDatabaseToFile(dstFileName, PendingSave::Copy);
 }
 
 //----------------------------------------------------------------------------
@@ -334,36 +398,30 @@ void MainFrame::onCreateBaseline()
   if (currentDb == nullptr) return;
   if (currentDatabaseFileName.isEmpty()) return;
 
-  // determine the basename of the current database file
-  if (!(currentDatabaseFileName.endsWith(".tdb", Qt::CaseInsensitive)))
-  {
-    QString msg = tr("The current file name is unexpectedly ugly. Can't derive\n");
-    msg += tr("baseline names from it.\n\n");
-    msg += tr("Nothing has been saved.");
-    QMessageBox::warning(this, tr("Baseline creation failed"), msg);
-    return;
-  }
-  QString basename = currentDatabaseFileName.left(currentDatabaseFileName.length() - 4);
+  // all baselines of a tournament share one snapshot store
+  // next to the tournament file
+  SnapshotStore store{SnapshotStore::getStoreFileName(currentDatabaseFileName)};
+  ERR err = store.isValid() ? OK : DATABASE_ERROR;
 
-  // determine a suitable name for the baseline
-  QString dstName;
-  int cnt = 0;
-  bool nameFound = false;
-  while (!nameFound)
+  int snapId = -1;
+  if (err == OK)
   {
-    dstName = basename + "__%1.tdb";
-    dstName = dstName.arg(cnt, 4, 10, QLatin1Char{'0'});
-    nameFound = !(QFile::exists(dstName));
-    ++cnt;
+    QString label = QDateTime::currentDateTime().toString(Qt::ISODate);
+    err = currentDb->createSnapshot(store, label, &snapId);
   }
 
-  bool isOkay = saveCurrentDatabaseToFile(dstName);
-  if (isOkay)
+  if (err != OK)
   {
-    QString msg = tr("A snapshot of the current tournament status has been saved to:\n\n%1");
-    msg = msg.arg(dstName);
-    QMessageBox::information(this, "Create baseline", msg);
+    QString msg = tr("Could not store the baseline in:\n\n%1\n\n");
+    msg += tr("Nothing has been saved.");
+    msg = msg.arg(store.getFileName());
+    QMessageBox::warning(this, tr("Baseline creation failed"), msg);
+    return;
   }
+
+  QString msg = tr("A snapshot of the current tournament status has been saved as baseline #%1 in:\n\n%2");
+  msg = msg.arg(snapId).arg(store.getFileName());
+  QMessageBox::information(this, "Create baseline", msg);
 }
 
 //----------------------------------------------------------------------------
@@ -386,6 +444,8 @@ void MainFrame::enableControls(bool doEnable)
   ui.actionSave_as->setEnabled(doEnable);
   ui.actionSave_a_copy->setEnabled(doEnable);
   ui.actionCreate_baseline->setEnabled(doEnable && !(currentDatabaseFileName.isEmpty()));
+  ui.actionExport_all_reports->setEnabled(doEnable);
+  ui.actionLive_results_export->setEnabled(doEnable);
   ui.actionClose->setEnabled(doEnable);
 }
 
@@ -393,6 +453,16 @@ void MainFrame::enableControls(bool doEnable)
 
 bool MainFrame::closeCurrentTournament()
 {
+  // we can't close the database while matches
+  // are being generated in the background
+  if (CatInitWorker::isAnyWorkerRunning())
+  {
+    QString msg = tr("Matches are currently being generated.\n");
+    msg += tr("Please wait until the generation has finished or cancel it.");
+    QMessageBox::information(this, tr("Close tournament"), msg);
+    return false;
+  }
+
   // close other possibly open tournaments
   if (currentDb != nullptr)
   {
@@ -413,11 +483,17 @@ bool MainFrame::closeCurrentTournament()
 
       if (result == QMessageBox::Save)
       {
-        bool isOkay = execCmdSave();
+        // we have to wait for the background save here
+        // because we're about to close the database
+        bool isOkay = execCmdSave() && bgSaver->waitForFinished();
         if (!isOkay) return false;
       }
     }
 
+    // complete any other running save; a running
+    // autosave is not worth waiting for
+    settleBackgroundSave();
+
     //
     // At this point, the user either decided to discard all changes
     // or the database has been saved successfully
@@ -433,6 +509,14 @@ bool MainFrame::closeCurrentTournament()
     // BEFORE we actually close the database
     distributeCurrentDatabasePointerToWidgets(true);
 
+    // capture the query plans for the SQL profiler, if any,
+    // as long as the database is still available
+    currentDb->auditQueryPlans();
+
+    // at this point, all changes have either been saved or
+    // discarded, so we don't need the journal anymore
+    currentDb->stopChangeJournal(true);
+
     // close the database
     currentDb->close();
     currentDb.reset();
@@ -460,17 +544,46 @@ void MainFrame::distributeCurrentDatabasePointerToWidgets(bool forceNullptr)
 {
   TournamentDB* db = forceNullptr ? nullptr : currentDb.get();
 
-  ui.tabPlayers->setDatabase(db);
-  ui.tabCategories->setDatabase(db);
-  ui.tabTeams->setDatabase(db);
-  ui.tabSchedule->setDatabase(db);
-  ui.tabReports->setDatabase(db);
-  ui.tabMatchLog->setDatabase(db);
+  lazyTabInitTimer->stop();
+  pendingTabs = {
+    {ui.tabPlayers, "players", [this](TournamentDB* _db) { ui.tabPlayers->setDatabase(_db); }},
+    {ui.tabCategories, "categories", [this](TournamentDB* _db) { ui.tabCategories->setDatabase(_db); }},
+    {ui.tabTeams, "teams", [this](TournamentDB* _db) { ui.tabTeams->setDatabase(_db); }},
+    {ui.tabSchedule, "schedule", [this](TournamentDB* _db) { ui.tabSchedule->setDatabase(_db); }},
+    {ui.tabReports, "reports", [this](TournamentDB* _db) { ui.tabReports->setDatabase(_db); }},
+    {ui.tabMatchLog, "match log", [this](TournamentDB* _db) { ui.tabMatchLog->setDatabase(_db); }},
+  };
+
+  if (db == nullptr)
+  {
+    // releasing the database has to happen immediately
+    for (const PendingTab& pt : pendingTabs) pt.setDatabase(nullptr);
+    pendingTabs.clear();
+    startupClock.invalidate();
+  } else {
+    // the visible tab first, the rest later
+    initPendingTab(ui.mainTab->currentWidget());
+    lazyTabInitTimer->start(LAZY_TAB_INIT_INTERVALL__MS);
+  }
+
+  // the background saver is bound to a specific database
+  bgSaver.reset();
+  pendingSave = PendingSave::None;
+  if (db != nullptr)
+  {
+    bgSaver = make_unique<BackgroundSaver>(db);
+    connect(bgSaver.get(), SIGNAL(progressChanged(int)), this, SLOT(onBackgroundSaveProgress(int)));
+    connect(bgSaver.get(), SIGNAL(finished(bool,int)), this, SLOT(onBackgroundSaveFinished(bool,int)));
+  }
+
+  // a new tournament always stops the live results export
+  liveResultsExporter->setDatabase(db);
+  ui.actionLive_results_export->setChecked(liveResultsExporter->isActive());
 }
 
 //----------------------------------------------------------------------------
 
-bool MainFrame::saveCurrentDatabaseToFile(const QString& dstFileName)
+bool MainFrame::saveCurrentDatabaseToFile(const QString& dstFileName, PendingSave kind)
 {
   // Precondition:
   // All checks for valid filenames, overwriting of files etc. have to
@@ -478,16 +591,64 @@ bool MainFrame::saveCurrentDatabaseToFile(const QString& dstFileName)
   //
   // This function unconditionally writes to the destination file, whether
   // it exists or not.
+  //
+  // The function only starts the save; the follow-up actions are
+  // executed in onBackgroundSaveFinished()
 
   if (currentDb == nullptr) return false;
 
-  // write the database to the file
+  // the content is going to be replaced by the result of
+  // a background operation; the autosave tries again later
+  if (currentDb->isWriteLocked())
+  {
+    if (kind != PendingSave::Autosave)
+    {
+      QString msg = tr("Matches are currently being generated.\n");
+      msg += tr("Please wait until the generation has finished or cancel it.");
+      QMessageBox::information(this, tr("Save tournament"), msg);
+    }
+    return false;
+  }
+
+  // only one save at a time
+  settleBackgroundSave();
+
   int dbErr;
-  bool isOkay = currentDb->backupToFile(dstFileName.toUtf8().constData(), &dbErr);
+  ERR err = bgSaver->start(dstFileName, &dbErr);
+  if (err != OK)
+  {
+    showSaveError(dstFileName, dbErr);
+    return false;
+  }
 
-  // handle erros
+  pendingSave = kind;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+
+void MainFrame::settleBackgroundSave()
+{
+  if ((bgSaver == nullptr) || !(bgSaver->isRunning())) return;
+
+  // the next autosave will come anyway; all other
+  // saves have been explicitly requested by the user
+  if (pendingSave == PendingSave::Autosave)
+  {
+    bgSaver->cancel();
+    pendingSave = PendingSave::None;
+    saveProgressBar->hide();
+  } else {
+    bgSaver->waitForFinished();
+  }
+}
+
+//----------------------------------------------------------------------------
+
+void MainFrame::showSaveError(const QString& dstFileName, int dbErr)
+{
   QString msg;
-  if (dbErr == SQLITE_ERROR)
+  if ((dbErr == SQLITE_ERROR) || (dbErr == SQLITE_CANTOPEN) || (dbErr == SQLITE_IOERR))
   {
     msg = tr("Could not write to the destination file:\n\n");
     msg += dstFileName + "\n\n";
@@ -503,8 +664,6 @@ bool MainFrame::saveCurrentDatabaseToFile(const QString& dstFileName)
   {
     QMessageBox::warning(this, tr("Saving failed"), msg);
   }
-
-  return isOkay;
 }
 
 //----------------------------------------------------------------------------
@@ -518,17 +677,7 @@ bool MainFrame::execCmdSave()
     return execCmdSaveAs();
   }
 
-  bool isOkay = saveCurrentDatabaseToFile(currentDatabaseFileName);
-  if (isOkay)
-  {
-    currentDb->resetDirtyFlag();
-
-    // reset the autosave state machine and status indication
-    lastAutosaveDirtyCounterValue = currentDb->getDirtyCounter();
-    onAutosaveTimerElapsed();
-  }
-
-  return isOkay;
+  return saveCurrentDatabaseToFile(currentDatabaseFileName, PendingSave::Save);
 }
 
 //----------------------------------------------------------------------------
@@ -540,23 +689,26 @@ bool MainFrame::execCmdSaveAs()
   QString dstFileName = askForTournamentFileName(tr("Save tournament as"));
   if (dstFileName.isEmpty()) return false;  // user abort counts as "failed"
 
-  bool isOkay = saveCurrentDatabaseToFile(dstFileName);
+  return saveCurrentDatabaseToFile(dstFileName, PendingSave::SaveAs);
+}
 
-  if (isOkay)
-  {
-    currentDb->resetDirtyFlag();
-    currentDatabaseFileName = dstFileName;
-    ui.actionCreate_baseline->setEnabled(true);
+//----------------------------------------------------------------------------
 
-    // reset the autosave state machine and status indication
-    lastAutosaveDirtyCounterValue = currentDb->getDirtyCounter();
-    onAutosaveTimerElapsed();
+void MainFrame::startChangeJournal(bool isFreshSave)
+{
+  if ((currentDb == nullptr) || currentDatabaseFileName.isEmpty()) return;
 
-    // show the file name in the window title
-    updateWindowTitle();
+  QString journalFileName = ChangeJournal::getJournalFileName(currentDatabaseFileName);
+  if (!(currentDb->startChangeJournal(journalFileName)))
+  {
+    // we can live without the journal; the autosave
+    // falls back to full copies of the database
+    return;
   }
 
-  return isOkay;
+  // a fresh save contains all changes, so
+  // we don't need the content of any stale journal
+  if (isFreshSave) currentDb->getChangeJournal()->clear();
 }
 
 //----------------------------------------------------------------------------
@@ -1188,6 +1340,9 @@ void MainFrame::onCurrentTabChanged(int newCurrentTab)
   auto selectedTabWidget = ui.mainTab->currentWidget();
   if (selectedTabWidget == nullptr) return;
 
+  // maybe the tab hasn't been initialized yet
+  initPendingTab(selectedTabWidget);
+
   // check if the new tab is the reports tab
   if (selectedTabWidget == ui.tabReports)
   {
@@ -1371,6 +1526,59 @@ void MainFrame::onEditTournamentSettings()
 
 //----------------------------------------------------------------------------
 
+void MainFrame::onExportAllReports()
+{
+  if (currentDb == nullptr) return;
+
+  QString outDir = QFileDialog::getExistingDirectory(this, tr("Select a directory for the reports"));
+  if (outDir.isEmpty()) return;
+
+  auto exporter = make_unique<BatchReportExporter>(currentDb.get(), outDir);
+  ERR err = exporter->start();
+  if (err != OK)
+  {
+    QString msg = tr("The export could not be started.\n\n");
+    msg += (err == FILE_NOT_EXISTING) ? tr("The directory could not be created.") : tr("An internal error occured.");
+    QMessageBox::warning(this, tr("Export all reports"), msg);
+    return;
+  }
+
+  // the dialog takes care of the exporter and deletes itself
+  DlgBatchReportExport* dlg = new DlgBatchReportExport(this, std::move(exporter), outDir);
+  dlg->show();
+}
+
+//----------------------------------------------------------------------------
+
+void MainFrame::onToggleLiveResultsExport()
+{
+  if (liveResultsExporter->isActive())
+  {
+    liveResultsExporter->stop();
+    ui.actionLive_results_export->setChecked(false);
+    return;
+  }
+
+  ui.actionLive_results_export->setChecked(false);
+  if (currentDb == nullptr) return;
+
+  QString outDir = QFileDialog::getExistingDirectory(this, tr("Select a directory for the live results"));
+  if (outDir.isEmpty()) return;
+
+  ERR err = liveResultsExporter->start(outDir);
+  if (err != OK)
+  {
+    QString msg = tr("The live results export could not be started.\n\n");
+    msg += (err == FILE_NOT_EXISTING) ? tr("The directory could not be created.") : tr("An internal error occured.");
+    QMessageBox::warning(this, tr("Live results export"), msg);
+    return;
+  }
+
+  ui.actionLive_results_export->setChecked(true);
+}
+
+//----------------------------------------------------------------------------
+
 void MainFrame::onToggleTestMenuVisibility()
 {
   ui.menubar->clear();
@@ -1387,7 +1595,14 @@ void MainFrame::onToggleTestMenuVisibility()
 
 //----------------------------------------------------------------------------
 
-void MainFrame::onDirtyFlagPollTimerElapsed()
+void MainFrame::onRowChangesCommitted(const RowChangeSet& changes)
+{
+  updateDirtyState();
+}
+
+//----------------------------------------------------------------------------
+
+void MainFrame::updateDirtyState()
 {
   if (currentDb == nullptr) return;
 
@@ -1421,11 +1636,28 @@ void MainFrame::onAutosaveTimerElapsed()
     return;
   }
 
+  // wait for the result of a running background operation
+  if (currentDb->isWriteLocked()) return;
+
   // do we need an autosave?
   if (currentDb->getDirtyCounter() != lastAutosaveDirtyCounterValue)
   {
-    QString fname = currentDatabaseFileName + ".autosave";
-    bool isOkay = saveCurrentDatabaseToFile(fname);
+    bool isOkay;
+    ChangeJournal* cj = currentDb->getChangeJournal();
+    if (cj != nullptr)
+    {
+      // all committed changes are already in the journal, so
+      // we only have to keep the journal small
+      ERR err = cj->needsCompaction() ? cj->compact() : cj->flush();
+      isOkay = (err == OK);
+    } else {
+      // fallback: a full copy of the database. The status
+      // is updated when the background save has finished
+      if (bgSaver->isRunning()) return;
+      QString fname = currentDatabaseFileName + ".autosave";
+      isOkay = saveCurrentDatabaseToFile(fname, PendingSave::Autosave);
+      if (isOkay) return;
+    }
 
     if (isOkay)
     {
@@ -1515,4 +1747,124 @@ void MainFrame::onAutosaveTimerElapsed()
 
 //----------------------------------------------------------------------------
 
+void MainFrame::onBackgroundSaveProgress(int percent)
+{
+  saveProgressBar->setValue(percent);
+  saveProgressBar->show();
+}
+
+//----------------------------------------------------------------------------
+
+void MainFrame::onBackgroundSaveFinished(bool isOkay, int dbErr)
+{
+  saveProgressBar->hide();
+
+  PendingSave kind = pendingSave;
+  pendingSave = PendingSave::None;
+  if (currentDb == nullptr) return;
+
+  QString dstFileName = bgSaver->getDstFileName();
+  if (!isOkay)
+  {
+    showSaveError(dstFileName, dbErr);
+    if (kind == PendingSave::Autosave)
+    {
+      lastAutosaveTimeStatusLabel->setText(tr("Last autosave: ") + tr("failed"));
+    }
+    return;
+  }
+
+  // the copy includes all changes up to this point,
+  // even those that have been made while saving
+  switch (kind)
+  {
+  case PendingSave::Save:
+    currentDb->resetDirtyFlag();
+    updateDirtyState();
+
+    // all changes are contained in the file now
+    if (currentDb->getChangeJournal() != nullptr)
+    {
+      currentDb->getChangeJournal()->clear();
+    } else {
+      startChangeJournal(true);
+    }
+    break;
+
+  case PendingSave::SaveAs:
+    currentDb->resetDirtyFlag();
+    lastDirtyState = false;
+    currentDatabaseFileName = dstFileName;
+    ui.actionCreate_baseline->setEnabled(true);
+
+    // the journal of the old file stays valid for the old file;
+    // the new file starts with an empty journal
+    currentDb->stopChangeJournal(false);
+    startChangeJournal(true);
+
+    // show the file name in the window title
+    updateWindowTitle();
+    break;
+
+  case PendingSave::Autosave:
+    lastAutosaveTimeStatusLabel->setText(tr("Last autosave: ") + QTime::currentTime().toString("HH:mm:ss"));
+    lastAutosaveDirtyCounterValue = currentDb->getDirtyCounter();
+    return;
+
+  default:
+    break;
+  }
+
+  // reset the autosave state machine and status indication
+  lastAutosaveDirtyCounterValue = currentDb->getDirtyCounter();
+  onAutosaveTimerElapsed();
+}
+
+//----------------------------------------------------------------------------
+
+void MainFrame::initPendingTab(QWidget* tab)
+{
+  auto it = std::find_if(pendingTabs.begin(), pendingTabs.end(), [tab](const PendingTab& pt) {
+    return (pt.tab == tab);
+  });
+  if (it == pendingTabs.end()) return;
+
+  // remove the tab from the list before initializing it
+  // in case the initialization triggers a tab change
+  PendingTab pt = *it;
+  pendingTabs.erase(it);
+
+  QElapsedTimer clock;
+  clock.start();
+  pt.setDatabase(currentDb.get());
+  logStartupStage(QString("%1 tab initialized in %2 ms").arg(pt.name).arg(clock.elapsed()));
+}
+
+//----------------------------------------------------------------------------
+
+void MainFrame::logStartupStage(const QString& stage)
+{
+  // only log if we're in the process of opening a tournament
+  if (!(startupClock.isValid())) return;
+
+  qDebug().noquote() << QString("Startup: %1 (%2 ms)").arg(stage).arg(startupClock.elapsed());
+}
+
+//----------------------------------------------------------------------------
+
+void MainFrame::onLazyTabInitTimerElapsed()
+{
+  if (pendingTabs.empty() || (currentDb == nullptr))
+  {
+    lazyTabInitTimer->stop();
+    pendingTabs.clear();
+    logStartupStage("all tabs ready");
+    startupClock.invalidate();
+    return;
+  }
 
+  // one tab per slice, so that the event loop stays responsive
+  initPendingTab(pendingTabs.front().tab);
+}
+
+//----------------------------------------------------------------------------
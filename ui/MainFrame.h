@@ -20,12 +20,18 @@
 #define	_MAINFRAME_H
 
 #include <memory>
+#include <functional>
+#include <vector>
 
 #include <QShortcut>
 #include <QCloseEvent>
 #include <QTimer>
+#include <QProgressBar>
+#include <QElapsedTimer>
 
 #include "ui_MainFrame.h"
+#include "reports/LiveResultsExporter.h"
+#include "BackgroundSaver.h"
 
 #define PRG_VERSION_STRING "0.5.0"
 
@@ -58,18 +64,50 @@ private:
   bool isTestMenuVisible;
 
   void distributeCurrentDatabasePointerToWidgets(bool forceNullptr = false);
-  bool saveCurrentDatabaseToFile(const QString& dstFileName);
+
+  // staged startup: only the visible tab receives the database
+  // immediately; all other tabs are initialized on their first
+  // view or, one tab per timer slice, in idle time
+  struct PendingTab
+  {
+    QWidget* tab;
+    const char* name;
+    std::function<void(TournamentDB*)> setDatabase;
+  };
+  static constexpr int LAZY_TAB_INIT_INTERVALL__MS = 50;
+  vector<PendingTab> pendingTabs;
+  unique_ptr<QTimer> lazyTabInitTimer;
+  QElapsedTimer startupClock;
+  void initPendingTab(QWidget* tab);
+  void logStartupStage(const QString& stage);
+
+  // saving is done in the background; the follow-up actions
+  // depend on the kind of the save that has been started
+  enum class PendingSave
+  {
+    None,
+    Save,
+    SaveAs,
+    Copy,
+    Autosave
+  };
+  unique_ptr<BackgroundSaver> bgSaver;
+  PendingSave pendingSave;
+  QProgressBar* saveProgressBar;
+  bool saveCurrentDatabaseToFile(const QString& dstFileName, PendingSave kind);
+  void settleBackgroundSave();
+  void showSaveError(const QString& dstFileName, int dbErr);
   bool execCmdSave();
   bool execCmdSaveAs();
   QString askForTournamentFileName(const QString& dlgTitle);
+  void startChangeJournal(bool isFreshSave);
 
   void updateWindowTitle();
+  void updateDirtyState();
 
-  // timers for polling the database's dirty flag
-  // and triggering the autosave function
-  static constexpr int DIRTY_FLAG_POLL_INTERVALL__MS = 1000;
+  // the dirty state is updated after each commit;
+  // a timer triggers the autosave function
   static constexpr int AUTOSAVE_INTERVALL__MS = 120000;
-  unique_ptr<QTimer> dirtyFlagPollTimer;
   unique_ptr<QTimer> autosaveTimer;
   bool lastDirtyState;
   int lastAutosaveDirtyCounterValue;
@@ -77,6 +115,9 @@ private:
   // a label for the status bar that shows the last autosave
   QLabel* lastAutosaveTimeStatusLabel;
 
+  // optional export of HTML pages with live results
+  unique_ptr<LiveResultsExporter> liveResultsExporter;
+
 
 public slots:
   void newTournament();
@@ -100,11 +141,16 @@ public slots:
   void onSelectExternalPlayerDatabase();
   void onInfoMenuTriggered();
   void onEditTournamentSettings();
+  void onExportAllReports();
+  void onToggleLiveResultsExport();
 
 private slots:
   void onToggleTestMenuVisibility();
-  void onDirtyFlagPollTimerElapsed();
+  void onRowChangesCommitted(const RowChangeSet& changes);
   void onAutosaveTimerElapsed();
+  void onBackgroundSaveProgress(int percent);
+  void onBackgroundSaveFinished(bool isOkay, int dbErr);
+  void onLazyTabInitTimerElapsed();
 
 };
 
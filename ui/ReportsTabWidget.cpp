@@ -28,10 +28,13 @@
 
 ReportsTabWidget::ReportsTabWidget(QWidget *parent) :
   QWidget(parent), db(nullptr),
-  ui(new Ui::ReportsTabWidget), treeRoot(nullptr), isInResetProcedure(false)
+  ui(new Ui::ReportsTabWidget), treeRoot(nullptr), isInResetProcedure(false), curRequestId(0)
 {
   ui->setupUi(this);
 
+  // reports are generated in the background
+  connect(&repGenerator, SIGNAL(reportReady(int)), this, SLOT(onReportReady(int)));
+
   // react to model reset requests
   CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
   connect(cse, SIGNAL(endResetAllModels()), this, SLOT(onResetRequested()), Qt::DirectConnection);
@@ -150,6 +153,13 @@ void ReportsTabWidget::createRootItem()
   // delete all old reports
   repPool.clear();
 
+  // forget about reports that are still being generated
+  // and about all reports of the previous database
+  repGenerator.cancelAll();
+  ReportFactory::clearReportCache();
+  curRequestId = 0;
+  unsetCursor();
+
   // delete the currently displayed report
   curReport = nullptr;   // this calls the destructor of the old report
   ui->repViewer->setReport(nullptr);
@@ -178,25 +188,52 @@ void ReportsTabWidget::onTreeSelectionChanged()
 
 void ReportsTabWidget::showReport(const QString& repName)
 {
-  for_each(repPool.cbegin(), repPool.cend(), [&](const upAbstractReport& rep)
+  auto it = find_if(repPool.cbegin(), repPool.cend(), [&](const upAbstractReport& rep)
   {
-    if (rep->getName() == repName)
-    {
-      upSimpleReport newReport = rep->regenerateReport();
-      if (newReport == nullptr) return;
-
-      // store the newly created report in our own unique_ptr.
-      // The old report will be automatically deleted
-      //
-      // if we don't store the new report in curReport,
-      // it would be automatically deleted when we leave
-      // this code block
-      curReport = std::move(newReport);
-      SimpleReportLib::SimpleReportGenerator* rawPointer = curReport.get();
-      ui->repViewer->setReport(rawPointer);
-      return;
-    }
+    return (rep->getName() == repName);
   });
+  if (it == repPool.cend()) return;
+
+  // show the report immediately if the data hasn't
+  // changed since the report has been generated
+  spSimpleReport cachedReport = ReportFactory::getCachedReport(repName, (*it)->getDataVersion());
+  if (cachedReport != nullptr)
+  {
+    repGenerator.cancelAll();
+    curRequestId = 0;
+    unsetCursor();
+
+    curReport = cachedReport;
+    ui->repViewer->setReport(curReport.get());
+    return;
+  }
+
+  // the report is generated in the background on a
+  // snapshot of the database. The currently displayed
+  // report remains visible until the new one is ready.
+  //
+  // a new request makes all previous requests obsolete
+  curRequestId = repGenerator.requestReport(db, repName);
+  setCursor(Qt::BusyCursor);
+}
+
+//----------------------------------------------------------------------------
+
+void ReportsTabWidget::onReportReady(int requestId)
+{
+  if (requestId != curRequestId) return;
+
+  unsetCursor();
+
+  spSimpleReport newReport = repGenerator.takeReport(requestId);
+  if (newReport == nullptr) return;
+
+  // store the newly created report in our own shared_ptr.
+  // The old report will be automatically deleted unless
+  // it's still in the report cache
+  curReport = newReport;
+  SimpleReportLib::SimpleReportGenerator* rawPointer = curReport.get();
+  ui->repViewer->setReport(rawPointer);
 }
 
 //----------------------------------------------------------------------------
@@ -27,6 +27,7 @@
 
 #include "reports/ReportFactory.h"
 #include "reports/AbstractReport.h"
+#include "reports/AsyncReportGenerator.h"
 #include "TournamentDB.h"
 
 namespace Ui {
@@ -55,6 +56,9 @@ public slots:
   void onReloadRequested();
   void onResetRequested();
 
+private slots:
+  void onReportReady(int requestId);
+
 private:
   TournamentDB* db;
   Ui::ReportsTabWidget *ui;
@@ -65,8 +69,10 @@ private:
   QTreeWidgetItem* findTreeItemChildByName(QTreeWidgetItem* _parent, const QString& childName) const;
   void createRootItem();
   void showReport(const QString& repName);
-  upSimpleReport curReport;
+  spSimpleReport curReport;
   bool isInResetProcedure;
+  AsyncReportGenerator repGenerator;
+  int curRequestId;
 };
 
 #endif // REPORTSTABWIDGET_H
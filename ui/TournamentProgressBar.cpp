@@ -20,15 +20,27 @@ TournamentProgressBar::TournamentProgressBar(QWidget* parentWidget)
   // start with an empty database
   setDatabase(nullptr);
 
-  // set up a timer that polls the match stats once a second
-  // and updates the status bar accordingly
-  statPollTimer = make_unique<QTimer>();
-  connect(statPollTimer.get(), SIGNAL(timeout()), this, SLOT(updateProgressBar()));
-  statPollTimer->start(STAT_POLL_TIMER_INTERVAL__MS);
+  // the match counters are updated by events (see below), so
+  // we only need a slow timer for the remaining time
+  remainingTimeTimer = make_unique<QTimer>();
+  connect(remainingTimeTimer.get(), SIGNAL(timeout()), this, SLOT(updateProgressBar()));
+  remainingTimeTimer->start(REMAINING_TIME_TIMER_INTERVAL__MS);
+
+  // match state changes usually come in bursts (e.g., when
+  // scheduling a whole round). We collect them and update the
+  // progress bar only once when we're back in the event loop
+  deferredUpdateTimer = make_unique<QTimer>();
+  deferredUpdateTimer->setSingleShot(true);
+  deferredUpdateTimer->setInterval(0);
+  connect(deferredUpdateTimer.get(), SIGNAL(timeout()), this, SLOT(updateProgressBar()));
 
   // connect to match time prediction updates and match count updates
   CentralSignalEmitter* cse = CentralSignalEmitter::getInstance();
   connect(cse, SIGNAL(matchTimePredictionChanged(int,time_t)), this, SLOT(onMatchTimePredictionChanged(int,time_t)));
+  connect(cse, SIGNAL(matchStatusChanged(int,int,OBJ_STATE,OBJ_STATE)), this, SLOT(onMatchCountersChanged()));
+  connect(cse, SIGNAL(endCreateMatch(int)), this, SLOT(onMatchCountersChanged()));
+  connect(cse, SIGNAL(endDeleteCategory()), this, SLOT(onMatchCountersChanged()));
+  connect(cse, SIGNAL(endResetAllModels()), this, SLOT(onMatchCountersChanged()));
 }
 
 //----------------------------------------------------------------------------
@@ -61,7 +73,8 @@ void TournamentProgressBar::updateProgressBar()
 {
   if (db == nullptr) return;
 
-  // get updated match status counters
+  // get updated match status counters; they come
+  // from an in-memory cache and are thus cheap
   MatchMngr mm{db};
   int nTotal;
   int nScheduled;
@@ -113,3 +126,14 @@ void TournamentProgressBar::onMatchTimePredictionChanged(int newAvgMatchDuration
   lastMatchFinishTime__UTC = newLastMatchFinish;
   updateProgressBar();
 }
+
+//----------------------------------------------------------------------------
+
+void TournamentProgressBar::onMatchCountersChanged()
+{
+  if (db == nullptr) return;
+
+  // (re-)start the timer; it fires only once after
+  // all pending events have been processed
+  deferredUpdateTimer->start();
+}
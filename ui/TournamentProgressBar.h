@@ -21,14 +21,16 @@ public:
 public slots:
   void updateProgressBar();
   void onMatchTimePredictionChanged(int newAvgMatchDuration, time_t newLastMatchFinish);
+  void onMatchCountersChanged();
 
 private:
-  static constexpr int STAT_POLL_TIMER_INTERVAL__MS = 1000;  // update once a second
+  static constexpr int REMAINING_TIME_TIMER_INTERVAL__MS = 30000;  // only the remaining time depends on the clock
   TournamentDB* db;
   QString rawStatusString;
   time_t lastMatchFinishTime__UTC;
   int avgMatchDuration__secs;
-  unique_ptr<QTimer> statPollTimer;
+  unique_ptr<QTimer> remainingTimeTimer;
+  unique_ptr<QTimer> deferredUpdateTimer;
 };
 
 #endif // TOURNAMENTPROGRESSBAR_H
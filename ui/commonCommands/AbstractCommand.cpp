@@ -16,10 +16,43 @@
  *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QObject>
+#include <QMessageBox>
+
 #include "AbstractCommand.h"
+#include "ui/EventLoopWatchdog.h"
 
 AbstractCommand::AbstractCommand(TournamentDB* _db, QWidget* _parent)
   :db(_db), parentWidget(_parent)
 {
 
 }
+
+//----------------------------------------------------------------------------
+
+ERR AbstractCommand::exec()
+{
+  // all modifications would be lost when the running
+  // background operation replaces the database content
+  if (db->isWriteLocked())
+  {
+    QString msg = QObject::tr("Matches are currently being generated.\n");
+    msg += QObject::tr("Please wait until the generation has finished or cancel it.");
+    QMessageBox::information(parentWidget, QObject::tr("Database locked"), msg);
+    return DATABASE_LOCKED;
+  }
+
+  if (!(EventLoopWatchdog::isActiveInCurrentThread())) return doExec();
+
+  // all commands are QObjects, so we can label
+  // the trace with the name of the actual command
+  QString label = "AbstractCommand::exec";
+  const QObject* obj = dynamic_cast<const QObject*>(this);
+  if (obj != nullptr)
+  {
+    label = QString("%1::exec").arg(obj->metaObject()->className());
+  }
+
+  HandlerTrace ht{label};
+  return doExec();
+}
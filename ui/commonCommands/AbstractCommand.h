@@ -31,12 +31,18 @@ class AbstractCommand
 
 public:
   AbstractCommand(TournamentDB* _db, QWidget* _parent = nullptr);
-  virtual ERR exec() = 0;
   virtual ~AbstractCommand() {}
 
+  // runs the command and marks its execution for
+  // the event loop watchdog (see HandlerTrace); refuses
+  // to run while the database is write locked
+  ERR exec();
+
 protected:
   TournamentDB* db;
   QWidget* parentWidget;
+
+  virtual ERR doExec() = 0;
 };
 
 #endif
@@ -35,7 +35,7 @@ cmdAssignRefereeToMatch::cmdAssignRefereeToMatch(QWidget* p, const QTournament::
 
 //----------------------------------------------------------------------------
 
-ERR cmdAssignRefereeToMatch::exec()
+ERR cmdAssignRefereeToMatch::doExec()
 {
   // do we actually need to assign an umpire?
   REFEREE_MODE refMode = (refAction == REFEREE_ACTION::SWAP) ? ma.get_RAW_RefereeMode() : ma.get_EFFECTIVE_RefereeMode();
@@ -26,16 +26,17 @@
 
 using namespace QTournament;
 
-class cmdAssignRefereeToMatch : public QObject, AbstractCommand
+class cmdAssignRefereeToMatch : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdAssignRefereeToMatch(QWidget* p, const Match& _ma, REFEREE_ACTION _refAction);
-  virtual ERR exec() override;
   virtual ~cmdAssignRefereeToMatch() {}
 
 protected:
+  virtual ERR doExec() override;
+
   Match ma;
   REFEREE_ACTION refAction;
 };
@@ -31,7 +31,7 @@ cmdBulkAddPlayerToCategory::cmdBulkAddPlayerToCategory(QWidget* p, const Categor
 
 //----------------------------------------------------------------------------
 
-ERR cmdBulkAddPlayerToCategory::exec()
+ERR cmdBulkAddPlayerToCategory::doExec()
 {
   // check if can add more players anyway
   if (!(cat.canAddPlayers()))
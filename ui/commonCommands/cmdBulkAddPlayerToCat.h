@@ -26,16 +26,17 @@
 
 using namespace QTournament;
 
-class cmdBulkAddPlayerToCategory : public QObject, AbstractCommand
+class cmdBulkAddPlayerToCategory : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdBulkAddPlayerToCategory(QWidget* p, const Category& _cat);
-  virtual ERR exec() override;
   virtual ~cmdBulkAddPlayerToCategory() {}
 
 protected:
+  virtual ERR doExec() override;
+
   Category cat;
 };
 
@@ -31,7 +31,7 @@ cmdBulkRemovePlayersFromCategory::cmdBulkRemovePlayersFromCategory(QWidget* p, c
 
 //----------------------------------------------------------------------------
 
-ERR cmdBulkRemovePlayersFromCategory::exec()
+ERR cmdBulkRemovePlayersFromCategory::doExec()
 {
   // show a dialog for selecting the players
   DlgSelectPlayer dlg{db, parentWidget, DlgSelectPlayer::DLG_CONTEXT::REMOVE_FROM_CATEGORY, &cat};
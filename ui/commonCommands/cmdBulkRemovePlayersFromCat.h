@@ -26,15 +26,16 @@
 
 using namespace QTournament;
 
-class cmdBulkRemovePlayersFromCategory : public QObject, AbstractCommand
+class cmdBulkRemovePlayersFromCategory : public QObject, public AbstractCommand
 {
   Q_OBJECT
 public:
   cmdBulkRemovePlayersFromCategory(QWidget* p, const Category& _cat);
-  virtual ERR exec() override;
   virtual ~cmdBulkRemovePlayersFromCategory() {}
 
 protected:
+  virtual ERR doExec() override;
+
   Category cat;
 };
 
@@ -36,7 +36,7 @@ cmdCallMatch::cmdCallMatch(QWidget* p, const QTournament::Match &_ma, const Cour
 
 //----------------------------------------------------------------------------
 
-ERR cmdCallMatch::exec()
+ERR cmdCallMatch::doExec()
 {
   MatchMngr mm{db};
 
@@ -27,16 +27,17 @@
 
 using namespace QTournament;
 
-class cmdCallMatch : public QObject, AbstractCommand
+class cmdCallMatch : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdCallMatch(QWidget* p, const Match& _ma, const Court& _co);
-  virtual ERR exec() override;
   virtual ~cmdCallMatch() {}
 
 protected:
+  virtual ERR doExec() override;
+
   Match ma;
   Court co;
 };
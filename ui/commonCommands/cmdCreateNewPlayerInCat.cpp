@@ -33,7 +33,7 @@ cmdCreateNewPlayerInCat::cmdCreateNewPlayerInCat(QWidget* p, const Category& _ca
 
 //----------------------------------------------------------------------------
 
-ERR cmdCreateNewPlayerInCat::exec()
+ERR cmdCreateNewPlayerInCat::doExec()
 {
   // check if can add more players anyway
   if (!(cat.canAddPlayers()))
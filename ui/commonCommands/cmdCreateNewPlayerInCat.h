@@ -26,16 +26,17 @@
 
 using namespace QTournament;
 
-class cmdCreateNewPlayerInCat : public QObject, AbstractCommand
+class cmdCreateNewPlayerInCat : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdCreateNewPlayerInCat(QWidget* p, const Category& _cat);
-  virtual ERR exec() override;
   virtual ~cmdCreateNewPlayerInCat() {}
 
 protected:
+  virtual ERR doExec() override;
+
   Category cat;
 };
 
@@ -31,7 +31,7 @@ cmdCreatePlayerFromDialog::cmdCreatePlayerFromDialog(TournamentDB* _db, QWidget*
 
 //----------------------------------------------------------------------------
 
-ERR cmdCreatePlayerFromDialog::exec()
+ERR cmdCreatePlayerFromDialog::doExec()
 {
   if (dlg->exec() != QDialog::Accepted)
   {
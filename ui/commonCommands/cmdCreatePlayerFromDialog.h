@@ -27,16 +27,17 @@
 
 using namespace QTournament;
 
-class cmdCreatePlayerFromDialog : public QObject, AbstractCommand
+class cmdCreatePlayerFromDialog : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdCreatePlayerFromDialog(TournamentDB* _db, QWidget* p, DlgEditPlayer* initializedDialog);
-  virtual ERR exec() override;
   virtual ~cmdCreatePlayerFromDialog() {}
 
 protected:
+  virtual ERR doExec() override;
+
   DlgEditPlayer* dlg;
 };
 
@@ -30,7 +30,7 @@ cmdExportPlayerToExternalDatabase::cmdExportPlayerToExternalDatabase(QWidget* p,
 
 //----------------------------------------------------------------------------
 
-ERR cmdExportPlayerToExternalDatabase::exec()
+ERR cmdExportPlayerToExternalDatabase::doExec()
 {
   // make sure we have an external database open
   PlayerMngr pm{db};
@@ -26,16 +26,17 @@
 
 using namespace QTournament;
 
-class cmdExportPlayerToExternalDatabase : public QObject, AbstractCommand
+class cmdExportPlayerToExternalDatabase : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdExportPlayerToExternalDatabase(QWidget* p, const Player& _pl);
-  virtual ERR exec() override;
   virtual ~cmdExportPlayerToExternalDatabase() {}
 
 protected:
+  virtual ERR doExec() override;
+
   Player pl;
 };
 
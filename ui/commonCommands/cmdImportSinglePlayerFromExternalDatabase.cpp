@@ -35,7 +35,7 @@ cmdImportSinglePlayerFromExternalDatabase::cmdImportSinglePlayerFromExternalData
 
 //----------------------------------------------------------------------------
 
-ERR cmdImportSinglePlayerFromExternalDatabase::exec()
+ERR cmdImportSinglePlayerFromExternalDatabase::doExec()
 {
   // make sure we have an external database open
   PlayerMngr pm{db};
@@ -26,16 +26,17 @@
 
 using namespace QTournament;
 
-class cmdImportSinglePlayerFromExternalDatabase : public QObject, AbstractCommand
+class cmdImportSinglePlayerFromExternalDatabase : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdImportSinglePlayerFromExternalDatabase(TournamentDB* _db, QWidget* p, int _preselectedCatId=-1);
-  virtual ERR exec() override;
   virtual ~cmdImportSinglePlayerFromExternalDatabase() {}
 
 protected:
+  virtual ERR doExec() override;
+
   int preselectedCatId;
 };
 
@@ -32,7 +32,7 @@ cmdMoveOrCopyPairToCategory::cmdMoveOrCopyPairToCategory(QWidget* p, const Playe
 
 //----------------------------------------------------------------------------
 
-ERR cmdMoveOrCopyPairToCategory::exec()
+ERR cmdMoveOrCopyPairToCategory::doExec()
 {
   CatMngr cm{db};
 
@@ -27,16 +27,17 @@
 
 using namespace QTournament;
 
-class cmdMoveOrCopyPairToCategory : public QObject, AbstractCommand
+class cmdMoveOrCopyPairToCategory : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdMoveOrCopyPairToCategory(QWidget* p, const PlayerPair& _pp, const Category& _srcCat, const Category& _dstCat, bool _isMove=false);
-  virtual ERR exec() override;
   virtual ~cmdMoveOrCopyPairToCategory() {}
 
 protected:
+  virtual ERR doExec() override;
+
   PlayerPair pp;
   Category srcCat;
   Category dstCat;
@@ -31,7 +31,7 @@ cmdMoveOrCopyPlayerToCategory::cmdMoveOrCopyPlayerToCategory(QWidget* p, const P
 
 //----------------------------------------------------------------------------
 
-ERR cmdMoveOrCopyPlayerToCategory::exec()
+ERR cmdMoveOrCopyPlayerToCategory::doExec()
 {
   CatMngr cm{db};
 
@@ -27,16 +27,17 @@
 
 using namespace QTournament;
 
-class cmdMoveOrCopyPlayerToCategory : public QObject, AbstractCommand
+class cmdMoveOrCopyPlayerToCategory : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdMoveOrCopyPlayerToCategory(QWidget* p, const Player& _pl, const Category& _srcCat, const Category& _dstCat, bool _isMove=false);
-  virtual ERR exec() override;
   virtual ~cmdMoveOrCopyPlayerToCategory() {}
 
 protected:
+  virtual ERR doExec() override;
+
   Player pl;
   Category srcCat;
   Category dstCat;
@@ -30,7 +30,7 @@ cmdRegisterPlayer::cmdRegisterPlayer(QWidget* p, const Player& _pl)
 
 //----------------------------------------------------------------------------
 
-ERR cmdRegisterPlayer::exec()
+ERR cmdRegisterPlayer::doExec()
 {
   ERR err;
   PlayerMngr pm{db};
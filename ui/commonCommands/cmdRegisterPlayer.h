@@ -26,16 +26,17 @@
 
 using namespace QTournament;
 
-class cmdRegisterPlayer : public QObject, AbstractCommand
+class cmdRegisterPlayer : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdRegisterPlayer(QWidget* p, const Player& _pl);
-  virtual ERR exec() override;
   virtual ~cmdRegisterPlayer() {}
 
 protected:
+  virtual ERR doExec() override;
+
   Player pl;
 };
 
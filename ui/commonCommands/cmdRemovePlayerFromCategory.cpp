@@ -30,7 +30,7 @@ cmdRemovePlayerFromCategory::cmdRemovePlayerFromCategory(QWidget* p, const Playe
 
 //----------------------------------------------------------------------------
 
-ERR cmdRemovePlayerFromCategory::exec()
+ERR cmdRemovePlayerFromCategory::doExec()
 {
   ERR err;
   CatMngr cm{db};
@@ -27,16 +27,17 @@
 
 using namespace QTournament;
 
-class cmdRemovePlayerFromCategory : public QObject, AbstractCommand
+class cmdRemovePlayerFromCategory : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdRemovePlayerFromCategory(QWidget* p, const Player& _pl, const Category& _cat);
-  virtual ERR exec() override;
   virtual ~cmdRemovePlayerFromCategory() {}
 
 protected:
+  virtual ERR doExec() override;
+
   Player pl;
   Category cat;
 };
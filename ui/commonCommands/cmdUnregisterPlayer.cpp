@@ -30,7 +30,7 @@ cmdUnregisterPlayer::cmdUnregisterPlayer(QWidget* p, const Player& _pl)
 
 //----------------------------------------------------------------------------
 
-ERR cmdUnregisterPlayer::exec()
+ERR cmdUnregisterPlayer::doExec()
 {
   // set the "wait for registration"-flag
   ERR err;
@@ -26,16 +26,17 @@
 
 using namespace QTournament;
 
-class cmdUnregisterPlayer : public QObject, AbstractCommand
+class cmdUnregisterPlayer : public QObject, public AbstractCommand
 {
   Q_OBJECT
 
 public:
   cmdUnregisterPlayer(QWidget* p, const Player& _pl);
-  virtual ERR exec() override;
   virtual ~cmdUnregisterPlayer() {}
 
 protected:
+  virtual ERR doExec() override;
+
   Player pl;
 };
 
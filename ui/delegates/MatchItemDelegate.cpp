@@ -155,17 +155,17 @@ void MatchItemDelegate::paintSelectedMatchCell(QPainter* painter, const QStyleOp
 void MatchItemDelegate::paintUnselectedMatchCell(QPainter* painter, const QStyleOptionViewItem& option, int srcRowId) const
 {
   MatchMngr mm{db};
-  auto ma = mm.getMatchBySeqNum(srcRowId);
-  if (ma == nullptr) return;  // shouldn't happen
+  auto md = mm.getMatchDisplayBySeqNum(srcRowId);
+  if (md == nullptr) return;  // shouldn't happen
 
   QRect r = option.rect;
 
   // draw a status indicator ("LED light")
-  DelegateItemLED{}(painter, r, ItemMargin, ItemStatusIndicatorSize, ma->getState(), Qt::blue);
+  DelegateItemLED{}(painter, r, ItemMargin, ItemStatusIndicatorSize, md->state, Qt::blue);
 
   // draw the name
   r.adjust(2 * ItemMargin + ItemStatusIndicatorSize, 0, 0, 0);
-  QString txt = ma->getDisplayName(tr("Winner"), tr("Loser"));
+  QString txt = md->getDisplayName(tr("Winner"), tr("Loser"));
   painter->drawText(r, Qt::AlignVCenter|Qt::AlignLeft, txt);
 }
 
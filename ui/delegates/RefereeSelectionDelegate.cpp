@@ -19,7 +19,6 @@
 #include <QDateTime>
 
 #include "Match.h"
-#include "PlayerMngr.h"
 #include "ui/GuiHelpers.h"
 #include "RefereeSelectionDelegate.h"
 #include "DelegateItemLED.h"
@@ -46,12 +45,12 @@ void RefereeSelectionDelegate::paintUnselectedCell(QPainter* painter, const QSty
 
 void RefereeSelectionDelegate::commonPaint(QPainter* painter, const QStyleOptionViewItem& option, const QModelIndex& index, bool isSelected) const
 {
-  PlayerMngr pm{db};
-  int playerId = index.data(Qt::UserRole).toInt();
-  auto p = pm.getPlayer_up(playerId);
-  if (p == nullptr) return;
-
-  OBJ_STATE plStat = p->getState();
+  // the player state has been stored in the item data when
+  // the table was populated; this saves us one database
+  // lookup per cell and paint event
+  QVariant stateData = index.data(Qt::UserRole + 2);
+  if (!(stateData.isValid())) return;
+  OBJ_STATE plStat = static_cast<OBJ_STATE>(stateData.toInt());
 
   // Fill the first cell with the color that indicates the player state
   int col = index.column();